@@ -0,0 +1,429 @@
+#include <tss/animation/TransitionEngine.h>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TSS_TRANSITION_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace Trema::Style
+{
+    namespace
+    {
+        constexpr std::size_t EncodeSteps = 4096;
+
+        // sRGB transfer function, tabulated once: 8-bit channels to linear light, and linear light back to 8 bits
+        const std::array<float, 256>& DecodeTable()
+        {
+            static const auto table = []
+            {
+                std::array<float, 256> values { };
+                for (std::size_t i = 0; i < values.size(); ++i)
+                {
+                    const auto c = static_cast<double>(i) / 255;
+                    values[i] = static_cast<float>(c <= 0.04045 ? c / 12.92 : std::pow((c + 0.055) / 1.055, 2.4));
+                }
+                return values;
+            }();
+            return table;
+        }
+
+        const std::array<std::uint8_t, EncodeSteps>& EncodeTable()
+        {
+            static const auto table = []
+            {
+                std::array<std::uint8_t, EncodeSteps> values { };
+                for (std::size_t i = 0; i < values.size(); ++i)
+                {
+                    const auto l = static_cast<double>(i) / (EncodeSteps - 1);
+                    const auto c = l <= 0.0031308 ? l * 12.92 : 1.055 * std::pow(l, 1 / 2.4) - 0.055;
+                    values[i] = static_cast<std::uint8_t>(std::lround(std::clamp(c, 0.0, 1.0) * 255));
+                }
+                return values;
+            }();
+            return table;
+        }
+
+        std::uint8_t ToByte(const float value)
+        {
+            return static_cast<std::uint8_t>(std::clamp(value * 255.0f + 0.5f, 0.0f, 255.0f));
+        }
+
+        bool IsNumber(const Value& value)
+        {
+            return std::holds_alternative<Integer>(value) || std::holds_alternative<Float>(value);
+        }
+
+        double ToDouble(const Value& value)
+        {
+            return std::holds_alternative<Integer>(value) ? static_cast<double>(std::get<Integer>(value))
+                                                           : std::get<Float>(value);
+        }
+
+        template<typename T>
+        void Grow(std::vector<T>& values, const std::uint32_t slot)
+        {
+            if (values.size() <= slot)
+                values.resize(slot + 1);
+        }
+
+        // Points a slot going through keyframes at the segment its eased progress falls in
+        template<typename K, typename V>
+        void SelectSegment(const std::vector<K>& keyframes, float& progress, V& from, V& to)
+        {
+            std::size_t next = 1;
+            while (next + 1 < keyframes.size() && keyframes[next].Offset < progress)
+                ++next;
+
+            const auto& a = keyframes[next - 1];
+            const auto& b = keyframes[next];
+            from = a.Val;
+            to = b.Val;
+            progress = b.Offset > a.Offset ? (progress - a.Offset) / (b.Offset - a.Offset) : 1.0f;
+        }
+    }
+
+    std::uint32_t TransitionEngine::Lanes::Add(const Float duration, const Easing easing)
+    {
+        // Coefficients of the easing polynomial: t, t², 2t - t², 3t² - 2t³
+        static constexpr std::array<std::array<float, 3>, 4> Coefficients
+        {{
+            { 1, 0, 0 },
+            { 0, 1, 0 },
+            { 2, -1, 0 },
+            { 0, 3, -2 },
+        }};
+
+        std::uint32_t slot;
+        if (!Free.empty())
+        {
+            slot = Free.back();
+            Free.pop_back();
+        }
+        else
+        {
+            slot = static_cast<std::uint32_t>(Active.size());
+            if (slot == ColorBit)
+                throw std::length_error("Too many transitions");
+            Elapsed.push_back(0);
+            InvDuration.push_back(0);
+            for (auto& ease : Ease)
+                ease.push_back(0);
+            Progress.push_back(0);
+            Active.push_back(0);
+        }
+
+        // A transition without a duration is finished as soon as it starts
+        Elapsed[slot] = duration > 0 ? 0.0f : 1.0f;
+        InvDuration[slot] = duration > 0 ? static_cast<float>(1 / duration) : 1.0f;
+        for (std::size_t i = 0; i < Ease.size(); ++i)
+            Ease[i][slot] = Coefficients[static_cast<std::size_t>(easing)][i];
+        Active[slot] = 1;
+
+        const auto t = std::min(Elapsed[slot] * InvDuration[slot], 1.0f);
+        Progress[slot] = t * (Ease[0][slot] + t * (Ease[1][slot] + t * Ease[2][slot]));
+        return slot;
+    }
+
+    void TransitionEngine::Lanes::Remove(const std::uint32_t slot)
+    {
+        Active[slot] = 0;
+        Free.push_back(slot);
+        if (const auto it = std::ranges::find(Keyframed, slot); it != Keyframed.end())
+            Keyframed.erase(it);
+    }
+
+    void TransitionEngine::Lanes::Clear()
+    {
+        Free.clear();
+        Keyframed.clear();
+        for (std::uint32_t slot = 0; slot < Active.size(); ++slot)
+        {
+            Active[slot] = 0;
+            Free.push_back(slot);
+        }
+    }
+
+    void TransitionEngine::Lanes::Advance(const float seconds)
+    {
+        // Slots that are free are advanced too: their values are never read, and skipping them would cost a branch
+        const auto count = Elapsed.size();
+        std::size_t i = 0;
+    #if TSS_TRANSITION_SSE2
+        const auto step = _mm_set1_ps(seconds);
+        const auto one = _mm_set1_ps(1.0f);
+        for (; i + 4 <= count; i += 4)
+        {
+            const auto elapsed = _mm_add_ps(_mm_loadu_ps(&Elapsed[i]), step);
+            _mm_storeu_ps(&Elapsed[i], elapsed);
+
+            const auto t = _mm_min_ps(_mm_mul_ps(elapsed, _mm_loadu_ps(&InvDuration[i])), one);
+            auto eased = _mm_mul_ps(_mm_loadu_ps(&Ease[2][i]), t);
+            eased = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(&Ease[1][i]), eased), t);
+            eased = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(&Ease[0][i]), eased), t);
+            _mm_storeu_ps(&Progress[i], eased);
+        }
+    #endif
+        for (; i < count; ++i)
+        {
+            Elapsed[i] += seconds;
+            const auto t = std::min(Elapsed[i] * InvDuration[i], 1.0f);
+            Progress[i] = t * (Ease[0][i] + t * (Ease[1][i] + t * Ease[2][i]));
+        }
+    }
+
+    bool TransitionEngine::Lanes::IsFinished(const std::uint32_t slot) const
+    {
+        return Elapsed[slot] * InvDuration[slot] >= 1.0f;
+    }
+
+    TransitionEngine::TransitionEngine(const ColorSpace space) :
+        m_space(space)
+    {
+    }
+
+    TransitionEngine::Handle TransitionEngine::Start(const Value& from, const Value& to, const Float duration,
+                                                     const Easing easing)
+    {
+        const std::array<Keyframe, 2> keyframes { Keyframe { 0, from }, Keyframe { 1, to } };
+        return Start(keyframes, duration, easing);
+    }
+
+    TransitionEngine::Handle TransitionEngine::Start(const std::span<const Keyframe> keyframes, const Float duration,
+                                                     const Easing easing)
+    {
+        if (keyframes.size() < 2 || keyframes.front().Offset != 0 || keyframes.back().Offset != 1)
+            throw std::invalid_argument("Keyframes must go from offset 0 to 1");
+
+        for (std::size_t i = 1; i < keyframes.size(); ++i)
+        {
+            if (keyframes[i].Offset < keyframes[i - 1].Offset)
+                throw std::invalid_argument("Keyframe offsets must increase");
+        }
+
+        if (std::ranges::all_of(keyframes, [](const Keyframe& k) { return IsNumber(k.Val); }))
+        {
+            const auto slot = m_numbers.Add(duration, easing);
+            Grow(m_numbers.From, slot);
+            Grow(m_numbers.To, slot);
+            Grow(m_numbers.Out, slot);
+            Grow(m_numbers.Integral, slot);
+            Grow(m_numbers.Keyframes, slot);
+
+            m_numbers.From[slot] = ToDouble(keyframes.front().Val);
+            m_numbers.To[slot] = ToDouble(keyframes.back().Val);
+            m_numbers.Integral[slot] = std::ranges::all_of(keyframes, [](const Keyframe& k)
+            {
+                return std::holds_alternative<Integer>(k.Val);
+            });
+
+            auto& stored = m_numbers.Keyframes[slot];
+            stored.clear();
+            if (keyframes.size() > 2)
+            {
+                for (const auto& [offset, value] : keyframes)
+                    stored.push_back({ static_cast<float>(offset), ToDouble(value) });
+                m_numbers.Keyframed.push_back(slot);
+                SelectSegment(stored, m_numbers.Progress[slot], m_numbers.From[slot], m_numbers.To[slot]);
+            }
+
+            UpdateNumbers(slot, slot + 1);
+            return slot;
+        }
+
+        if (std::ranges::all_of(keyframes, [](const Keyframe& k) { return std::holds_alternative<Color>(k.Val); }))
+        {
+            const auto slot = m_colors.Add(duration, easing);
+            Grow(m_colors.From, slot);
+            Grow(m_colors.To, slot);
+            Grow(m_colors.Out, slot);
+            Grow(m_colors.Keyframes, slot);
+
+            m_colors.From[slot] = ToWorkingSpace(std::get<Color>(keyframes.front().Val));
+            m_colors.To[slot] = ToWorkingSpace(std::get<Color>(keyframes.back().Val));
+
+            auto& stored = m_colors.Keyframes[slot];
+            stored.clear();
+            if (keyframes.size() > 2)
+            {
+                for (const auto& [offset, value] : keyframes)
+                    stored.push_back({ static_cast<float>(offset), ToWorkingSpace(std::get<Color>(value)) });
+                m_colors.Keyframed.push_back(slot);
+                SelectSegment(stored, m_colors.Progress[slot], m_colors.From[slot], m_colors.To[slot]);
+            }
+
+            UpdateColors(slot, slot + 1);
+            return slot | ColorBit;
+        }
+
+        throw std::invalid_argument("Transitions go between numbers or between colours");
+    }
+
+    std::vector<std::pair<StringRef, TransitionEngine::Handle>> TransitionEngine::Start(
+        const ComputedStyle& from, const ComputedStyle& to, const Float duration, const Easing easing)
+    {
+        std::vector<std::pair<StringRef, Handle>> transitions;
+        for (const auto& [name, target] : to)
+        {
+            const auto source = from.Find(name.View());
+            if (!source)
+                continue;
+
+            const auto numbers = IsNumber(*source) && IsNumber(target) && ToDouble(*source) != ToDouble(target);
+            const auto colors = std::holds_alternative<Color>(*source) && std::holds_alternative<Color>(target) &&
+                std::get<Color>(*source) != std::get<Color>(target);
+            if (numbers || colors)
+                transitions.emplace_back(name, Start(*source, target, duration, easing));
+        }
+        return transitions;
+    }
+
+    void TransitionEngine::Advance(const Float seconds)
+    {
+        const auto step = static_cast<float>(seconds);
+
+        m_numbers.Advance(step);
+        for (const auto slot : m_numbers.Keyframed)
+            SelectSegment(m_numbers.Keyframes[slot], m_numbers.Progress[slot], m_numbers.From[slot], m_numbers.To[slot]);
+        UpdateNumbers(0, static_cast<std::uint32_t>(m_numbers.Out.size()));
+
+        m_colors.Advance(step);
+        for (const auto slot : m_colors.Keyframed)
+            SelectSegment(m_colors.Keyframes[slot], m_colors.Progress[slot], m_colors.From[slot], m_colors.To[slot]);
+        UpdateColors(0, static_cast<std::uint32_t>(m_colors.Out.size()));
+    }
+
+    Value TransitionEngine::Sample(const Handle transition) const
+    {
+        CheckHandle(transition);
+        if (transition & ColorBit)
+            return m_colors.Out[transition & ~ColorBit];
+
+        const auto value = m_numbers.Out[transition];
+        if (m_numbers.Integral[transition])
+            return static_cast<Integer>(std::llround(value));
+        return value;
+    }
+
+    bool TransitionEngine::IsFinished(const Handle transition) const
+    {
+        CheckHandle(transition);
+        return transition & ColorBit ? m_colors.IsFinished(transition & ~ColorBit) : m_numbers.IsFinished(transition);
+    }
+
+    void TransitionEngine::Stop(const Handle transition)
+    {
+        CheckHandle(transition);
+        if (transition & ColorBit)
+            m_colors.Remove(transition & ~ColorBit);
+        else
+            m_numbers.Remove(transition);
+    }
+
+    void TransitionEngine::Clear()
+    {
+        m_numbers.Clear();
+        m_colors.Clear();
+    }
+
+    TransitionEngine::Channels TransitionEngine::ToWorkingSpace(const Color color) const
+    {
+        const auto alpha = static_cast<float>(color.A()) / 255;
+        if (m_space == ColorSpace::Linear)
+        {
+            const auto& decode = DecodeTable();
+            return { { decode[color.R()] * alpha, decode[color.G()] * alpha, decode[color.B()] * alpha, alpha } };
+        }
+
+        return { {
+            static_cast<float>(color.R()) / 255 * alpha,
+            static_cast<float>(color.G()) / 255 * alpha,
+            static_cast<float>(color.B()) / 255 * alpha,
+            alpha
+        } };
+    }
+
+    void TransitionEngine::UpdateNumbers(const std::uint32_t first, const std::uint32_t last)
+    {
+        // from * (1 - p) + to * p rather than from + (to - from) * p, which can miss to when p is 1
+        auto i = first;
+    #if TSS_TRANSITION_SSE2
+        const auto one = _mm_set1_pd(1.0);
+        for (; i + 2 <= last; i += 2)
+        {
+            const auto pair = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&m_numbers.Progress[i]));
+            const auto progress = _mm_cvtps_pd(_mm_castsi128_ps(pair));
+            const auto from = _mm_mul_pd(_mm_loadu_pd(&m_numbers.From[i]), _mm_sub_pd(one, progress));
+            _mm_storeu_pd(&m_numbers.Out[i], _mm_add_pd(from, _mm_mul_pd(_mm_loadu_pd(&m_numbers.To[i]), progress)));
+        }
+    #endif
+        for (; i < last; ++i)
+        {
+            const double progress = m_numbers.Progress[i];
+            m_numbers.Out[i] = m_numbers.From[i] * (1 - progress) + m_numbers.To[i] * progress;
+        }
+    }
+
+    void TransitionEngine::UpdateColors(const std::uint32_t first, const std::uint32_t last)
+    {
+        const auto& encode = EncodeTable();
+        for (auto i = first; i < last; ++i)
+        {
+            // Blend the premultiplied channels, then divide the colour by its alpha again
+            Channels straight;
+        #if TSS_TRANSITION_SSE2
+            const auto from = _mm_load_ps(m_colors.From[i].V.data());
+            const auto to = _mm_load_ps(m_colors.To[i].V.data());
+            const auto blended = _mm_add_ps(from, _mm_mul_ps(_mm_sub_ps(to, from), _mm_set1_ps(m_colors.Progress[i])));
+            const auto alpha = _mm_shuffle_ps(blended, blended, _MM_SHUFFLE(3, 3, 3, 3));
+            const auto divided = _mm_div_ps(blended, _mm_max_ps(alpha, _mm_set1_ps(1e-6f)));
+            const auto alphaLane = _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0));
+            const auto result = _mm_or_ps(_mm_and_ps(alphaLane, blended), _mm_andnot_ps(alphaLane, divided));
+
+            if (m_space == ColorSpace::Premultiplied)
+            {
+                // Scale to bytes and pack the four channels with saturation
+                const auto scaled = _mm_add_ps(_mm_mul_ps(result, _mm_set1_ps(255.0f)), _mm_set1_ps(0.5f));
+                const auto integers = _mm_cvttps_epi32(_mm_max_ps(scaled, _mm_setzero_ps()));
+                const auto words = _mm_packs_epi32(integers, integers);
+                const auto bytes = static_cast<std::uint32_t>(_mm_cvtsi128_si32(_mm_packus_epi16(words, words)));
+                m_colors.Out[i] = Color::FromChannels(static_cast<std::uint8_t>(bytes), static_cast<std::uint8_t>(bytes >> 8),
+                                                      static_cast<std::uint8_t>(bytes >> 16), static_cast<std::uint8_t>(bytes >> 24));
+                continue;
+            }
+            _mm_store_ps(straight.V.data(), result);
+        #else
+            const auto& from = m_colors.From[i].V;
+            const auto& to = m_colors.To[i].V;
+            for (std::size_t c = 0; c < 4; ++c)
+                straight.V[c] = from[c] + (to[c] - from[c]) * m_colors.Progress[i];
+            const auto alpha = std::max(straight.V[3], 1e-6f);
+            for (std::size_t c = 0; c < 3; ++c)
+                straight.V[c] /= alpha;
+
+            if (m_space == ColorSpace::Premultiplied)
+            {
+                m_colors.Out[i] = Color::FromChannels(ToByte(straight.V[0]), ToByte(straight.V[1]), ToByte(straight.V[2]),
+                                                      ToByte(straight.V[3]));
+                continue;
+            }
+        #endif
+            const auto channel = [&encode](const float value)
+            {
+                return encode[static_cast<std::size_t>(std::clamp(value, 0.0f, 1.0f) * (EncodeSteps - 1) + 0.5f)];
+            };
+            m_colors.Out[i] = Color::FromChannels(channel(straight.V[0]), channel(straight.V[1]), channel(straight.V[2]),
+                                                  ToByte(straight.V[3]));
+        }
+    }
+
+    void TransitionEngine::CheckHandle(const Handle transition) const
+    {
+        const auto& lanes = transition & ColorBit ? static_cast<const Lanes&>(m_colors) : m_numbers;
+        const auto slot = transition & ~ColorBit;
+        if (slot >= lanes.Active.size() || !lanes.Active[slot])
+            throw std::out_of_range("Unknown transition");
+    }
+}
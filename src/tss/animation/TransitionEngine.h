@@ -0,0 +1,130 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <tss/sheets/StyleResolver.h>
+#include <tss/tokenization/TokenValue.h>
+
+namespace Trema::Style
+{
+    // Space colours are blended in. Both premultiply by alpha, so a fade from a transparent colour doesn't pass
+    // through its hidden RGB; Linear also decodes sRGB first, which keeps crossfades from darkening in between.
+    enum class ColorSpace
+    {
+        Premultiplied,
+        Linear,
+    };
+
+    enum class Easing
+    {
+        Linear,
+        EaseIn,
+        EaseOut,
+        EaseInOut,
+    };
+
+    struct Keyframe
+    {
+        Float Offset; // 0 to 1, increasing
+        Value Val;
+    };
+
+    // Interpolates numbers and colours over time. Transitions of each kind live in flat arrays advanced together,
+    // four timings, two numbers or one colour per SSE2 operation, so a frame with thousands of running transitions
+    // costs a few passes over contiguous memory. Numbers are blended in double precision and land exactly on their
+    // last value.
+    class TransitionEngine final
+    {
+    public:
+        using Handle = std::uint32_t;
+        static constexpr Handle NoTransition = UINT32_MAX;
+
+        explicit TransitionEngine(ColorSpace space = ColorSpace::Premultiplied);
+
+        // Both values are numbers or both are colours; throws std::invalid_argument otherwise. A transition
+        // between integers samples as rounded integers, exact up to 2^53.
+        Handle Start(const Value& from, const Value& to, Float duration, Easing easing = Easing::Linear);
+        // At least two keyframes, from offset 0 to 1, all numbers or all colours
+        Handle Start(std::span<const Keyframe> keyframes, Float duration, Easing easing = Easing::Linear);
+        // One transition per number or colour that differs between the styles, with the property it animates
+        std::vector<std::pair<StringRef, Handle>> Start(const ComputedStyle& from, const ComputedStyle& to, Float duration,
+                                                        Easing easing = Easing::Linear);
+
+        // Moves every transition forward; finished ones hold their last value until stopped
+        void Advance(Float seconds);
+
+        [[nodiscard]] Value Sample(Handle transition) const;
+        [[nodiscard]] bool IsFinished(Handle transition) const;
+        // Frees the handle, which a later Start may reuse
+        void Stop(Handle transition);
+        void Clear();
+
+        [[nodiscard]] std::size_t ActiveCount() const { return m_numbers.ActiveCount() + m_colors.ActiveCount(); }
+        [[nodiscard]] ColorSpace GetColorSpace() const { return m_space; }
+
+    private:
+        // Colours handles have their top bit set
+        static constexpr Handle ColorBit = 0x80000000u;
+
+        struct alignas(16) Channels
+        {
+            std::array<float, 4> V; // premultiplied R, G, B, A in the working space
+        };
+
+        // Timing shared by both kinds of transition, indexed by slot
+        struct Lanes
+        {
+            std::vector<float> Elapsed;
+            std::vector<float> InvDuration;
+            std::array<std::vector<float>, 3> Ease; // eased = t * (A + t * (B + t * C))
+            std::vector<float> Progress;            // eased, then local to the current keyframe segment
+            std::vector<std::uint8_t> Active;
+            std::vector<std::uint32_t> Free;
+            std::vector<std::uint32_t> Keyframed; // slots animating through more than two keyframes
+
+            std::uint32_t Add(Float duration, Easing easing);
+            void Remove(std::uint32_t slot);
+            void Clear();
+            void Advance(float seconds);
+            [[nodiscard]] bool IsFinished(std::uint32_t slot) const;
+            [[nodiscard]] std::size_t ActiveCount() const { return Active.size() - Free.size(); }
+        };
+
+        template<typename T>
+        struct StoredKeyframe
+        {
+            float Offset;
+            T Val;
+        };
+
+        struct Numbers : Lanes
+        {
+            std::vector<double> From;
+            std::vector<double> To;
+            std::vector<double> Out;
+            std::vector<std::uint8_t> Integral;
+            std::vector<std::vector<StoredKeyframe<double>>> Keyframes;
+        };
+
+        struct Colors : Lanes
+        {
+            std::vector<Channels> From;
+            std::vector<Channels> To;
+            std::vector<Color> Out;
+            std::vector<std::vector<StoredKeyframe<Channels>>> Keyframes;
+        };
+
+        ColorSpace m_space;
+        Numbers m_numbers;
+        Colors m_colors;
+
+        [[nodiscard]] Channels ToWorkingSpace(Color color) const;
+        void UpdateNumbers(std::uint32_t first, std::uint32_t last);
+        void UpdateColors(std::uint32_t first, std::uint32_t last);
+        void CheckHandle(Handle transition) const;
+    };
+}
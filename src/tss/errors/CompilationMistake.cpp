@@ -6,6 +6,9 @@ namespace Trema
     {
         std::ostream &operator<<(std::ostream &os, const CompilationMistake &m)
         {
+            if (!m.File.empty())
+                os << m.File << ": ";
+
             switch(m.Code)
             {
             case ErrorCode::UnknownError:
@@ -25,6 +28,12 @@ namespace Trema
             case ErrorCode::UnexpectedToken:
                 os << "Unexpected token (" << (unsigned short)m.Code  << " | " << m.Line << ":" << m.Position << "): " << m.Extra;
                 break;
+            case ErrorCode::ImportCycle:
+                os << "Import cycle (" << static_cast<unsigned short>(m.Code) << " | " << m.Line << ":" << m.Position << "): " << m.Extra;
+                break;
+            case ErrorCode::UnresolvedImport:
+                os << "Unresolved import (" << static_cast<unsigned short>(m.Code) << " | " << m.Line << ":" << m.Position << "): " << m.Extra;
+                break;
 
             case ErrorCode::ElementNotFound:
                 os << "Element not found (" << static_cast<unsigned short>(m.Code)  << " | " << m.Line << ":" << m.Position << "): " << m.Extra;
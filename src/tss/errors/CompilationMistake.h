@@ -15,6 +15,7 @@ namespace Trema
             bool Fatal { false };
             ErrorCode Code {ErrorCode::UnknownError };
             std::string Extra;
+            std::string File; // path of the sheet, when parsed from a file
 
             friend std::ostream& operator<<(std::ostream& os, const CompilationMistake& st);
         };
@@ -19,6 +19,8 @@ namespace Trema
             UndefinedSymbol = 2001,
             UnexpectedToken = 2002,
             TypeMismatch = 2003,
+            ImportCycle = 2004,
+            UnresolvedImport = 2005,
         #pragma endregion
 
         #pragma region Style
@@ -0,0 +1,161 @@
+#include <tss/parsing/HeaderGenerator.h>
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <format>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace Trema::Style
+{
+    namespace
+    {
+        bool IsAlphanumeric(const char c)
+        {
+            return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9');
+        }
+
+        std::string FloatLiteral(const Float value)
+        {
+            if (std::isnan(value))
+                return "std::numeric_limits<Trema::Style::Float>::quiet_NaN()";
+            if (std::isinf(value))
+                return value > 0 ? "std::numeric_limits<Trema::Style::Float>::infinity()"
+                                 : "-std::numeric_limits<Trema::Style::Float>::infinity()";
+
+            // Shortest representation that reads back as the same value
+            char buffer[32];
+            const auto end = std::to_chars(buffer, buffer + sizeof(buffer), value).ptr;
+            std::string literal(buffer, end);
+            if (literal.find_first_of(".e") == std::string::npos)
+                literal += ".0";
+            return literal;
+        }
+
+        std::string StringLiteral(const std::string_view value)
+        {
+            std::string literal = "\"";
+            for (const char c : value)
+            {
+                if (c == '"' || c == '\\')
+                    literal += std::format("\\{}", c);
+                else if (static_cast<unsigned char>(c) < 0x20 || c == 0x7F)
+                    literal += std::format("\\{:03o}", static_cast<unsigned char>(c)); // octal escapes stop after 3 digits
+                else
+                    literal += c;
+            }
+            return literal + "\"";
+        }
+
+        std::pair<std::string_view, std::string> Field(const Value& value)
+        {
+            if (const auto f = std::get_if<Float>(&value))
+                return { "Trema::Style::Float", FloatLiteral(*f) };
+            if (const auto i = std::get_if<Integer>(&value))
+            {
+                if (*i == std::numeric_limits<Integer>::min())
+                    return { "Trema::Style::Integer", "std::numeric_limits<Trema::Style::Integer>::min()" };
+                return { "Trema::Style::Integer", std::to_string(*i) };
+            }
+            if (const auto b = std::get_if<bool>(&value))
+                return { "bool", *b ? "true" : "false" };
+            if (const auto s = std::get_if<StringRef>(&value))
+                return { "std::string_view", StringLiteral(s->View()) };
+            if (const auto c = std::get_if<Color>(&value))
+                return { "Trema::Style::Color", std::format("0x{:08X}", c->Rgba) };
+
+            throw std::runtime_error("Unsupported variable type");
+        }
+    }
+
+    HeaderGenerator::HeaderGenerator(std::string nameSpace) :
+        m_namespace(std::move(nameSpace))
+    {
+    }
+
+    std::string HeaderGenerator::ToTypeName(const std::string_view name)
+    {
+        if (name == "#")
+            return "Root";
+
+        std::string result;
+        bool wordStart = true;
+        for (const char c : name)
+        {
+            if (!IsAlphanumeric(c))
+            {
+                wordStart = true;
+                continue;
+            }
+
+            result += wordStart && c >= 'a' && c <= 'z' ? static_cast<char>(c - 'a' + 'A') : c;
+            wordStart = false;
+        }
+
+        if (!result.empty() && result.front() >= '0' && result.front() <= '9')
+            result.insert(result.begin(), '_');
+        return result;
+    }
+
+    std::string HeaderGenerator::Generate(const SelectorMap& selectors, const std::string_view origin) const
+    {
+        std::map<std::string, std::string> types; // C++ name -> selector
+        for (const auto& [selector, table] : selectors)
+        {
+            auto type = ToTypeName(selector);
+            if (type.empty())
+                throw std::runtime_error(std::format("Selector \"{}\" has no usable C++ name", selector));
+            if (const auto [it, inserted] = types.emplace(std::move(type), selector); !inserted)
+                throw std::runtime_error(std::format(R"(Selectors "{}" and "{}" both map to {})", it->second, selector, it->first));
+        }
+
+        std::ostringstream ss;
+        ss << "// Generated by tss-codegen from " << origin << ". Do not edit.\n"
+              "#pragma once\n"
+              "#include <limits>\n"
+              "#include <string_view>\n"
+              "#include <tss/tokenization/TokenValue.h>\n"
+              "\n"
+              "namespace " << m_namespace << "\n"
+              "{\n";
+
+        bool first = true;
+        for (const auto& [type, selector] : types)
+        {
+            std::map<std::string, std::pair<std::string_view, const Variable*>> fields { { "Selector", { } } };
+            for (const auto& [name, variable] : *selectors.at(selector))
+            {
+                auto field = ToTypeName(name.View());
+                if (field.empty())
+                    throw std::runtime_error(std::format("Property \"{}\" of \"{}\" has no usable C++ name", name.View(), selector));
+                if (const auto [it, inserted] = fields.emplace(std::move(field), std::pair { name.View(), &variable }); !inserted)
+                    throw std::runtime_error(std::format(R"(Properties "{}" and "{}" of "{}" both map to {})",
+                                                         it->second.second ? it->second.first : "Selector", name.View(),
+                                                         selector, it->first));
+            }
+
+            if (!first)
+                ss << "\n";
+            first = false;
+
+            ss << "    struct " << type << "\n"
+                  "    {\n"
+                  "        static constexpr std::string_view Selector = " << StringLiteral(selector) << ";\n";
+            for (const auto& [field, property] : fields)
+            {
+                if (!property.second)
+                    continue;
+
+                const auto [fieldType, literal] = Field(property.second->GetValue());
+                ss << "        " << fieldType << " " << field << " { " << literal << " };\n";
+            }
+            ss << "    };\n";
+        }
+
+        ss << "}\n";
+        return ss.str();
+    }
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <tss/variables/SymbolTable.h>
+
+namespace Trema::Style
+{
+    // Emits a C++ header with one struct per selector, whose fields are initialized from the parsed values:
+    // "#main-window { title-size: 12; }" becomes "struct MainWindow { Integer TitleSize { 12 }; };". Reading a
+    // style compiled into the binary is then a member load instead of a lookup.
+    // Selectors and fields are sorted, so the same sheets always generate the same header.
+    class HeaderGenerator final
+    {
+    public:
+        using SelectorMap = Style::SelectorMap;
+
+        explicit HeaderGenerator(std::string nameSpace = "Styles");
+
+        // origin is named in the header comment; throws if two selectors or fields map to the same C++ name
+        [[nodiscard]] std::string Generate(const SelectorMap& selectors, std::string_view origin) const;
+
+        // "#main-window" -> "MainWindow", "#" -> "Root"; empty when nothing usable is left
+        [[nodiscard]] static std::string ToTypeName(std::string_view name);
+
+    private:
+        std::string m_namespace;
+    };
+}
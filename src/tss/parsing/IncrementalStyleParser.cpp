@@ -0,0 +1,315 @@
+#include <tss/parsing/IncrementalStyleParser.h>
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <tss/parsing/StackedStyleParser.h>
+#include <tss/tokenization/EndToEndTokenizer.h>
+
+namespace Trema::Style
+{
+    IncrementalStyleParser::IncrementalStyleParser() :
+        m_emptyScope(std::make_shared<SymbolTable>())
+    {
+    }
+
+    void IncrementalStyleParser::ParseFromCode(const std::string& code)
+    {
+        ApplyEdit(0, m_code.size(), code);
+    }
+
+    void IncrementalStyleParser::ParseFromFile(const std::filesystem::path& path)
+    {
+        std::ifstream file(path, std::ios::in | std::ios::binary);
+        if (!file)
+            throw std::runtime_error(std::format("File not found: \"{}\"", path.string()));
+        const std::string code{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+
+        file.close();
+        ParseFromCode(code);
+    }
+
+    void IncrementalStyleParser::ApplyEdit(const std::size_t offset, const std::size_t length,
+                                           const std::string_view replacement)
+    {
+        if (offset > m_code.size() || length > m_code.size() - offset)
+            throw std::out_of_range(std::format("Edit of {} characters at {} is outside of the code", length, offset));
+
+        const std::string removed = m_code.substr(offset, length);
+        m_code.replace(offset, length, replacement);
+        try
+        {
+            Update(offset, length, replacement.size());
+        }
+        catch (...)
+        {
+            m_code.replace(offset, replacement.size(), removed);
+            throw;
+        }
+    }
+
+    void IncrementalStyleParser::Update(const std::size_t offset, const std::size_t length, const std::size_t inserted)
+    {
+        const auto shift = [&](const std::size_t position) { return position - length + inserted; };
+
+        // A unit that is closed before the edit starts can't change
+        auto first = static_cast<std::size_t>(std::ranges::upper_bound(m_units, offset, {}, &Unit::End) - m_units.begin());
+        if (first == m_units.size() && first > 0 && !m_units.back().Terminated)
+            --first;
+
+        // Rescan from there until a unit ends on a boundary of the unchanged code after the edit
+        std::vector<Unit> added;
+        std::size_t kept = m_units.size();
+        std::size_t candidate = first;
+        std::size_t position = first > 0 ? m_units[first - 1].End : 0;
+        while (position < m_code.size())
+        {
+            added.push_back(ScanUnit(m_code, position));
+            position = added.back().End;
+            if (position < offset + inserted)
+                continue;
+
+            const auto oldPosition = position - inserted + length;
+            while (candidate < m_units.size() && m_units[candidate].Begin < oldPosition)
+                ++candidate;
+            if (candidate < m_units.size() && m_units[candidate].Begin == oldPosition)
+            {
+                kept = candidate;
+                break;
+            }
+        }
+
+        std::unordered_set<StringRef> changed; // root variables that may have a new value
+        std::unordered_set<std::string> selectors;
+        const auto collect = [&](const Unit& unit)
+        {
+            for (const auto& [name, variable] : *unit.Defines)
+                changed.insert(name);
+            for (const auto& [name, table] : unit.Selectors)
+                selectors.insert(name);
+        };
+
+        for (auto i = first; i < kept; ++i)
+            collect(m_units[i]);
+
+        auto scope = ScopeBefore(first);
+        for (auto& unit : added)
+        {
+            ParseUnit(unit, scope);
+            collect(unit);
+            scope = unit.Scope;
+        }
+
+        // Units after the edit are only reparsed when they read a root variable that changed
+        std::vector<std::pair<std::size_t, Unit>> reparsed;
+        std::vector<std::shared_ptr<SymbolTable>> scopes;
+        for (auto i = kept; i < m_units.size() && !changed.empty(); ++i)
+        {
+            const auto& old = m_units[i];
+            if (std::ranges::any_of(changed, [&](const StringRef name) { return old.Identifiers.contains(name); }))
+            {
+                Unit unit { .Begin = shift(old.Begin), .End = shift(old.End), .Terminated = old.Terminated };
+                ParseUnit(unit, scope);
+                collect(old);
+                collect(unit);
+                scope = unit.Scope;
+                reparsed.emplace_back(i, std::move(unit));
+            }
+            else
+            {
+                scope = MakeScope(scope, old.Defines);
+            }
+            scopes.push_back(scope);
+        }
+
+        // Nothing below throws but allocations: commit
+        for (auto i = kept; i < m_units.size(); ++i)
+        {
+            auto& unit = m_units[i];
+            unit.Begin = shift(unit.Begin);
+            unit.End = shift(unit.End);
+            if (i - kept < scopes.size())
+                unit.Scope = scopes[i - kept];
+        }
+        for (auto& [index, unit] : reparsed)
+            m_units[index] = std::move(unit);
+
+        const auto erased = m_units.erase(m_units.begin() + static_cast<std::ptrdiff_t>(first),
+                                          m_units.begin() + static_cast<std::ptrdiff_t>(kept));
+        m_units.insert(erased, std::make_move_iterator(added.begin()), std::make_move_iterator(added.end()));
+        m_reparsed = added.size() + reparsed.size();
+
+        for (const auto& name : selectors)
+            RebuildSelector(name);
+        RebuildRoot();
+        RenumberBlocks();
+    }
+
+    void IncrementalStyleParser::ParseUnit(Unit& unit, const std::shared_ptr<SymbolTable>& scope) const
+    {
+        const std::string code = m_code.substr(unit.Begin, unit.End - unit.Begin);
+
+        MistakesContainer mistakes;
+        {
+            StackedStyleParser parser(std::make_unique<EndToEndTokenizer>("", mistakes), mistakes);
+            parser.SetSchema(m_schema);
+            parser.ParseFromCode(code, scope);
+
+            unit.Defines = m_emptyScope;
+            unit.Selectors.clear();
+            unit.Orders.clear();
+            unit.Blocks = 0;
+            for (const auto& [name, table] : parser.GetVariables())
+            {
+                unit.Blocks = std::max(unit.Blocks, table->GetOrder() + 1);
+                if (name == "#")
+                {
+                    unit.Defines = table;
+                    continue;
+                }
+                unit.Selectors.emplace(name, table);
+                unit.Orders.emplace(name, table->GetOrder());
+            }
+        }
+        unit.Scope = MakeScope(scope, unit.Defines);
+        unit.Mistakes = std::move(mistakes);
+
+        MistakesContainer ignored;
+        EndToEndTokenizer tokenizer(code, ignored);
+        unit.Identifiers.clear();
+        while (!tokenizer.Empty())
+        {
+            const auto token = tokenizer.GetNextToken();
+            if (token.GetTokenType() == TokenType::Identifier)
+                unit.Identifiers.insert(std::get<StringRef>(token.GetValue()));
+        }
+    }
+
+    void IncrementalStyleParser::RebuildSelector(const std::string& name)
+    {
+        // Blocks of the same selector are appended in order, as the stacked parser does. A selector defined by a
+        // single unit keeps its table, which stays shared with the other selectors of its list.
+        std::shared_ptr<SymbolTable> table;
+        for (const auto& unit : m_units)
+        {
+            if (const auto it = unit.Selectors.find(name); it != unit.Selectors.end())
+            {
+                if (table)
+                    AppendBlock(table, *it->second);
+                else
+                    table = it->second;
+            }
+        }
+
+        if (table)
+            m_variables[name] = std::move(table);
+        else
+            m_variables.erase(name);
+    }
+
+    void IncrementalStyleParser::RebuildRoot()
+    {
+        m_variables["#"] = std::make_shared<SymbolTable>(*ScopeBefore(m_units.size()));
+    }
+
+    void IncrementalStyleParser::RenumberBlocks()
+    {
+        // Units number their blocks from 0 and units before a selector may have come or gone: number them again
+        // across the document, as a parser of the whole code would
+        std::unordered_set<std::string_view> numbered;
+        std::uint32_t blocks = 0;
+        for (const auto& unit : m_units)
+        {
+            for (const auto& [name, order] : unit.Orders)
+            {
+                if (numbered.insert(name).second)
+                    m_variables.at(name)->SetOrder(blocks + order);
+            }
+            blocks += unit.Blocks;
+        }
+    }
+
+    MistakesContainer IncrementalStyleParser::GetMistakes() const
+    {
+        MistakesContainer mistakes;
+        unsigned int line = 1;
+        std::size_t lineStart = 0;
+        std::size_t counted = 0;
+        for (const auto& unit : m_units)
+        {
+            if (unit.Mistakes.empty())
+                continue;
+
+            for (; counted < unit.Begin; ++counted)
+            {
+                if (m_code[counted] == '\n')
+                {
+                    ++line;
+                    lineStart = counted + 1;
+                }
+            }
+
+            for (auto mistake : unit.Mistakes)
+            {
+                if (mistake.Line <= 1)
+                    mistake.Position += static_cast<unsigned int>(unit.Begin - lineStart);
+                mistake.Line += line - 1;
+                mistakes << std::move(mistake);
+            }
+        }
+
+        return mistakes;
+    }
+
+    const std::shared_ptr<SymbolTable>& IncrementalStyleParser::ScopeBefore(const std::size_t unit) const
+    {
+        return unit == 0 ? m_emptyScope : m_units[unit - 1].Scope;
+    }
+
+    IncrementalStyleParser::Unit IncrementalStyleParser::ScanUnit(const std::string_view code, const std::size_t begin)
+    {
+        // Mirrors the tokenizer's handling of strings and comments so that braces and semicolons inside them
+        // are not taken for unit boundaries
+        int depth = 0;
+        std::size_t position = begin;
+        while (position < code.size())
+        {
+            const char c = code[position];
+            if (c == '/' && position + 1 < code.size() && code[position + 1] == '*')
+            {
+                const auto end = code.find("*/", position + 2);
+                position = end == std::string_view::npos ? code.size() : end + 2;
+                continue;
+            }
+
+            if (c == '\'' || c == '"')
+            {
+                auto end = position + 1;
+                while (end < code.size() && code[end] != c && code[end] != '\n')
+                    ++end;
+                position = end < code.size() && code[end] == c ? end + 1 : end;
+                continue;
+            }
+
+            ++position;
+            if ((c == ';' && depth == 0) || (c == '}' && --depth <= 0))
+                return { .Begin = begin, .End = position, .Terminated = true };
+            if (c == '{')
+                ++depth;
+        }
+
+        return { .Begin = begin, .End = code.size(), .Terminated = false };
+    }
+
+    std::shared_ptr<SymbolTable> IncrementalStyleParser::MakeScope(const std::shared_ptr<SymbolTable>& previous,
+                                                                  const std::shared_ptr<SymbolTable>& defines)
+    {
+        if (defines->begin() == defines->end())
+            return previous;
+
+        auto scope = std::make_shared<SymbolTable>(*previous);
+        scope->Append(*defines);
+        return scope;
+    }
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <tss/errors/MistakesContainer.h>
+#include <tss/parsing/StyleParser.h>
+
+namespace Trema::Style
+{
+    // Parser for a document that is edited in place, e.g. by an editor preview.
+    // The code is split into units (top-level statements and blocks) that are parsed on their own and keep their
+    // results. An edit reparses the units it overlaps, then the units that use root variables those redefined,
+    // and recomposes only the selectors they contribute to.
+    // Units are parsed in isolation, so leftovers of a malformed statement don't leak into the next one.
+    class IncrementalStyleParser final : public StyleParser
+    {
+    public:
+        IncrementalStyleParser();
+        IncrementalStyleParser(const IncrementalStyleParser&) = delete;
+        IncrementalStyleParser& operator=(const IncrementalStyleParser&) = delete;
+        ~IncrementalStyleParser() override = default;
+
+        // Both replace the whole document
+        void ParseFromCode(const std::string& code) override;
+        void ParseFromFile(const std::filesystem::path& path) override;
+
+        // Replaces code[offset, offset + length) with replacement. If the new code can't be parsed, the document
+        // is left as it was and the exception is rethrown.
+        void ApplyEdit(std::size_t offset, std::size_t length, std::string_view replacement);
+
+        [[nodiscard]] const std::string& GetCode() const { return m_code; }
+        [[nodiscard]] std::size_t UnitCount() const { return m_units.size(); }
+        // Number of units parsed by the last update
+        [[nodiscard]] std::size_t GetReparsedUnitCount() const { return m_reparsed; }
+        // Mistakes of every unit, with lines and positions in the whole document
+        [[nodiscard]] MistakesContainer GetMistakes() const;
+
+    private:
+        using SelectorMap = Style::SelectorMap;
+
+        struct Unit
+        {
+            std::size_t Begin { 0 };
+            std::size_t End { 0 };
+            bool Terminated { false };                  // ends with its own ';' or '}' rather than the end of the code
+            std::shared_ptr<SymbolTable> Defines;       // root variables defined by this unit
+            std::shared_ptr<SymbolTable> Scope;         // root variables visible after this unit
+            SelectorMap Selectors;
+            std::unordered_map<std::string, std::uint32_t> Orders; // of the selectors' blocks, counted in the unit
+            std::uint32_t Blocks { 0 };
+            std::unordered_set<StringRef> Identifiers;  // every identifier in the unit, a superset of what it reads
+            MistakesContainer Mistakes;
+        };
+
+        std::string m_code;
+        std::vector<Unit> m_units;
+        std::shared_ptr<SymbolTable> m_emptyScope;
+        std::size_t m_reparsed { 0 };
+
+        void Update(std::size_t offset, std::size_t length, std::size_t inserted);
+        void ParseUnit(Unit& unit, const std::shared_ptr<SymbolTable>& scope) const;
+        void RebuildSelector(const std::string& name);
+        void RebuildRoot();
+        void RenumberBlocks();
+
+        [[nodiscard]] const std::shared_ptr<SymbolTable>& ScopeBefore(std::size_t unit) const;
+        [[nodiscard]] static Unit ScanUnit(std::string_view code, std::size_t begin);
+        [[nodiscard]] static std::shared_ptr<SymbolTable> MakeScope(const std::shared_ptr<SymbolTable>& previous,
+                                                                   const std::shared_ptr<SymbolTable>& defines);
+    };
+}
@@ -0,0 +1,160 @@
+#include <tss/parsing/ParseCache.h>
+#include <cstring>
+#include <format>
+#include <stdexcept>
+#include <vector>
+#include <tss/utils/Hashing.h>
+#include <tss/utils/MappedFile.h>
+
+namespace Trema::Style
+{
+    namespace
+    {
+        constexpr char Magic[4] = { 'T', 'S', 'S', 'C' };
+
+        // Entry layout: header, mistake records, then the frozen index image at an 8-byte aligned offset
+        struct EntryHeader
+        {
+            char Magic[4];
+            std::uint32_t Version;
+            std::uint32_t ImageVersion;
+            std::uint32_t MistakeCount;
+            std::uint64_t SourceHash; // second hash of the source, with another seed than the file name
+            std::uint64_t SourceSize;
+            std::uint64_t Image;
+            std::uint64_t ImageSize;
+        };
+
+        struct MistakeRecord
+        {
+            std::uint32_t Line;
+            std::uint32_t Position;
+            std::uint16_t Code;
+            std::uint8_t Fatal;
+            std::uint8_t Reserved;
+            std::uint32_t ExtraSize; // followed by the characters of Extra
+        };
+
+        static_assert(std::is_trivially_copyable_v<EntryHeader> && sizeof(EntryHeader) == 48);
+        static_assert(sizeof(MistakeRecord) == 16);
+
+        constexpr std::uint64_t SourceSeed = 1;
+
+        std::uint64_t EntryKey(const std::string_view code)
+        {
+            return Utils::CombineHashes(Utils::HashContents(code),
+                                        Utils::CombineHashes(ParseCache::Version, FrozenStyleIndex::FormatVersion));
+        }
+
+        template<typename T>
+        void Write(std::vector<std::byte>& buffer, const T& value)
+        {
+            const auto offset = buffer.size();
+            buffer.resize(offset + sizeof(T));
+            std::memcpy(buffer.data() + offset, &value, sizeof(T));
+        }
+    }
+
+    ParseCache::ParseCache(std::filesystem::path directory) :
+        m_directory(std::move(directory))
+    {
+    }
+
+    std::filesystem::path ParseCache::GetEntryPath(const std::string_view code) const
+    {
+        return m_directory / std::format("{:016x}.tssc", EntryKey(code));
+    }
+
+    std::optional<ParseCache::Entry> ParseCache::Find(const std::string_view code) const
+    {
+        const auto path = GetEntryPath(code);
+        std::error_code error;
+        if (!std::filesystem::is_regular_file(path, error))
+            return std::nullopt;
+
+        try
+        {
+            const auto file = Utils::MappedFile::Open(path);
+            const auto data = file.Data.get();
+
+            EntryHeader header;
+            if (file.Size < sizeof(header))
+                return std::nullopt;
+            std::memcpy(&header, data, sizeof(header));
+            if (std::memcmp(header.Magic, Magic, sizeof(Magic)) != 0 || header.Version != Version ||
+                header.ImageVersion != FrozenStyleIndex::FormatVersion || header.SourceSize != code.size() ||
+                header.SourceHash != Utils::HashContents(code, SourceSeed) ||
+                header.Image % 8 != 0 || header.Image < sizeof(header) || header.Image > file.Size ||
+                header.ImageSize > file.Size - header.Image)
+                return std::nullopt;
+
+            Entry entry;
+            std::size_t offset = sizeof(header);
+            for (std::uint32_t i = 0; i < header.MistakeCount; ++i)
+            {
+                MistakeRecord record;
+                if (header.Image - offset < sizeof(record))
+                    return std::nullopt;
+                std::memcpy(&record, data + offset, sizeof(record));
+                offset += sizeof(record);
+
+                if (header.Image - offset < record.ExtraSize)
+                    return std::nullopt;
+                entry.Mistakes << CompilationMistake
+                {
+                    .Line = record.Line, .Position = record.Position, .Fatal = record.Fatal != 0,
+                    .Code = static_cast<ErrorCode>(record.Code),
+                    .Extra = std::string(reinterpret_cast<const char*>(data + offset), record.ExtraSize)
+                };
+                offset += record.ExtraSize;
+            }
+
+            // The index keeps the mapping alive
+            entry.Index = FrozenStyleIndex::FromImage(std::shared_ptr<const std::byte>(file.Data, data + header.Image),
+                                                      header.ImageSize);
+            return entry;
+        }
+        catch (const std::exception&)
+        {
+            return std::nullopt;
+        }
+    }
+
+    void ParseCache::Store(const std::string_view code, const FrozenStyleIndex& index,
+                           const MistakesContainer& mistakes) const
+    {
+        const auto image = index.GetImage();
+
+        std::vector<std::byte> buffer;
+        buffer.resize(sizeof(EntryHeader));
+        for (const auto& mistake : mistakes)
+        {
+            Write(buffer, MistakeRecord
+            {
+                .Line = mistake.Line, .Position = mistake.Position, .Code = static_cast<std::uint16_t>(mistake.Code),
+                .Fatal = mistake.Fatal ? std::uint8_t { 1 } : std::uint8_t { 0 }, .Reserved = 0,
+                .ExtraSize = static_cast<std::uint32_t>(mistake.Extra.size())
+            });
+            const auto offset = buffer.size();
+            buffer.resize(offset + mistake.Extra.size());
+            std::memcpy(buffer.data() + offset, mistake.Extra.data(), mistake.Extra.size());
+        }
+        buffer.resize((buffer.size() + 7) & ~std::size_t { 7 });
+
+        EntryHeader header { };
+        std::memcpy(header.Magic, Magic, sizeof(Magic));
+        header.Version = Version;
+        header.ImageVersion = FrozenStyleIndex::FormatVersion;
+        header.MistakeCount = static_cast<std::uint32_t>(mistakes.size());
+        header.SourceHash = Utils::HashContents(code, SourceSeed);
+        header.SourceSize = code.size();
+        header.Image = buffer.size();
+        header.ImageSize = image.size();
+        std::memcpy(buffer.data(), &header, sizeof(header));
+
+        buffer.insert(buffer.end(), image.begin(), image.end());
+
+        std::filesystem::create_directories(m_directory);
+        Utils::WriteFileAtomically(GetEntryPath(code), buffer.data(), buffer.size());
+    }
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string_view>
+#include <tss/errors/MistakesContainer.h>
+#include <tss/sheets/FrozenStyleIndex.h>
+
+namespace Trema::Style
+{
+    // Directory of parse results keyed by a hash of the source code and of the cache version. An entry holds the
+    // frozen index of one file and the mistakes found while parsing it, so a cached load reports the same
+    // diagnostics. Entries are written atomically; unreadable or stale entries are treated as misses.
+    class ParseCache final
+    {
+    public:
+        // Bump when parse results or the entry layout change
+        static constexpr std::uint32_t Version = 1;
+
+        struct Entry
+        {
+            FrozenStyleIndex Index;
+            MistakesContainer Mistakes;
+        };
+
+        explicit ParseCache(std::filesystem::path directory);
+
+        [[nodiscard]] std::optional<Entry> Find(std::string_view code) const;
+        void Store(std::string_view code, const FrozenStyleIndex& index, const MistakesContainer& mistakes) const;
+
+        [[nodiscard]] const std::filesystem::path& GetDirectory() const { return m_directory; }
+        [[nodiscard]] std::filesystem::path GetEntryPath(std::string_view code) const;
+
+    private:
+        std::filesystem::path m_directory;
+    };
+}
@@ -0,0 +1,255 @@
+#include <tss/parsing/SheetCompiler.h>
+#include <algorithm>
+#include <charconv>
+#include <format>
+#include <fstream>
+#include <optional>
+#include <sstream>
+#include <tss/sheets/FrozenStyleIndex.h>
+#include <tss/utils/Hashing.h>
+#include <tss/utils/MappedFile.h>
+
+namespace Trema::Style
+{
+    namespace
+    {
+        using Clock = std::chrono::steady_clock;
+
+        // Bumped with FrozenStyleIndex::FormatVersion, so that outputs in an older format are compiled again
+        constexpr std::string_view ManifestHeader = "tssc-manifest 4";
+
+        std::filesystem::path Canonical(const std::filesystem::path& path)
+        {
+            std::error_code error;
+            auto canonical = std::filesystem::weakly_canonical(std::filesystem::absolute(path), error);
+            return error ? std::filesystem::absolute(path).lexically_normal() : canonical;
+        }
+
+        std::optional<std::uint64_t> HashFile(const std::filesystem::path& path)
+        {
+            try
+            {
+                const auto file = Utils::MappedFile::Open(path);
+                if (file.Size == 0)
+                    return Utils::HashContents("");
+
+                return Utils::HashContents({ reinterpret_cast<const char*>(file.Data.get()), file.Size });
+            }
+            catch (const std::exception&)
+            {
+                return std::nullopt;
+            }
+        }
+    }
+
+    std::size_t SheetCompiler::Report::CompiledCount() const
+    {
+        return std::ranges::count_if(Sheets, [](const Result& result) { return result.Compiled; });
+    }
+
+    std::size_t SheetCompiler::Report::FailedCount() const
+    {
+        return std::ranges::count_if(Sheets, [](const Result& result)
+        {
+            return result.Error != nullptr || !result.Mistakes.empty();
+        });
+    }
+
+    SheetCompiler::SheetCompiler(std::filesystem::path sourceDirectory, std::filesystem::path outputDirectory) :
+        m_sourceDirectory(Canonical(sourceDirectory)),
+        m_outputDirectory(std::move(outputDirectory))
+    {
+    }
+
+    SheetCompiler::Report SheetCompiler::Compile(Utils::ThreadPool& pool)
+    {
+        return Compile(FindSources(), pool);
+    }
+
+    SheetCompiler::Report SheetCompiler::Compile(const std::span<const std::filesystem::path> sources,
+                                                 Utils::ThreadPool& pool)
+    {
+        Report report;
+        auto start = Clock::now();
+
+        // Hash every file the previous outputs were built from, once
+        auto manifest = ReadManifest();
+        std::vector<std::string> keys;
+        std::unordered_map<std::string, std::optional<std::uint64_t>> hashes;
+        for (const auto& source : sources)
+        {
+            keys.push_back(Canonical(source).string());
+            if (const auto entry = manifest.find(keys.back()); entry != manifest.end())
+            {
+                for (const auto& dependency : entry->second)
+                    hashes.emplace(dependency.Path.string(), std::nullopt);
+            }
+        }
+
+        // Task groups, so compiling from inside a task of the same pool doesn't deadlock
+        Utils::TaskGroup hashing(pool);
+        for (auto& [path, hash] : hashes)
+            hashing.Run([&path, &hash] { hash = HashFile(path); });
+        hashing.Wait();
+
+        std::vector<std::size_t> stale;
+        report.Sheets.resize(sources.size());
+        for (std::size_t i = 0; i < sources.size(); ++i)
+        {
+            auto& result = report.Sheets[i];
+            result.Source = sources[i];
+            result.Output = GetOutputPath(sources[i]);
+
+            const auto entry = manifest.find(keys[i]);
+            const auto upToDate = entry != manifest.end() && std::filesystem::exists(result.Output) &&
+                std::ranges::all_of(entry->second, [&hashes](const Dependency& dependency)
+                {
+                    return hashes.at(dependency.Path.string()) == dependency.Hash;
+                });
+
+            if (!upToDate)
+            {
+                result.Compiled = true;
+                stale.push_back(i);
+                manifest.erase(keys[i]);
+            }
+        }
+        report.CheckTime = Clock::now() - start;
+        start = Clock::now();
+
+        // One load parses every file once, imports shared by several sheets included; loading each sheet again
+        // afterwards only collects what was parsed
+        std::vector<SheetLoader::Source> loads;
+        for (const auto i : stale)
+            loads.push_back({ .Path = sources[i] });
+        (void) m_loader.Load(loads, pool);
+
+        std::vector<SheetLoader::SelectorMap> variables(sources.size());
+        std::vector<std::vector<Dependency>> dependencies(sources.size());
+        for (std::size_t s = 0; s < stale.size(); ++s)
+        {
+            const auto i = stale[s];
+            auto& result = report.Sheets[i];
+            try
+            {
+                const auto sheets = m_loader.Load({ &loads[s], 1 }, pool);
+                SheetLoader::Merge(sheets, variables[i], result.Mistakes);
+                for (const auto& sheet : sheets)
+                    dependencies[i].push_back({ sheet->Path, sheet->Hash });
+            }
+            catch (...)
+            {
+                result.Error = std::current_exception();
+            }
+        }
+        report.ParseTime = Clock::now() - start;
+        start = Clock::now();
+
+        Utils::TaskGroup writing(pool);
+        for (const auto i : stale)
+        {
+            auto& result = report.Sheets[i];
+            if (result.Error || !result.Mistakes.empty())
+            {
+                // An output left from an earlier run would otherwise pass for this sheet
+                std::error_code error;
+                std::filesystem::remove(result.Output, error);
+                continue;
+            }
+
+            writing.Run([&result, &selectors = variables[i]]
+            {
+                try
+                {
+                    std::filesystem::create_directories(result.Output.parent_path());
+                    FrozenStyleIndex::Build(selectors).Save(result.Output);
+                }
+                catch (...)
+                {
+                    result.Error = std::current_exception();
+                }
+            });
+        }
+        writing.Wait();
+
+        for (const auto i : stale)
+        {
+            if (!report.Sheets[i].Error && report.Sheets[i].Mistakes.empty())
+                manifest[keys[i]] = std::move(dependencies[i]);
+        }
+        WriteManifest(manifest);
+        report.WriteTime = Clock::now() - start;
+
+        return report;
+    }
+
+    std::filesystem::path SheetCompiler::GetOutputPath(const std::filesystem::path& source) const
+    {
+        auto relative = Canonical(source).lexically_relative(m_sourceDirectory);
+        if (relative.empty() || *relative.begin() == "..")
+            relative = source.filename();
+
+        return (m_outputDirectory / relative).replace_extension(".tssc");
+    }
+
+    std::vector<std::filesystem::path> SheetCompiler::FindSources() const
+    {
+        std::vector<std::filesystem::path> sources;
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(m_sourceDirectory))
+        {
+            if (entry.is_regular_file() && entry.path().extension() == ".tss")
+                sources.push_back(entry.path());
+        }
+
+        std::ranges::sort(sources);
+        return sources;
+    }
+
+    SheetCompiler::Manifest SheetCompiler::ReadManifest() const
+    {
+        // One "sheet <path>" line per output, followed by a "dep <hash> <path>" line per file it was built from
+        Manifest manifest;
+        std::ifstream file(m_outputDirectory / ManifestName);
+        std::string line;
+        if (!std::getline(file, line) || line != ManifestHeader)
+            return manifest;
+
+        std::vector<Dependency>* dependencies = nullptr;
+        while (std::getline(file, line))
+        {
+            if (line.starts_with("sheet "))
+            {
+                dependencies = &manifest[line.substr(6)];
+            }
+            else if (line.starts_with("dep ") && line.size() > 21 && line[20] == ' ' && dependencies)
+            {
+                std::uint64_t hash = 0;
+                if (std::from_chars(line.data() + 4, line.data() + 20, hash, 16).ptr != line.data() + 20)
+                    return { };
+                dependencies->push_back({ line.substr(21), hash });
+            }
+            else
+            {
+                return { };
+            }
+        }
+
+        return manifest;
+    }
+
+    void SheetCompiler::WriteManifest(const Manifest& manifest) const
+    {
+        std::ostringstream ss;
+        ss << ManifestHeader << '\n';
+        for (const auto& [source, dependencies] : manifest)
+        {
+            ss << "sheet " << source << '\n';
+            for (const auto& dependency : dependencies)
+                ss << std::format("dep {:016x} {}\n", dependency.Hash, dependency.Path.string());
+        }
+
+        const auto contents = ss.str();
+        std::filesystem::create_directories(m_outputDirectory);
+        Utils::WriteFileAtomically(m_outputDirectory / ManifestName, contents.data(), contents.size());
+    }
+}
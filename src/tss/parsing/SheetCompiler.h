@@ -0,0 +1,71 @@
+#pragma once
+#include <chrono>
+#include <exception>
+#include <filesystem>
+#include <span>
+#include <unordered_map>
+#include <vector>
+#include <tss/errors/MistakesContainer.h>
+#include <tss/parsing/SheetLoader.h>
+#include <tss/utils/ThreadPool.h>
+
+namespace Trema::Style
+{
+    // Compiles the sheets of a source directory into precompiled sheets (see StyleSheet::Load) in an output
+    // directory, mirroring its layout. A manifest in the output directory records the content hash of every file
+    // each output was built from, imports included; a sheet is only compiled again when one of them changed.
+    // Sheets with mistakes fail: their output is not written, an older one is removed, and they are not recorded,
+    // so their diagnostics show up on every run until they are fixed.
+    class SheetCompiler final
+    {
+    public:
+        static constexpr auto ManifestName = "tssc.manifest";
+
+        struct Result
+        {
+            std::filesystem::path Source;
+            std::filesystem::path Output;
+            bool Compiled { false };        // false when the output was up to date
+            MistakesContainer Mistakes;
+            std::exception_ptr Error;
+        };
+
+        struct Report
+        {
+            std::vector<Result> Sheets;
+            std::chrono::nanoseconds CheckTime { 0 };
+            std::chrono::nanoseconds ParseTime { 0 };
+            std::chrono::nanoseconds WriteTime { 0 };
+
+            [[nodiscard]] std::size_t CompiledCount() const;
+            // Sheets with an error or mistakes
+            [[nodiscard]] std::size_t FailedCount() const;
+        };
+
+        SheetCompiler(std::filesystem::path sourceDirectory, std::filesystem::path outputDirectory);
+
+        // Every .tss file under the source directory
+        Report Compile(Utils::ThreadPool& pool = Utils::ThreadPool::Default());
+        Report Compile(std::span<const std::filesystem::path> sources,
+                       Utils::ThreadPool& pool = Utils::ThreadPool::Default());
+
+        [[nodiscard]] std::filesystem::path GetOutputPath(const std::filesystem::path& source) const;
+        [[nodiscard]] std::vector<std::filesystem::path> FindSources() const;
+
+    private:
+        struct Dependency
+        {
+            std::filesystem::path Path;
+            std::uint64_t Hash { 0 };
+        };
+
+        using Manifest = std::unordered_map<std::string, std::vector<Dependency>>;
+
+        std::filesystem::path m_sourceDirectory;
+        std::filesystem::path m_outputDirectory;
+        SheetLoader m_loader;   // remembers parsed files between compiles
+
+        [[nodiscard]] Manifest ReadManifest() const;
+        void WriteManifest(const Manifest& manifest) const;
+    };
+}
@@ -0,0 +1,471 @@
+#include <tss/parsing/SheetLoader.h>
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <stdexcept>
+#include <tss/parsing/StackedStyleParser.h>
+#include <tss/tokenization/EndToEndTokenizer.h>
+#include <tss/utils/Hashing.h>
+
+namespace Trema::Style
+{
+    struct SheetLoader::Node
+    {
+        std::string Key;                            // canonical path, unique per file
+        std::filesystem::path Path;
+        std::filesystem::path Directory;
+        std::optional<std::string> Code;            // in-memory sources aren't read nor remembered
+        std::string Text;
+        Stamp FileStamp;
+        std::vector<Import> Imports;
+        std::vector<std::optional<std::size_t>> Targets; // node of each import, empty once the edge is dropped
+        MistakesContainer Mistakes;                 // found while resolving imports
+        std::exception_ptr Error;
+        std::shared_ptr<const Entry> Memo;
+        std::shared_ptr<const Sheet> Result;
+        bool Reused { false };
+        std::size_t Level { 0 };                    // parsed after every level below it
+    };
+
+    namespace
+    {
+        std::string ReadCode(const std::filesystem::path& path)
+        {
+            std::ifstream file(path, std::ios::in | std::ios::binary);
+            if (!file)
+                throw std::runtime_error(std::format("File not found: \"{}\"", path.string()));
+
+            return { std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+        }
+
+        std::filesystem::path Canonical(const std::filesystem::path& path)
+        {
+            std::error_code error;
+            auto canonical = std::filesystem::weakly_canonical(std::filesystem::absolute(path), error);
+            return error ? std::filesystem::absolute(path).lexically_normal() : canonical;
+        }
+
+        // Runs task on every item, the first one on the calling thread; task must not throw
+        template<typename F>
+        void RunAll(Utils::ThreadPool& pool, const std::vector<std::size_t>& items, const F& task)
+        {
+            if (items.empty())
+                return;
+
+            // A task group, since loads may run inside a task of the same pool
+            Utils::TaskGroup group(pool);
+            for (std::size_t i = 1; i < items.size(); ++i)
+                group.Run([&task, item = items[i]] { task(item); });
+
+            task(items.front());
+            group.Wait();
+        }
+    }
+
+    SheetLoader::SheetLoader(std::shared_ptr<const ParseCache> cache) :
+        m_cache(std::move(cache))
+    {
+    }
+
+    std::vector<std::shared_ptr<const SheetLoader::Sheet>> SheetLoader::Load(const std::span<const Source> roots,
+                                                                             Utils::ThreadPool& pool)
+    {
+        std::lock_guard lock(m_mutex);
+
+        std::vector<Node> nodes;
+        std::unordered_map<std::string, std::size_t> indices;
+        const auto add = [&](std::string key, const std::filesystem::path& path) -> std::pair<std::size_t, bool>
+        {
+            const auto [it, inserted] = indices.emplace(std::move(key), nodes.size());
+            if (inserted)
+            {
+                auto& node = nodes.emplace_back();
+                node.Key = it->first;
+                node.Directory = path.parent_path();
+                node.Path = path;
+                if (const auto memo = m_memo.find(node.Key); memo != m_memo.end())
+                    node.Memo = memo->second;
+            }
+            return { it->second, inserted };
+        };
+
+        std::vector<std::size_t> rootNodes;
+        for (std::size_t i = 0; i < roots.size(); ++i)
+        {
+            if (roots[i].Code)
+            {
+                const auto index = add(std::format("<code {}>", i), { }).first;
+                nodes[index].Directory = roots[i].Path;
+                nodes[index].Code = roots[i].Code;
+                rootNodes.push_back(index);
+            }
+            else
+            {
+                const auto path = Canonical(roots[i].Path);
+                rootNodes.push_back(add(path.string(), path).first);
+            }
+        }
+
+        // Discover the graph one level of imports at a time
+        std::vector<std::size_t> wave(nodes.size());
+        for (std::size_t i = 0; i < wave.size(); ++i)
+            wave[i] = i;
+        while (!wave.empty())
+        {
+            RunAll(pool, wave, [&nodes, this](const std::size_t i) { Read(nodes[i]); });
+
+            std::vector<std::size_t> next;
+            for (const auto i : wave)
+            {
+                std::vector<std::optional<std::size_t>> targets;
+                for (std::size_t j = 0; j < nodes[i].Imports.size(); ++j)
+                {
+                    const auto path = Canonical(nodes[i].Directory / nodes[i].Imports[j].Path);
+                    const auto [target, inserted] = add(path.string(), path);
+                    if (inserted)
+                        next.push_back(target);
+                    targets.emplace_back(target);
+                }
+                nodes[i].Targets = std::move(targets);
+            }
+            wave = std::move(next);
+        }
+
+        for (auto& node : nodes)
+        {
+            for (std::size_t j = 0; j < node.Targets.size(); ++j)
+            {
+                if (!nodes[*node.Targets[j]].Error)
+                    continue;
+
+                const auto& import = node.Imports[j];
+                node.Mistakes << CompilationMistake
+                {
+                    .Line = import.Line, .Position = import.Position,
+                    .Code = ErrorCode::UnresolvedImport, .Extra = import.Path
+                };
+                node.Targets[j].reset();
+            }
+        }
+
+        // Contribution order; an import closing a cycle is dropped
+        std::vector<std::size_t> order;
+        std::vector<std::size_t> path;
+        std::vector<char> state(nodes.size(), 0);
+        const std::function<void(std::size_t)> visit = [&](const std::size_t i)
+        {
+            state[i] = 1;
+            path.push_back(i);
+            for (std::size_t j = 0; j < nodes[i].Targets.size(); ++j)
+            {
+                const auto target = nodes[i].Targets[j];
+                if (!target)
+                    continue;
+
+                if (state[*target] == 1)
+                {
+                    std::string chain;
+                    for (auto it = std::find(path.begin(), path.end(), *target); it != path.end(); ++it)
+                        chain += std::format("{} -> ", nodes[*it].Path.string());
+                    chain += nodes[*target].Path.string();
+
+                    nodes[i].Mistakes << CompilationMistake
+                    {
+                        .Line = nodes[i].Imports[j].Line, .Position = nodes[i].Imports[j].Position,
+                        .Code = ErrorCode::ImportCycle, .Extra = std::move(chain)
+                    };
+                    nodes[i].Targets[j].reset();
+                }
+                else if (state[*target] == 0)
+                {
+                    visit(*target);
+                }
+            }
+            path.pop_back();
+            state[i] = 2;
+            order.push_back(i);
+        };
+        for (const auto root : rootNodes)
+        {
+            if (state[root] == 0)
+                visit(root);
+        }
+
+        // Reuse what didn't change, then parse the rest level by level
+        std::vector<std::vector<std::size_t>> levels;
+        for (const auto i : order)
+        {
+            auto& node = nodes[i];
+            if (node.Error)
+            {
+                node.Result = std::make_shared<const Sheet>(Sheet { .Path = node.Path, .Error = node.Error });
+                continue;
+            }
+
+            std::vector<std::string> keys;
+            bool importsReused = true;
+            for (const auto& target : node.Targets)
+            {
+                if (!target)
+                    continue;
+                keys.push_back(nodes[*target].Key);
+                importsReused = importsReused && nodes[*target].Reused;
+                node.Level = std::max(node.Level, nodes[*target].Level + 1);
+            }
+
+            node.Reused = !node.Code && node.Memo && node.Memo->FileStamp == node.FileStamp &&
+                node.Mistakes.empty() && node.Memo->Keys == keys && importsReused;
+            if (node.Reused)
+            {
+                node.Result = node.Memo->Result;
+                continue;
+            }
+
+            if (levels.size() <= node.Level)
+                levels.resize(node.Level + 1);
+            levels[node.Level].push_back(i);
+        }
+
+        m_parsed = 0;
+        for (const auto& level : levels)
+        {
+            RunAll(pool, level, [&nodes, this](const std::size_t i) { Parse(nodes[i], nodes); });
+            m_parsed += level.size();
+        }
+
+        std::vector<std::shared_ptr<const Sheet>> sheets;
+        sheets.reserve(order.size());
+        for (const auto i : order)
+        {
+            const auto& node = nodes[i];
+            sheets.push_back(node.Result);
+            if (node.Code || node.Reused || node.Result->Error)
+                continue;
+
+            auto entry = std::make_shared<Entry>();
+            entry->FileStamp = node.FileStamp;
+            entry->Code = node.Text;
+            entry->Imports = node.Imports;
+            for (const auto& target : node.Targets)
+            {
+                if (target)
+                    entry->Keys.push_back(nodes[*target].Key);
+            }
+            entry->Result = node.Result;
+            m_memo[node.Key] = std::move(entry);
+        }
+
+        return sheets;
+    }
+
+    void SheetLoader::SetSchema(std::shared_ptr<const PropertySchema> schema)
+    {
+        std::lock_guard lock(m_mutex);
+        m_schema = std::move(schema);
+        m_memo.clear();
+    }
+
+    void SheetLoader::Merge(const std::span<const std::shared_ptr<const Sheet>> sheets, SelectorMap& variables,
+                            MistakesContainer& mistakes)
+    {
+        // Each sheet numbers its blocks from 0: the blocks of a sheet come after those merged before it
+        std::uint32_t blocks = 0;
+        for (const auto& [name, table] : variables)
+            blocks = std::max(blocks, table->GetOrder() + 1);
+
+        for (const auto& sheet : sheets)
+        {
+            if (sheet->Error)
+                std::rethrow_exception(sheet->Error);
+            const auto base = blocks;
+
+            // Tables shared by a selector list stay shared
+            std::unordered_map<const SymbolTable*, std::shared_ptr<SymbolTable>> copies;
+            for (const auto& [name, table] : sheet->Variables)
+            {
+                if (const auto it = variables.find(name); it != variables.end())
+                {
+                    AppendBlock(it->second, *table);
+                    continue;
+                }
+
+                auto& copy = copies[table.get()];
+                if (!copy)
+                {
+                    copy = std::make_shared<SymbolTable>(*table); // the loader keeps the original
+                    copy->SetOrder(base + table->GetOrder());
+                    blocks = std::max(blocks, copy->GetOrder() + 1);
+                }
+                variables.emplace(name, copy);
+            }
+            mistakes.insert(mistakes.end(), sheet->Mistakes.begin(), sheet->Mistakes.end());
+        }
+    }
+
+    void SheetLoader::Read(Node& node) const
+    {
+        try
+        {
+            if (node.Code)
+            {
+                node.Text = *node.Code;
+                node.Imports = FindImports(node.Text, node.Mistakes);
+                return;
+            }
+
+            std::error_code error;
+            node.FileStamp.Time = std::filesystem::last_write_time(node.Path, error);
+            if (!error)
+                node.FileStamp.Size = std::filesystem::file_size(node.Path, error);
+            if (error)
+                throw std::runtime_error(std::format("File not found: \"{}\"", node.Path.string()));
+
+            if (node.Memo && node.Memo->FileStamp == node.FileStamp)
+            {
+                node.Text = node.Memo->Code;
+                node.Imports = node.Memo->Imports;
+                return;
+            }
+
+            node.Text = ReadCode(node.Path);
+            node.Imports = FindImports(node.Text, node.Mistakes);
+        }
+        catch (...)
+        {
+            node.Error = std::current_exception();
+        }
+    }
+
+    void SheetLoader::Parse(Node& node, const std::vector<Node>& nodes) const
+    {
+        // Root variables of the whole import closure in contribution order, so that later imports win
+        std::vector<std::size_t> closure;
+        std::vector<char> seen(nodes.size(), 0);
+        const std::function<void(std::size_t)> collect = [&](const std::size_t i)
+        {
+            for (const auto& target : nodes[i].Targets)
+            {
+                if (target && !seen[*target])
+                {
+                    seen[*target] = 1;
+                    collect(*target);
+                    closure.push_back(*target);
+                }
+            }
+        };
+        collect(static_cast<std::size_t>(&node - nodes.data()));
+
+        std::shared_ptr<SymbolTable> scope;
+        for (const auto i : closure)
+        {
+            const auto& variables = nodes[i].Result->Variables;
+            if (const auto it = variables.find("#"); it != variables.end())
+            {
+                if (!scope)
+                    scope = std::make_shared<SymbolTable>();
+                scope->Append(*it->second);
+            }
+        }
+
+        auto sheet = std::make_shared<Sheet>();
+        sheet->Path = node.Path;
+        sheet->Hash = Utils::HashContents(node.Text);
+        try
+        {
+            // Without a scope or schema the results only depend on the code and can be cached
+            const auto cache = scope || m_schema ? nullptr : m_cache.get();
+            std::optional<ParseCache::Entry> entry;
+            if (cache)
+                entry = cache->Find(node.Text);
+
+            if (entry)
+            {
+                sheet->Variables = entry->Index.Thaw();
+                sheet->Mistakes = std::move(entry->Mistakes);
+            }
+            else
+            {
+                StackedStyleParser parser(std::make_unique<EndToEndTokenizer>("", sheet->Mistakes), sheet->Mistakes);
+                parser.SetSchema(m_schema);
+                parser.ParseFromCode(node.Text, scope);
+
+                if (cache)
+                {
+                    try
+                    {
+                        cache->Store(node.Text, parser.Freeze(), sheet->Mistakes);
+                    }
+                    catch (const std::exception&)
+                    {
+                        // The cache is only an optimization: failing to write it must not fail the parse
+                    }
+                }
+
+                sheet->Variables = parser.GetVariables();
+            }
+        }
+        catch (...)
+        {
+            sheet->Error = std::current_exception();
+        }
+
+        sheet->Mistakes.insert(sheet->Mistakes.begin(), node.Mistakes.begin(), node.Mistakes.end());
+        if (!node.Code)
+        {
+            for (auto& mistake : sheet->Mistakes)
+                mistake.File = node.Path.string();
+        }
+
+        node.Result = std::move(sheet);
+    }
+
+    bool SheetLoader::HasImports(const std::string& code)
+    {
+        if (code.find("@import") == std::string::npos)
+            return false;
+
+        MistakesContainer ignored; // reported again by the parser
+        EndToEndTokenizer tokenizer(code, ignored);
+        while (!tokenizer.Empty())
+        {
+            const auto token = tokenizer.GetNextToken();
+            if (token.GetTokenType() == TokenType::Directive && std::get<StringRef>(token.GetValue()) == "import")
+                return true;
+        }
+        return false;
+    }
+
+    std::vector<SheetLoader::Import> SheetLoader::FindImports(const std::string& code, MistakesContainer& mistakes)
+    {
+        std::vector<Import> imports;
+        if (code.find("@import") == std::string::npos)
+            return imports;
+
+        MistakesContainer ignored; // reported again by the parser
+        EndToEndTokenizer tokenizer(code, ignored);
+        while (!tokenizer.Empty())
+        {
+            const auto token = tokenizer.GetNextToken();
+            if (token.GetTokenType() != TokenType::Directive || std::get<StringRef>(token.GetValue()) != "import")
+                continue;
+
+            if (!tokenizer.Empty())
+            {
+                if (const auto path = tokenizer.GetNextToken(); path.GetTokenType() == TokenType::LiteralString)
+                {
+                    imports.push_back({ std::get<StringRef>(path.GetValue()).Str(), token.GetLine(), token.GetPosition() });
+                    continue;
+                }
+            }
+
+            mistakes << CompilationMistake
+            {
+                .Line = token.GetLine(), .Position = token.GetPosition(),
+                .Code = ErrorCode::UnexpectedToken, .Extra = "@import expects a path"
+            };
+        }
+
+        return imports;
+    }
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <tss/errors/MistakesContainer.h>
+#include <tss/parsing/ParseCache.h>
+#include <tss/utils/ThreadPool.h>
+#include <tss/variables/PropertySchema.h>
+#include <tss/variables/SymbolTable.h>
+
+namespace Trema::Style
+{
+    // Loads sheets together with the files they import (@import "path";). The import graph is read on a thread
+    // pool and every file is parsed once, after the files it imports, with their root variables in scope.
+    // Sheets come out in contribution order: depth-first from the roots, each file after its imports and only the
+    // first time it is reached. Files are remembered between loads and parsed again only when they or one of their
+    // imports changed.
+    class SheetLoader final
+    {
+    public:
+        using SelectorMap = Style::SelectorMap;
+
+        struct Source
+        {
+            std::filesystem::path Path;     // with Code, the directory its imports are resolved from
+            std::optional<std::string> Code;
+        };
+
+        struct Sheet
+        {
+            std::filesystem::path Path;
+            std::uint64_t Hash { 0 };       // Utils::HashContents of the code
+            SelectorMap Variables;          // shared with later loads: copy a table before changing it
+            MistakesContainer Mistakes;
+            std::exception_ptr Error;       // set when a root couldn't be read or parsed
+        };
+
+        explicit SheetLoader(std::shared_ptr<const ParseCache> cache = nullptr);
+
+        // Files with no imports reuse the results of contents parsed before
+        void SetCache(std::shared_ptr<const ParseCache> cache) { m_cache = std::move(cache); }
+        // Files are type checked against the schema; setting it forgets the files parsed before
+        void SetSchema(std::shared_ptr<const PropertySchema> schema);
+
+        [[nodiscard]] std::vector<std::shared_ptr<const Sheet>> Load(std::span<const Source> roots,
+                                                                     Utils::ThreadPool& pool);
+
+        // Appends the sheets to variables and mistakes in order; rethrows the error of the first failed sheet
+        static void Merge(std::span<const std::shared_ptr<const Sheet>> sheets, SelectorMap& variables,
+                          MistakesContainer& mistakes);
+
+        // Whether code has an @import directive; "@import" in comments and strings doesn't count
+        [[nodiscard]] static bool HasImports(const std::string& code);
+
+        // Number of files parsed (not reused) by the last load
+        [[nodiscard]] std::size_t GetParsedCount() const { return m_parsed; }
+
+    private:
+        struct Import
+        {
+            std::string Path;
+            unsigned int Line { 0 };
+            unsigned int Position { 0 };
+        };
+
+        struct Stamp
+        {
+            std::filesystem::file_time_type Time;
+            std::uintmax_t Size { 0 };
+
+            bool operator==(const Stamp&) const = default;
+        };
+
+        struct Entry
+        {
+            Stamp FileStamp;
+            std::string Code;
+            std::vector<Import> Imports;
+            std::vector<std::string> Keys;  // canonical paths of the imports it was parsed with
+            std::shared_ptr<const Sheet> Result;
+        };
+
+        struct Node;
+
+        std::shared_ptr<const ParseCache> m_cache;
+        std::shared_ptr<const PropertySchema> m_schema;
+        std::unordered_map<std::string, std::shared_ptr<const Entry>> m_memo;
+        std::mutex m_mutex;                 // one load at a time
+        std::size_t m_parsed { 0 };
+
+        void Read(Node& node) const;
+        void Parse(Node& node, const std::vector<Node>& nodes) const;
+
+        [[nodiscard]] static std::vector<Import> FindImports(const std::string& code, MistakesContainer& mistakes);
+    };
+}
@@ -0,0 +1,231 @@
+#include <tss/parsing/SheetOptimizer.h>
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <format>
+#include <map>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Trema::Style
+{
+    namespace
+    {
+        using Entry = std::pair<StringRef, Value>;
+
+        // Identifies a block by its contents, so selectors with the same properties can share one table
+        std::string BlockKey(const std::vector<Entry>& entries)
+        {
+            std::string key;
+            for (const auto& [name, value] : entries)
+            {
+                key += name.View();
+                key += '\0';
+                key += static_cast<char>(value.index());
+                std::visit([&]<typename T0>(const T0& arg)
+                {
+                    using T = std::decay_t<T0>;
+                    if constexpr (std::is_same_v<T, StringRef>)
+                        key += std::format("{}:{}", arg.View().size(), arg.View());
+                    else if constexpr (!std::is_same_v<T, std::nullopt_t>)
+                        key.append(reinterpret_cast<const char*>(&arg), sizeof(arg));
+                }, value);
+            }
+            return key;
+        }
+
+        std::string IntegerLiteral(const Integer value)
+        {
+            // Numbers are read as doubles, so integers past 2^53 are spelled as an exact product
+            constexpr Integer Exact = Integer { 1 } << 53;
+            if (value >= -Exact && value <= Exact)
+                return std::to_string(value);
+
+            const auto low = value & 0xFFFFFFFF;
+            return std::format("{}*4294967296{}", value >> 32, low ? std::format("+{}", low) : "");
+        }
+
+        std::string FloatLiteral(const Float value)
+        {
+            if (!std::isfinite(value))
+                throw std::runtime_error(std::format("{} can't be written in TSS", value));
+
+            if (std::trunc(value) != value)
+            {
+                // Shortest representation that reads back as the same value, without the leading zero
+                char buffer[32];
+                const auto end = std::to_chars(buffer, buffer + sizeof(buffer), value).ptr;
+                std::string literal(buffer, end);
+                if (literal.starts_with("0."))
+                    literal.erase(0, 1);
+                else if (literal.starts_with("-0."))
+                    literal.erase(1, 1);
+                return literal;
+            }
+
+            // Whole numbers read back as integers, so they are written as .5 times twice the value, which keeps
+            // them floats; |value| = .5 * multiple * 2^shift, with a multiple small enough to be read exactly
+            int exponent;
+            const auto mantissa = std::frexp(std::abs(value), &exponent);
+            auto shift = std::max(0, exponent - 52);
+            auto literal = std::format("{}.5*{}", std::signbit(value) ? "-" : "",
+                                       static_cast<Integer>(std::ldexp(mantissa, exponent - shift + 1)));
+            for (; shift >= 32; shift -= 32)
+                literal += "*4294967296";
+            if (shift > 0)
+                literal += std::format("*{}", Integer { 1 } << shift);
+            return literal;
+        }
+
+        std::string StringLiteral(const std::string_view value)
+        {
+            // Strings have no escapes: they are quoted with a character they don't contain
+            if (value.find('\n') != std::string_view::npos ||
+                (value.find('"') != std::string_view::npos && value.find('\'') != std::string_view::npos))
+                throw std::runtime_error(std::format("\"{}\" can't be written in TSS", value));
+
+            const char quote = value.find('"') == std::string_view::npos ? '"' : '\'';
+            return std::format("{}{}{}", quote, value, quote);
+        }
+
+        std::string Literal(const Value& value)
+        {
+            if (const auto f = std::get_if<Float>(&value))
+                return FloatLiteral(*f);
+            if (const auto i = std::get_if<Integer>(&value))
+                return IntegerLiteral(*i);
+            if (const auto b = std::get_if<bool>(&value))
+                return *b ? "true" : "false";
+            if (const auto s = std::get_if<StringRef>(&value))
+                return StringLiteral(s->View());
+            if (const auto c = std::get_if<Color>(&value))
+                return std::format("0x{:08X}", c->Rgba);
+
+            throw std::runtime_error("Unsupported variable type");
+        }
+
+        std::string Properties(const SymbolTable& table)
+        {
+            std::map<std::string_view, const Variable*> properties;
+            for (const auto& [name, variable] : table)
+                properties.emplace(name.View(), &variable);
+
+            // Helpers keep their '=', so that optimizing the minified sheet drops them too
+            std::string code;
+            for (const auto& [name, variable] : properties)
+                code += std::format("{}{}{};", name, variable->IsHelper() ? '=' : ':', Literal(variable->GetValue()));
+            return code;
+        }
+    }
+
+    SheetOptimizer::SheetOptimizer(const std::span<const std::string_view> properties) :
+        m_keepAll(false)
+    {
+        for (const auto property : properties)
+            m_properties.emplace(property);
+    }
+
+    SheetOptimizer::SheetOptimizer(const PropertySchema& schema) :
+        m_keepAll(false)
+    {
+        for (const auto& property : schema.GetProperties())
+            m_properties.emplace(property.Name);
+    }
+
+    SheetOptimizer::SelectorMap SheetOptimizer::Optimize(const SelectorMap& selectors)
+    {
+        m_statistics = { };
+
+        SelectorMap optimized;
+        std::unordered_map<std::string, std::shared_ptr<SymbolTable>> tables; // by BlockKey
+        // Tables keep the order of their selectors' blocks: selectors from other blocks get a copy, which shares
+        // the entries
+        std::map<std::pair<const SymbolTable*, std::uint32_t>, std::shared_ptr<SymbolTable>> ordered;
+        std::vector<Entry> entries;
+        for (const auto& [selector, table] : selectors)
+        {
+            entries.clear();
+            for (const auto& [name, variable] : *table)
+            {
+                if (m_keepAll ? !variable.IsHelper() : m_properties.contains(name))
+                    entries.emplace_back(name, variable.GetValue());
+                else
+                    ++m_statistics.RemovedProperties;
+            }
+
+            if (entries.empty())
+            {
+                ++m_statistics.RemovedSelectors;
+                continue;
+            }
+
+            std::ranges::sort(entries, { }, [](const Entry& entry) { return entry.first.View(); });
+            auto& shared = tables[BlockKey(entries)];
+            if (!shared)
+            {
+                shared = std::make_shared<SymbolTable>();
+                for (const auto& [name, value] : entries)
+                {
+                    std::visit([&]<typename T0>(const T0& arg)
+                    {
+                        using T = std::decay_t<T0>;
+                        if constexpr (!std::is_same_v<T, std::nullopt_t>)
+                            shared->SetVariable<T>(name, arg);
+                    }, value);
+                }
+                shared->Compact();
+                shared->SetOrder(table->GetOrder());
+            }
+
+            auto& copy = ordered[{ shared.get(), table->GetOrder() }];
+            if (!copy)
+            {
+                copy = shared->GetOrder() == table->GetOrder() ? shared : std::make_shared<SymbolTable>(*shared);
+                copy->SetOrder(table->GetOrder());
+            }
+            optimized.emplace(selector, copy);
+        }
+
+        m_statistics.Tables = tables.size();
+        return optimized;
+    }
+
+    std::string SheetOptimizer::Minify(const SelectorMap& selectors)
+    {
+        std::string code;
+        if (const auto root = selectors.find("#"); root != selectors.end())
+            code += Properties(*root->second);
+
+        // The selectors of each table, as a list; lists are written in the order of their blocks, so that rules of
+        // equal specificity still apply in the same order
+        std::map<const SymbolTable*, std::vector<std::string_view>> lists;
+        for (const auto& [selector, table] : selectors)
+        {
+            if (selector != "#")
+                lists[table.get()].push_back(selector);
+        }
+
+        std::map<std::pair<std::uint32_t, std::vector<std::string_view>>, const SymbolTable*> blocks;
+        for (auto& [table, list] : lists)
+        {
+            std::ranges::sort(list);
+            blocks.emplace(std::pair(table->GetOrder(), std::move(list)), table);
+        }
+
+        for (const auto& [block, table] : blocks)
+        {
+            const auto properties = Properties(*table);
+            if (properties.empty())
+                continue;
+
+            for (std::size_t i = 0; i < block.second.size(); ++i)
+                code += std::format("{}{}", i ? "," : "", block.second[i]);
+            code += std::format("{{{}}}", properties);
+        }
+
+        return code;
+    }
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <tss/variables/PropertySchema.h>
+#include <tss/variables/SymbolTable.h>
+
+namespace Trema::Style
+{
+    // Shrinks parse results before they are frozen or shipped. The parser already resolves copies and folds
+    // arithmetic, so every value is a literal; what is left is to drop the definitions the application never
+    // reads (helpers such as "red = 0xCC0000FF;" that only existed to be copied), the selectors this leaves empty,
+    // and to let selectors with the same properties share one compacted table. Selectors from other blocks get
+    // copies of it, which share its entries but keep the order of their blocks.
+    class SheetOptimizer final
+    {
+    public:
+        using SelectorMap = Style::SelectorMap;
+
+        struct Statistics
+        {
+            std::size_t RemovedProperties { 0 };
+            std::size_t RemovedSelectors { 0 };
+            std::size_t Tables { 0 }; // distinct sets of properties left, fewer than selectors when some are shared
+        };
+
+        // Keeps every property set with ':' and drops the helpers defined with '='
+        SheetOptimizer() = default;
+        // Only these properties are read by the application, whichever assigner set them; others are dropped
+        explicit SheetOptimizer(std::span<const std::string_view> properties);
+        explicit SheetOptimizer(const PropertySchema& schema);
+
+        [[nodiscard]] SelectorMap Optimize(const SelectorMap& selectors);
+        // Of the last Optimize
+        [[nodiscard]] const Statistics& GetStatistics() const { return m_statistics; }
+
+        // TSS that parses back to the same selectors and values: root properties first, then a block per table,
+        // listing the selectors that share it, with no blanks. Blocks keep their order and the rest is sorted.
+        // Throws std::runtime_error for values TSS can't spell (NaN, infinities, strings with both kinds of quotes
+        // or a line break).
+        [[nodiscard]] static std::string Minify(const SelectorMap& selectors);
+
+    private:
+        bool m_keepAll { true };
+        std::unordered_set<StringRef> m_properties;
+        Statistics m_statistics;
+    };
+}
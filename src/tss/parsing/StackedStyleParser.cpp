@@ -1,10 +1,40 @@
 #include <tss/parsing/StackedStyleParser.h>
-#include <fstream>
 #include <tss/tokenization/EndToEndTokenizer.h>
-
+#include <algorithm>
+#include <limits>
+#include <optional>
 
 namespace Trema::Style
 {
+    namespace
+    {
+        bool IsSelectorPiece(const TokenType type)
+        {
+            return type == TokenType::Identity || type == TokenType::Identifier || type == TokenType::Class ||
+                type == TokenType::Universal || type == TokenType::Comma;
+        }
+
+        // Columns covered by a selector piece; single character tokens are positioned after their character
+        std::pair<unsigned int, unsigned int> GetColumns(const Token& token)
+        {
+            if (token.GetTokenType() == TokenType::Identifier)
+                return { token.GetPosition(), token.GetPosition() + std::get<StringRef>(token.GetValue()).View().size() };
+            return { token.GetPosition() - 1, token.GetPosition() };
+        }
+
+        // An operand of an integral operation: floats are truncated as OperationsTable does, unless they are out of
+        // the range of Integer, where the conversion would be undefined
+        std::optional<Integer> ToIntegral(const Value& value)
+        {
+            constexpr auto limit = 9223372036854775808.0; // 2^63
+            if (const auto integer = std::get_if<Integer>(&value))
+                return *integer;
+            if (const auto number = std::get_if<Float>(&value); number && *number >= -limit && *number < limit)
+                return static_cast<Integer>(*number);
+            return std::nullopt;
+        }
+    }
+
     StackedStyleParser::StackedStyleParser(std::unique_ptr<ITokenizer> tokenizer, MistakesContainer& mistakes) :
         m_tokenizer(std::move(tokenizer)),
         m_pos(0),
@@ -13,6 +43,18 @@ namespace Trema::Style
     }
 
     void StackedStyleParser::ParseFromCode(const std::string& code)
+    {
+        if (!SheetLoader::HasImports(code))
+        {
+            ParseFromCode(code, nullptr);
+            return;
+        }
+
+        const SheetLoader::Source source { .Path = std::filesystem::current_path(), .Code = code };
+        Load({ &source, 1 }, Utils::ThreadPool::Default());
+    }
+
+    void StackedStyleParser::ParseFromCode(const std::string& code, const std::shared_ptr<SymbolTable>& scope)
     {
         EndToEndTokenizer tokenizer(code, m_mistakes);
 
@@ -20,39 +62,81 @@ namespace Trema::Style
             return;
 
         std::stack<Token> tokens;
+        m_scope = scope;
 
         auto currentSt = std::make_shared<SymbolTable>();
+        currentSt->SetOrder(m_blocks++);
         m_symbolTables.push_back(currentSt);
 
         auto currentToken = tokenizer.GetNextToken();
+        std::stack<Token> operators; // of the statement being parsed, with its open parentheses
+        bool inDirective = false;
+        bool failedStatement = false; // an operator or parenthesis of the statement was reported
+        auto lastType = TokenType::EndOfCode; // of the last token that isn't a comment
+
+        // Drop what is left of the statement, so the block keeps its selector
+        const auto dropStatement = [&tokens]
+        {
+            while (!tokens.empty() && tokens.top().GetTokenType() != TokenType::LeftCurlyBracket)
+                tokens.pop();
+        };
         while (!tokenizer.Empty() && currentToken.GetTokenType() != TokenType::EndOfCode)
         {
-            std::stack<Token> operators;
-            switch (currentToken.GetTokenType())
+            // Directives run up to their ';' and were handled before parsing (see SheetLoader)
+            if (inDirective)
+            {
+                inDirective = currentToken.GetTokenType() != TokenType::EndOfInstruction;
+                currentToken = tokenizer.GetNextToken();
+                continue;
+            }
+
+            const auto type = currentToken.GetTokenType();
+            switch (type)
             {
             case TokenType::Identity:
             case TokenType::Identifier:
+            case TokenType::Class:
+            case TokenType::Universal:
+            case TokenType::Comma:
             case TokenType::LiteralBool:
             case TokenType::LiteralString:
             case TokenType::PropertyAssignment:
             case TokenType::VariableAssignment:
             case TokenType::LiteralNumber:
             case TokenType::LiteralFloatNumber:
+            case TokenType::LiteralColor:
                 tokens.push(std::move(currentToken));
                 break;
             case TokenType::Operator:
-                ProcessOperators(operators, currentToken, tokens);
+                if (IsUnaryMinus(currentToken, lastType))
+                {
+                    tokens.emplace(TokenType::LiteralNumber, currentToken.GetPosition(), currentToken.GetLine(),
+                                   Integer { 0 });
+                    currentToken = Token(TokenType::Operator, currentToken.GetPosition(), currentToken.GetLine(),
+                                         StringRef("unary -"));
+                }
+                failedStatement |= !ProcessOperators(operators, currentToken, tokens);
                 break;
             case TokenType::LeftCurlyBracket:
                 currentSt = std::make_shared<SymbolTable>();
+                currentSt->SetOrder(m_blocks++);
                 m_symbolTables.push_back(currentSt);
                 tokens.push(std::move(currentToken));
                 break;
             case TokenType::RightCurlyBracket:
+                if (failedStatement)
+                    dropStatement();
+                failedStatement = false;
+                operators = { };
                 AssignProps(tokens, currentSt);
                 break;
             case TokenType::EndOfInstruction:
-                if (!AssignVar(tokens, operators, currentSt))
+                if (failedStatement)
+                {
+                    // Already reported: what is left would be stored as a wrong value
+                    dropStatement();
+                }
+                else if (!AssignVar(tokens, operators, currentSt))
                 {
                     m_mistakes << CompilationMistake
                     {
@@ -61,56 +145,106 @@ namespace Trema::Style
                         .Code = ErrorCode::UnexpectedToken,
                         .Extra = ";"
                     };
+                    dropStatement();
                 }
+                failedStatement = false;
+                operators = { };
+                break;
+
+            case TokenType::Directive:
+                if (const auto name = std::get<StringRef>(currentToken.GetValue()); name != "import")
+                {
+                    m_mistakes << CompilationMistake
+                    {
+                        .Line = currentToken.GetLine(), .Position = currentToken.GetPosition(),
+                        .Code = ErrorCode::UnexpectedToken, .Extra = std::format("@{}", name.Str())
+                    };
+                }
+                inDirective = true;
                 break;
 
             case TokenType::LeftParenthesis:
+                operators.push(std::move(currentToken));
+                break;
             case TokenType::RightParenthesis:
+                failedStatement |= !CloseParenthesis(operators, currentToken, tokens);
+                break;
+
             case TokenType::EndOfCode:
             case TokenType::Comment:
                 break;
             }
 
+            if (type != TokenType::Comment)
+                lastType = type;
             currentToken = tokenizer.GetNextToken();
         }
 
         SaveTopSymbolTable("#");
+        m_scope = nullptr;
     }
 
     void StackedStyleParser::ParseFromFile(const std::filesystem::path& path)
     {
-        std::ifstream file(path, std::ios::in | std::ios::binary);
-        if (!file)
-            throw std::runtime_error(std::format("File not found: \"{}\"", path.string()));
-        const std::string code{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+        const SheetLoader::Source source { .Path = path };
+        Load({ &source, 1 }, Utils::ThreadPool::Default());
+    }
+
+    void StackedStyleParser::ParseFiles(const std::span<const std::filesystem::path> paths, Utils::ThreadPool& pool)
+    {
+        std::vector<SheetLoader::Source> sources;
+        sources.reserve(paths.size());
+        for (const auto& path : paths)
+            sources.push_back({ .Path = path });
+
+        Load(sources, pool);
+    }
+
+    void StackedStyleParser::ParseCodes(const std::span<const std::string> codes, Utils::ThreadPool& pool)
+    {
+        std::vector<SheetLoader::Source> sources;
+        sources.reserve(codes.size());
+        for (const auto& code : codes)
+            sources.push_back({ .Path = std::filesystem::current_path(), .Code = code });
 
-        file.close();
-        ParseFromCode(code);
+        Load(sources, pool);
+    }
+
+    void StackedStyleParser::Load(const std::span<const SheetLoader::Source> sources, Utils::ThreadPool& pool)
+    {
+        SheetLoader::Merge(m_loader.Load(sources, pool), m_variables, m_mistakes);
     }
 
     void StackedStyleParser::SetFromSymbolTables(const std::shared_ptr<SymbolTable>& symbolTable,
-                                                 const std::string& propName, const std::string& varName) const
+                                                 const std::string_view propName, const std::string_view varName,
+                                                 const bool helper) const
     {
         bool found = false;
-        for (const auto& st : m_symbolTables)
+        const auto copy = [&](const Variable* v)
         {
-            if (!st->HasVariable(varName))
+            if (!v)
             {
-                continue;
+                return;
             }
 
             found = true;
 
-            const auto v = st->GetVariable(varName);
             if (std::holds_alternative<Integer>(v->GetValue()))
-                symbolTable->SetVariable<Integer>(propName, v->CopyValue());
+                symbolTable->SetVariable<Integer>(propName, v->CopyValue(), helper);
             else if (std::holds_alternative<Float>(v->GetValue()))
-                symbolTable->SetVariable<Float>(propName, v->CopyValue());
-            else if (std::holds_alternative<std::string>(v->GetValue()))
-                symbolTable->SetVariable<char>(propName, v->CopyValue());
+                symbolTable->SetVariable<Float>(propName, v->CopyValue(), helper);
+            else if (std::holds_alternative<StringRef>(v->GetValue()))
+                symbolTable->SetVariable<StringRef>(propName, v->CopyValue(), helper);
             else if (std::holds_alternative<bool>(v->GetValue()))
-                symbolTable->SetVariable<bool>(propName, v->CopyValue());
-        }
+                symbolTable->SetVariable<bool>(propName, v->CopyValue(), helper);
+            else if (std::holds_alternative<Color>(v->GetValue()))
+                symbolTable->SetVariable<Color>(propName, v->CopyValue(), helper);
+        };
+
+        if (m_scope)
+            copy(m_scope->GetVariable(varName));
+        for (const auto& st : m_symbolTables)
+            copy(st->GetVariable(varName));
 
         if (!found)
         {
@@ -123,29 +257,30 @@ namespace Trema::Style
 
     std::optional<Value> StackedStyleParser::GetNextTokenValue(std::stack<Token>& tokens) const
     {
+        // Operands never come from before the statement
+        if (tokens.empty() || tokens.top().GetTokenType() == TokenType::LeftCurlyBracket)
+            return {};
+
         const auto token = std::move(tokens.top());
         tokens.pop();
 
         if (token.GetTokenType() == TokenType::Identifier)
         {
-            const auto variableName = std::get<std::string>(token.GetValue());
-            for (const auto& st : m_symbolTables)
+            const auto variableName = std::get<StringRef>(token.GetValue());
+            if (const auto variable = FindVariable(variableName))
             {
-                if (st->HasVariable(variableName))
-                {
-                    auto v = st->GetVariable(variableName)->GetValue();
-                    if (std::holds_alternative<Integer>(v))
-                        return v;
-                    if (std::holds_alternative<Float>(v))
-                        return v;
+                auto v = variable->GetValue();
+                if (std::holds_alternative<Integer>(v))
+                    return v;
+                if (std::holds_alternative<Float>(v))
+                    return v;
 
-                    m_mistakes << CompilationMistake
-                    {
-                        .Line = token.GetLine(), .Position = token.GetPosition(),
-                        .Code = ErrorCode::TypeMismatch, .Extra = std::string(variableName)
-                    };
-                    return {};
-                }
+                m_mistakes << CompilationMistake
+                {
+                    .Line = token.GetLine(), .Position = token.GetPosition(),
+                    .Code = ErrorCode::TypeMismatch, .Extra = variableName.Str()
+                };
+                return {};
             }
         }
         else if (token.GetTokenType() == TokenType::LiteralNumber || token.GetTokenType() ==
@@ -166,48 +301,101 @@ namespace Trema::Style
         return {};
     }
 
+    const Variable* StackedStyleParser::FindVariable(const std::string_view name) const
+    {
+        // The outer scope comes first, like the root table would
+        if (m_scope)
+        {
+            if (const auto variable = m_scope->GetVariable(name))
+                return variable;
+        }
+
+        for (const auto& st : m_symbolTables)
+        {
+            if (const auto variable = st->GetVariable(name))
+                return variable;
+        }
+
+        return nullptr;
+    }
+
+    bool StackedStyleParser::IsUnaryMinus(const Token& op, const TokenType lastType)
+    {
+        // The tokenizer already reads "-2" there as a literal; this covers "-(2 + 3)" and "-size"
+        return std::get<StringRef>(op.GetValue()) == "-" &&
+            (lastType == TokenType::PropertyAssignment || lastType == TokenType::VariableAssignment ||
+             lastType == TokenType::LeftParenthesis || lastType == TokenType::Operator);
+    }
+
+    bool StackedStyleParser::ApplyOperator(const Token& op, std::stack<Token>& tokens) const
+    {
+        const auto value1 = GetNextTokenValue(tokens);
+        const auto value2 = GetNextTokenValue(tokens);
+
+        if (!value1.has_value() || !value2.has_value())
+        {
+            m_mistakes << CompilationMistake
+            {
+                .Line = op.GetLine(), .Position = op.GetPosition(),
+                .Code = ErrorCode::UnexpectedToken,
+                .Extra = std::format("Missing value around {}", op.GetIdentity())
+            };
+            return false;
+        }
+
+        // Integer division and modulo (which truncates floats) are undefined by zero, for the smallest Integer by -1,
+        // and for floats out of the range of Integer
+        const auto name = std::get<StringRef>(op.GetValue());
+        const auto integral = name == "%" || (name == "/" && std::holds_alternative<Integer>(*value1) &&
+                                              std::holds_alternative<Integer>(*value2));
+        if (integral)
+        {
+            const auto dividend = ToIntegral(*value2);
+            const auto divisor = ToIntegral(*value1);
+            std::string problem;
+            if ((std::holds_alternative<Float>(*value2) && !dividend) || (std::holds_alternative<Float>(*value1) && !divisor))
+                problem = std::format("Operand of {} out of range", name.View());
+            else if (divisor == 0)
+                problem = "Division by zero";
+            else if (divisor == -1 && dividend == std::numeric_limits<Integer>::min())
+                problem = "Integer overflow";
+
+            if (!problem.empty())
+            {
+                m_mistakes << CompilationMistake
+                {
+                    .Line = op.GetLine(), .Position = op.GetPosition(),
+                    .Code = ErrorCode::UnexpectedToken, .Extra = std::move(problem)
+                };
+                return false;
+            }
+        }
+
+        const auto result = m_operationsTable.GetOperator(name.Str()).Operation(*value2, *value1);
+
+        if (std::holds_alternative<Float>(result))
+            tokens.emplace(TokenType::LiteralFloatNumber, op.GetPosition(), op.GetLine(), result);
+        else if (std::holds_alternative<Integer>(result))
+            tokens.emplace(TokenType::LiteralNumber, op.GetPosition(), op.GetLine(), result);
+        return true;
+    }
+
     bool StackedStyleParser::ProcessOperators(std::stack<Token>& operators,
                                               Token& currentOperator,
                                               std::stack<Token>& tokens) const
     {
-        while (!operators.empty())
+        const auto& op1 = m_operationsTable.GetOperator(std::get<StringRef>(currentOperator.GetValue()).Str());
+        while (!operators.empty() && operators.top().GetTokenType() == TokenType::Operator)
         {
-            const auto& operator2Token = operators.top();
-            const auto& op1 = m_operationsTable.GetOperator(std::get<std::string>(currentOperator.GetValue()));
-            const auto& op2 = m_operationsTable.GetOperator(std::get<std::string>(operator2Token.GetValue()));
+            const auto& op2 = m_operationsTable.GetOperator(std::get<StringRef>(operators.top().GetValue()).Str());
 
             if (op2.Priority > op1.Priority || (op2.Priority == op1.Priority && op2.IsLeftAssociative))
             {
+                const auto op = std::move(operators.top());
                 operators.pop();
 
-                const auto value1 = GetNextTokenValue(tokens);
-                const auto value2 = GetNextTokenValue(tokens);
-
-                if (!value1.has_value() || !value2.has_value())
-                {
-                    m_mistakes << CompilationMistake
-                    {
-                        .Line = currentOperator.GetLine(), .Position = currentOperator.GetPosition(),
-                        .Code = ErrorCode::UnexpectedToken,
-                        .Extra = std::format("Missing value around {}", currentOperator.GetIdentity())
-                    };
+                if (!ApplyOperator(op, tokens))
                     return false;
-                }
-
-                const auto result = op2.Operation(*value2, *value1);
-
-                if (std::holds_alternative<Float>(result))
-                {
-                    Token t(TokenType::LiteralFloatNumber, currentOperator.GetPosition(),
-                            currentOperator.GetLine(), result);
-                    tokens.push(std::move(t));
-                }
-                else if (std::holds_alternative<Integer>(result))
-                {
-                    Token t(TokenType::LiteralNumber, currentOperator.GetPosition(),
-                            currentOperator.GetLine(), result);
-                    tokens.push(std::move(t));
-                }
             }
             else
             {
@@ -219,6 +407,32 @@ namespace Trema::Style
         return true;
     }
 
+    bool StackedStyleParser::CloseParenthesis(std::stack<Token>& operators, const Token& parenthesis,
+                                              std::stack<Token>& tokens) const
+    {
+        while (!operators.empty() && operators.top().GetTokenType() == TokenType::Operator)
+        {
+            const auto op = std::move(operators.top());
+            operators.pop();
+
+            if (!ApplyOperator(op, tokens))
+                return false;
+        }
+
+        if (operators.empty())
+        {
+            m_mistakes << CompilationMistake
+            {
+                .Line = parenthesis.GetLine(), .Position = parenthesis.GetPosition(),
+                .Code = ErrorCode::UnexpectedToken, .Extra = ")"
+            };
+            return false;
+        }
+
+        operators.pop(); // remove '('
+        return true;
+    }
+
     bool StackedStyleParser::AssignVar(std::stack<Token>& tokens,
                                        std::stack<Token>& operators,
                                        const std::shared_ptr<SymbolTable>& currentSt) const
@@ -226,52 +440,33 @@ namespace Trema::Style
         // Shunting Yard
         while (!operators.empty())
         {
-            const auto operatorToken = std::move(operators.top());
+            const auto op = std::move(operators.top());
             operators.pop();
 
-            const auto value1 = GetNextTokenValue(tokens);
-            const auto value2 = GetNextTokenValue(tokens);
-
-            const auto& op2 = m_operationsTable.GetOperator(std::get<std::string>(operatorToken.GetValue()));
-
-            if (!value1.has_value() || !value2.has_value())
-            {
-                m_mistakes << CompilationMistake
-                {
-                    .Line = operatorToken.GetLine(), .Position = operatorToken.GetPosition(),
-                    .Code = ErrorCode::UnexpectedToken,
-                    .Extra = std::format("Missing value around {}", operatorToken.GetIdentity())
-                };
+            // An unclosed '('
+            if (op.GetTokenType() != TokenType::Operator || !ApplyOperator(op, tokens))
                 return false;
-            }
-
-            const auto result = op2.Operation(*value2, *value1);
-
-            if (std::holds_alternative<Float>(result))
-            {
-                Token t(TokenType::LiteralFloatNumber, operatorToken.GetPosition(),
-                        operatorToken.GetLine(), result);
-                tokens.push(std::move(t));
-            }
-            else if (std::holds_alternative<Integer>(result))
-            {
-                Token t(TokenType::LiteralNumber, operatorToken.GetPosition(),
-                        operatorToken.GetLine(), result);
-                tokens.push(std::move(t));
-            }
         }
 
-        //
-        if (tokens.size() < 3)
+        // Assign to variable; the tokens of the statement come after the '{' of its block
+        const auto next = [&tokens]() -> std::optional<Token>
+        {
+            if (tokens.empty() || tokens.top().GetTokenType() == TokenType::LeftCurlyBracket)
+                return std::nullopt;
+
+            auto token = std::move(tokens.top());
+            tokens.pop();
+            return token;
+        };
+        const auto valToken = next();
+        const auto assignerToken = next();
+        const auto propNameToken = next();
+        if (!valToken || !assignerToken || !propNameToken)
             return false;
 
-        // Assign to variable
-        auto val = std::move(tokens.top());
-        tokens.pop();
-        auto assigner = std::move(tokens.top());
-        tokens.pop();
-        auto propName = std::move(tokens.top());
-        tokens.pop();
+        const auto& val = *valToken;
+        const auto& assigner = *assignerToken;
+        const auto& propName = *propNameToken;
 
         if (propName.GetTokenType() == TokenType::Identifier &&
             (
@@ -279,72 +474,169 @@ namespace Trema::Style
                 val.GetTokenType() == TokenType::LiteralBool ||
                 val.GetTokenType() == TokenType::LiteralNumber ||
                 val.GetTokenType() == TokenType::LiteralFloatNumber ||
-                val.GetTokenType() == TokenType::LiteralString
+                val.GetTokenType() == TokenType::LiteralString ||
+                val.GetTokenType() == TokenType::LiteralColor
             ) &&
             (
                 assigner.GetTokenType() == TokenType::VariableAssignment ||
                 assigner.GetTokenType() == TokenType::PropertyAssignment)
         )
         {
+            // Both assigners store into the same table, where the slotted styles find schema properties
+            if (!MatchesSchema(propName, val))
+                return true;
+
+            const auto name = std::get<StringRef>(propName.GetValue());
+            const auto helper = assigner.GetTokenType() == TokenType::VariableAssignment;
             if (val.GetTokenType() == TokenType::LiteralBool)
-                currentSt->SetVariable<bool>(std::get<std::string>(propName.GetValue()), val.GetValue());
+                currentSt->SetVariable<bool>(name, val.GetValue(), helper);
             else if (val.GetTokenType() == TokenType::LiteralFloatNumber)
-                currentSt->SetVariable<Float>(std::get<std::string>(propName.GetValue()), val.GetValue());
+                currentSt->SetVariable<Float>(name, val.GetValue(), helper);
             else if (val.GetTokenType() == TokenType::LiteralNumber)
-                currentSt->SetVariable<Integer>(std::get<std::string>(propName.GetValue()), val.GetValue());
+                currentSt->SetVariable<Integer>(name, val.GetValue(), helper);
             else if (val.GetTokenType() == TokenType::LiteralString)
-                currentSt->SetVariable<std::string>(std::get<std::string>(propName.GetValue()), val.GetValue());
+                currentSt->SetVariable<StringRef>(name, val.GetValue(), helper);
+            else if (val.GetTokenType() == TokenType::LiteralColor)
+                currentSt->SetVariable<Color>(name, val.GetValue(), helper);
             else if (val.GetTokenType() == TokenType::Identifier)
-                SetFromSymbolTables(currentSt, std::get<std::string>(propName.GetValue()),
-                                    std::get<std::string>(val.GetValue()));
+                SetFromSymbolTables(currentSt, name, std::get<StringRef>(val.GetValue()), helper);
 
             return true;
         }
         return false;
     }
 
+    bool StackedStyleParser::MatchesSchema(const Token& propName, const Token& val) const
+    {
+        if (!m_schema)
+            return true;
+
+        const auto name = std::get<StringRef>(propName.GetValue());
+        const auto property = m_schema->Find(name.View());
+        if (!property)
+            return true;
+
+        // Copies are checked against the value SetFromSymbolTables takes: the last table defining the name
+        auto value = val.GetValue();
+        if (val.GetTokenType() == TokenType::Identifier)
+        {
+            const auto varName = std::get<StringRef>(value).View();
+            const Variable* source = m_scope ? m_scope->GetVariable(varName) : nullptr;
+            for (const auto& st : m_symbolTables)
+            {
+                if (const auto variable = st->GetVariable(varName))
+                    source = variable;
+            }
+
+            // Undefined names are reported by the assignment
+            if (!source)
+                return true;
+            value = source->GetValue();
+        }
+
+        if (PropertySchema::Accepts(property->Type, value))
+            return true;
+
+        m_mistakes << CompilationMistake
+        {
+            .Line = propName.GetLine(), .Position = propName.GetPosition(), .Code = ErrorCode::TypeMismatch,
+            .Extra = std::format("{} expects {}", name.View(), PropertySchema::GetTypeName(property->Type))
+        };
+        return false;
+    }
+
     void StackedStyleParser::AssignProps(std::stack<Token>& tokens,
                                          std::shared_ptr<SymbolTable>& currentSt)
     {
-        if (tokens.size() < 2)
+        // The root table must stay open
+        if (tokens.size() < 2 || m_symbolTables.size() < 2)
             throw std::runtime_error(R"(Unexpected symbol "}")");
 
         tokens.pop(); // remove '{'
 
-        // Getting identifier
-        const auto topToken = std::move(tokens.top());
-        tokens.pop();
-
-        std::stringstream ss;
-        if (topToken.GetTokenType() == TokenType::Identity)
+        std::vector<Token> pieces;
+        while (!tokens.empty() && IsSelectorPiece(tokens.top().GetTokenType()))
         {
-            ss << "#";
+            pieces.push_back(std::move(tokens.top()));
+            tokens.pop();
         }
-        else if (topToken.GetTokenType() == TokenType::Identifier)
+        std::ranges::reverse(pieces);
+
+        // Pieces written without blanks between them form one compound selector ("button.primary"), compounds
+        // separated by blanks select descendants ("#dialog .primary") and commas separate the selectors of a list
+        std::vector<std::string> names(1);
+        const auto emptyEntry = [this](const Token& comma)
         {
-            if (!tokens.empty() && tokens.top().GetTokenType() == TokenType::Identity)
+            m_mistakes << CompilationMistake
             {
-                ss << "#";
-                tokens.pop();
+                .Line = comma.GetLine(), .Position = comma.GetPosition(),
+                .Code = ErrorCode::UnexpectedToken, .Extra = ","
+            };
+        };
+
+        bool isList = false;
+        for (std::size_t i = 0; i < pieces.size(); ++i)
+        {
+            auto& name = names.back();
+            if (pieces[i].GetTokenType() == TokenType::Comma)
+            {
+                // Leading and doubled commas leave an empty entry, which is skipped
+                isList = true;
+                if (name.empty())
+                    emptyEntry(pieces[i]);
+                else
+                    names.emplace_back();
+                continue;
+            }
+
+            if (!name.empty() && (pieces[i].GetLine() != pieces[i - 1].GetLine() ||
+                GetColumns(pieces[i - 1]).second != GetColumns(pieces[i]).first))
+                name += ' ';
+
+            switch (pieces[i].GetTokenType())
+            {
+            case TokenType::Identity:
+                name += '#';
+                break;
+            case TokenType::Class:
+                name += '.';
+                break;
+            case TokenType::Universal:
+                name += '*';
+                break;
+            default:
+                name += std::get<StringRef>(pieces[i].GetValue()).View();
+                break;
             }
-            ss << std::get<std::string>(topToken.GetValue());
         }
 
-        SaveTopSymbolTable(ss.str());
+        if (isList && names.back().empty())
+        {
+            if (names.size() > 1)
+                emptyEntry(pieces.back()); // a trailing comma
+            names.pop_back();
+        }
+
+        SaveTopSymbolTable(names);
 
         currentSt = m_symbolTables.back();
     }
 
     void StackedStyleParser::SaveTopSymbolTable(std::string name)
     {
-        const auto topSymbolTable = m_symbolTables.back();
-        if (m_variables.contains(name))
-        {
-            m_variables[std::move(name)]->Append(*topSymbolTable);
-        }
-        else
+        SaveTopSymbolTable({ &name, 1 });
+    }
+
+    void StackedStyleParser::SaveTopSymbolTable(const std::span<std::string> names)
+    {
+        // The selectors of a list share the block instead of each getting a copy
+        const auto block = m_symbolTables.back();
+        for (auto& name : names)
         {
-            m_variables[std::move(name)] = topSymbolTable;
+            if (const auto it = m_variables.find(name); it != m_variables.end())
+                AppendBlock(it->second, *block);
+            else
+                m_variables.emplace(std::move(name), block);
         }
         m_symbolTables.pop_back();
     }
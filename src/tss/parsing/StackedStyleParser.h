@@ -2,11 +2,15 @@
 #include <stack>
 #include <memory>
 #include <filesystem>
+#include <span>
 #include <tss/parsing/StyleParser.h>
 #include <tss/errors/MistakesContainer.h>
 #include <tss/tokenization/Token.h>
 #include <tss/variables/OperationsTable.h>
 #include <tss/tokenization/ITokenizer.h>
+#include <tss/parsing/ParseCache.h>
+#include <tss/parsing/SheetLoader.h>
+#include <tss/utils/ThreadPool.h>
 
 namespace Trema
 {
@@ -19,22 +23,53 @@ namespace Trema
             StackedStyleParser(const StackedStyleParser&) = delete;
             StackedStyleParser& operator=(const StackedStyleParser&) = delete;
             ~StackedStyleParser() override = default;
+            // Code with @import directives resolves them relative to the working directory
             void ParseFromCode(const std::string &code) override;
+            // Parses code as if the variables of scope had been defined at the root before it; scope is only read
+            void ParseFromCode(const std::string &code, const std::shared_ptr<SymbolTable>& scope);
             void ParseFromFile(const std::filesystem::path &path) override;
+            // Files without imports then reuse the results of contents parsed before
+            void SetCache(std::shared_ptr<const ParseCache> cache) { m_loader.SetCache(std::move(cache)); }
+            void SetSchema(std::shared_ptr<const PropertySchema> schema) override
+            {
+                m_loader.SetSchema(schema);
+                StyleParser::SetSchema(std::move(schema));
+            }
+
+            // Parse every file (or buffer) and what it imports on the pool, then merge the results in contribution
+            // order: each file after its imports, and only once. If some fail, the results before the first failure
+            // are merged and its exception is rethrown.
+            void ParseFiles(std::span<const std::filesystem::path> paths,
+                            Utils::ThreadPool& pool = Utils::ThreadPool::Default());
+            void ParseCodes(std::span<const std::string> codes, Utils::ThreadPool& pool = Utils::ThreadPool::Default());
 
         private:
             std::unique_ptr<ITokenizer> m_tokenizer;
             unsigned int m_pos;
             OperationsTable m_operationsTable;
             MistakesContainer& m_mistakes;
+            std::shared_ptr<SymbolTable> m_scope;
+            std::uint32_t m_blocks { 0 }; // opened so far, numbering the blocks in source order
+            SheetLoader m_loader;
 
-            void SetFromSymbolTables(const std::shared_ptr<SymbolTable>& st, const std::string& propName, const std::string& varName) const;
+            void SetFromSymbolTables(const std::shared_ptr<SymbolTable>& st, std::string_view propName, std::string_view varName,
+                                     bool helper) const;
+            // A '-' with no left operand, read as 0 - x
+            [[nodiscard]] static bool IsUnaryMinus(const Token& op, TokenType lastType);
+            // Pops two operands and pushes the result; false (with a mistake) when an operand is missing or invalid
+            bool ApplyOperator(const Token& op, std::stack<Token>& tokens) const;
             bool ProcessOperators(std::stack<Token>& operators, Token& currentOperator, std::stack<Token>& tokens) const;
+            bool CloseParenthesis(std::stack<Token>& operators, const Token& parenthesis, std::stack<Token>& tokens) const;
             bool AssignVar(std::stack<Token>& tokens, std::stack<Token>& operators, const std::shared_ptr<SymbolTable>& currentSt) const;
+            // Reports values of the wrong type for properties of the schema
+            bool MatchesSchema(const Token& propName, const Token& val) const;
             void AssignProps(std::stack<Token>& tokens, std::shared_ptr<SymbolTable>& currentSt);
             void SaveTopSymbolTable(std::string name);
+            void SaveTopSymbolTable(std::span<std::string> names);
+            void Load(std::span<const SheetLoader::Source> sources, Utils::ThreadPool& pool);
 
             std::optional<Value> GetNextTokenValue(std::stack<Token> &tokens) const;
+            [[nodiscard]] const Variable* FindVariable(std::string_view name) const;
         };
     }
 }
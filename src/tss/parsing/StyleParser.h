@@ -2,8 +2,14 @@
 #include <deque>
 #include <filesystem>
 #include <memory>
+#include <optional>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <tss/sheets/SlottedStyles.h>
+#include <tss/sheets/StyleSheet.h>
+#include <tss/variables/PropertySchema.h>
 #include <tss/variables/SymbolTable.h>
 
 namespace Trema
@@ -17,11 +23,46 @@ namespace Trema
             virtual void ParseFromFile(const std::filesystem::path &path) = 0;
             virtual void ParseFromCode(const std::string& code) = 0;
 
+            // Values of the schema's properties are type checked while parsing; set it before parsing
+            virtual void SetSchema(std::shared_ptr<const PropertySchema> schema) { m_schema = std::move(schema); }
+            [[nodiscard]] const std::shared_ptr<const PropertySchema>& GetSchema() const { return m_schema; }
+
             void ClearVariables() { m_variables.clear(); }
-            [[nodiscard]] const std::unordered_map<std::string, std::shared_ptr<SymbolTable>>& GetVariables() { return m_variables; };
+            [[nodiscard]] const SelectorMap& GetVariables() const { return m_variables; };
+
+            // Allocation-free lookups by any string-like key; results borrow from this parser's tables
+            [[nodiscard]] const SymbolTable* FindSelector(const std::string_view selector) const noexcept
+            {
+                const auto it = m_variables.find(selector);
+                return it != m_variables.end() ? it->second.get() : nullptr;
+            }
+
+            [[nodiscard]] const Value* FindValue(const std::string_view selector, const std::string_view property) const noexcept
+            {
+                const auto table = FindSelector(selector);
+                return table ? table->FindValue(property) : nullptr;
+            }
+
+            template<typename T>
+            [[nodiscard]] std::optional<T> TryGet(const std::string_view selector, const std::string_view property) const noexcept
+            {
+                return Style::TryGet<T>(FindValue(selector, property));
+            }
+            // Builds a read-only perfect-hash index over the current results
+            [[nodiscard]] FrozenStyleIndex Freeze() const { return FrozenStyleIndex::Build(m_variables); }
+            // Immutable snapshot of the current results, independent of this parser
+            [[nodiscard]] StyleSheet BuildStyleSheet() const { return StyleSheet(Freeze()); }
+            // Current results with the schema's properties in fixed slots; throws when no schema is set
+            [[nodiscard]] SlottedStyles BuildSlottedStyles() const
+            {
+                if (!m_schema)
+                    throw std::logic_error("No property schema was set");
+                return { m_schema, m_variables };
+            }
 
         protected:
-            std::unordered_map<std::string, std::shared_ptr<SymbolTable>> m_variables;
+            SelectorMap m_variables;
+            std::shared_ptr<const PropertySchema> m_schema;
             std::deque<std::shared_ptr<SymbolTable>> m_symbolTables;
         };
     }
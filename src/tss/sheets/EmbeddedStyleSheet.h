@@ -0,0 +1,500 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+#include <tss/tokenization/TokenValue.h>
+
+// Compile-time parsing of sheets embedded in the binary:
+//
+//     constexpr auto Defaults = Trema::Style::Embedded::Parse<"#button { width: 10 * 2; }">();
+//     static_assert(Defaults.Find("#button", "width")->AsInteger() == 20);
+//
+// The result is a sorted constant table: lookups neither parse nor allocate. A sheet that doesn't parse, or uses an
+// undefined variable or an invalid operation, is a compile error pointing at the throw in this file that rejected it.
+// Semantics follow StackedStyleParser: later definitions win, block variables are saved under their selector, root
+// variables under "#", and numbers without a fractional part are integers.
+namespace Trema::Style::Embedded
+{
+    template<std::size_t N>
+    struct Source
+    {
+        char Data[N] { };
+
+        consteval Source(const char (&code)[N]) { std::copy_n(code, N, Data); }
+        [[nodiscard]] constexpr std::string_view View() const { return { Data, N - 1 }; }
+    };
+
+    enum class Kind : std::uint8_t
+    {
+        Integer,
+        Float,
+        Bool,
+        String,
+        Color
+    };
+
+    struct Value
+    {
+        Kind Type { Kind::Integer };
+        Integer IntegerValue { 0 };
+        Float FloatValue { 0 };
+        bool BoolValue { false };
+        std::string_view StringValue;
+
+        // Colours also read as their packed 0xRRGGBBAA integer
+        [[nodiscard]] constexpr Integer AsInteger() const { return IntegerValue; }
+        [[nodiscard]] constexpr Float AsFloat() const { return Type == Kind::Float ? FloatValue : static_cast<Float>(IntegerValue); }
+        [[nodiscard]] constexpr bool AsBool() const { return BoolValue; }
+        [[nodiscard]] constexpr std::string_view AsString() const { return StringValue; }
+        [[nodiscard]] constexpr Style::Color AsColor() const { return { static_cast<std::uint32_t>(IntegerValue) }; }
+
+        // Runtime value, as the parser would have produced it
+        [[nodiscard]] Style::Value ToValue() const
+        {
+            switch (Type)
+            {
+            case Kind::Integer: return IntegerValue;
+            case Kind::Float: return FloatValue;
+            case Kind::Bool: return BoolValue;
+            case Kind::String: return StringRef(StringValue);
+            case Kind::Color: return AsColor();
+            }
+            return std::nullopt;
+        }
+    };
+
+    struct Property
+    {
+        std::string_view Selector;  // without its '#'
+        bool Identity { false };    // the selector started with '#'
+        std::string_view Name;
+        Value Val;
+    };
+
+    namespace Detail
+    {
+        struct Key
+        {
+            bool Identity;
+            std::string_view Selector;
+            std::string_view Name;
+
+            constexpr auto operator<=>(const Key&) const = default;
+        };
+
+        constexpr Key KeyOf(const Property& property) { return { property.Identity, property.Selector, property.Name }; }
+
+        constexpr Key KeyOf(const std::string_view selector, const std::string_view name)
+        {
+            if (selector.starts_with('#'))
+                return { true, selector.substr(1), name };
+            return { false, selector, name };
+        }
+
+        // Same character classes as EndToEndTokenizer
+        constexpr bool IsIdentifierChar(const char c)
+        {
+            constexpr std::string_view excluded = ".'\n\":;()[]{}=#*/ \t\r";
+            return c != '\0' && excluded.find(c) == std::string_view::npos;
+        }
+
+        constexpr bool IsIdentifierStart(const char c)
+        {
+            return IsIdentifierChar(c) && c != '-' && c != '+' && c != '%' && (c < '0' || c > '9');
+        }
+
+        constexpr bool IsDigit(const char c) { return c >= '0' && c <= '9'; }
+
+        // Converting a float out of the range of Integer is undefined, as it is in EndToEndTokenizer and the parser
+        constexpr bool FitsInteger(const Float value)
+        {
+            return value >= -9223372036854775808.0 && value < 9223372036854775808.0;
+        }
+
+        class Parser
+        {
+        public:
+            explicit constexpr Parser(const std::string_view code) : m_code(code) { }
+
+            // Properties in the order their tables are saved: blocks when they close, the root last
+            constexpr std::vector<Property> Run()
+            {
+                m_scopes.push_back({ .Selector = { }, .Identity = true, .Begin = 0 });
+                while (SkipBlanks(), m_pos < m_code.size())
+                    ParseItem();
+
+                if (m_scopes.size() > 1)
+                    throw std::invalid_argument("Unclosed block");
+                CloseScope();
+                return std::move(m_saved);
+            }
+
+        private:
+            struct Scope
+            {
+                std::string_view Selector;
+                bool Identity { false };
+                std::size_t Begin { 0 };    // first variable of the scope in m_variables
+            };
+
+            std::string_view m_code;
+            std::size_t m_pos { 0 };
+            std::vector<Scope> m_scopes;
+            std::vector<Property> m_variables;  // variables of the open scopes, innermost last
+            std::vector<Property> m_saved;
+
+            constexpr void SkipBlanks()
+            {
+                while (m_pos < m_code.size())
+                {
+                    if (const char c = m_code[m_pos]; c == ' ' || c == '\t' || c == '\n' || c == '\r')
+                    {
+                        ++m_pos;
+                    }
+                    else if (m_code.substr(m_pos).starts_with("/*"))
+                    {
+                        // Scanned by hand: GCC doesn't accept searching for a multi-character string_view in a
+                        // template argument as a constant expression under -fsanitize=undefined (single characters,
+                        // as in IsIdentifierChar and ParsePrimary, are fine)
+                        auto end = m_pos + 2;
+                        while (end < m_code.size() && !m_code.substr(end).starts_with("*/"))
+                            ++end;
+                        if (end == m_code.size())
+                            throw std::invalid_argument("Unfinished comment");
+                        m_pos = end + 2;
+                    }
+                    else
+                    {
+                        break;
+                    }
+                }
+            }
+
+            [[nodiscard]] constexpr char Peek()
+            {
+                SkipBlanks();
+                return m_pos < m_code.size() ? m_code[m_pos] : '\0';
+            }
+
+            constexpr void Expect(const char c)
+            {
+                if (Peek() != c)
+                    throw std::invalid_argument("Unexpected token");
+                ++m_pos;
+            }
+
+            constexpr std::string_view ParseName()
+            {
+                SkipBlanks();
+                if (m_pos >= m_code.size() || !IsIdentifierStart(m_code[m_pos]))
+                    throw std::invalid_argument("Expected an identifier");
+
+                const auto begin = m_pos;
+                while (m_pos < m_code.size() && IsIdentifierChar(m_code[m_pos]))
+                    ++m_pos;
+                return m_code.substr(begin, m_pos - begin);
+            }
+
+            constexpr void ParseItem()
+            {
+                const char c = Peek();
+                if (c == ';')
+                {
+                    ++m_pos;
+                    return;
+                }
+                if (c == '}')
+                {
+                    if (m_scopes.size() < 2)
+                        throw std::invalid_argument(R"(Unexpected symbol "}")");
+                    ++m_pos;
+                    CloseScope();
+                    return;
+                }
+                if (c == '#')
+                {
+                    ++m_pos;
+                    const auto selector = Peek() == '{' ? std::string_view { } : ParseName();
+                    OpenScope(selector, true);
+                    return;
+                }
+
+                const auto name = ParseName();
+                const char next = Peek();
+                if (next == '{')
+                {
+                    OpenScope(name, false);
+                    return;
+                }
+                if (next != ':' && next != '=')
+                    throw std::invalid_argument("Expected ':', '=' or '{' after an identifier");
+
+                ++m_pos;
+                const auto value = ParseExpression();
+                Expect(';');
+                Assign(name, value);
+            }
+
+            constexpr void OpenScope(const std::string_view selector, const bool identity)
+            {
+                Expect('{');
+                m_scopes.push_back({ .Selector = selector, .Identity = identity, .Begin = m_variables.size() });
+            }
+
+            constexpr void CloseScope()
+            {
+                const auto scope = m_scopes.back();
+                m_scopes.pop_back();
+                for (auto i = scope.Begin; i < m_variables.size(); ++i)
+                {
+                    auto property = m_variables[i];
+                    property.Selector = scope.Selector;
+                    property.Identity = scope.Identity;
+                    m_saved.push_back(property);
+                }
+                m_variables.resize(scope.Begin);
+            }
+
+            constexpr void Assign(const std::string_view name, const Value& value)
+            {
+                for (auto i = m_scopes.back().Begin; i < m_variables.size(); ++i)
+                {
+                    if (m_variables[i].Name == name)
+                    {
+                        m_variables[i].Val = value;
+                        return;
+                    }
+                }
+                m_variables.push_back({ .Name = name, .Val = value });
+            }
+
+            [[nodiscard]] constexpr Value Lookup(const std::string_view name) const
+            {
+                for (auto it = m_variables.rbegin(); it != m_variables.rend(); ++it)
+                {
+                    if (it->Name == name)
+                        return it->Val;
+                }
+                throw std::invalid_argument("Undefined symbol");
+            }
+
+            constexpr Value ParseExpression()
+            {
+                auto value = ParseTerm();
+                while (Peek() == '+' || Peek() == '-')
+                {
+                    const char op = m_code[m_pos++];
+                    value = Apply(op, value, ParseTerm());
+                }
+                return value;
+            }
+
+            constexpr Value ParseTerm()
+            {
+                auto value = ParseUnary();
+                while (Peek() == '*' || Peek() == '/' || Peek() == '%')
+                {
+                    const char op = m_code[m_pos++];
+                    value = Apply(op, value, ParseUnary());
+                }
+                return value;
+            }
+
+            constexpr Value ParseUnary()
+            {
+                if (Peek() == '-')
+                {
+                    ++m_pos;
+                    return Apply('-', Value { }, ParseUnary());
+                }
+                return ParsePrimary();
+            }
+
+            constexpr Value ParsePrimary()
+            {
+                const char c = Peek();
+                if (c == '(')
+                {
+                    ++m_pos;
+                    const auto value = ParseExpression();
+                    Expect(')');
+                    return value;
+                }
+                if (c == '"' || c == '\'')
+                {
+                    const auto end = m_code.find_first_of(std::string_view { c == '"' ? "\"\n" : "'\n" }, m_pos + 1);
+                    if (end == std::string_view::npos || m_code[end] != c)
+                        throw std::invalid_argument("Unfinished string");
+
+                    const auto value = m_code.substr(m_pos + 1, end - m_pos - 1);
+                    m_pos = end + 1;
+                    return { .Type = Kind::String, .StringValue = value };
+                }
+                if (IsDigit(c) || (c == '.' && m_pos + 1 < m_code.size() && IsDigit(m_code[m_pos + 1])))
+                    return ParseNumber();
+
+                const auto name = ParseName();
+                if (name == "true" || name == "false")
+                    return { .Type = Kind::Bool, .BoolValue = name == "true" };
+                return Lookup(name);
+            }
+
+            constexpr Value ParseNumber()
+            {
+                if (m_code.substr(m_pos).starts_with("0x") || m_code.substr(m_pos).starts_with("0X"))
+                {
+                    m_pos += 2;
+                    Integer value = 0;
+                    std::size_t digits = 0;
+                    for (; m_pos < m_code.size(); ++m_pos, ++digits)
+                    {
+                        const char c = m_code[m_pos];
+                        const int digit = IsDigit(c) ? c - '0' :
+                                          c >= 'a' && c <= 'f' ? c - 'a' + 10 :
+                                          c >= 'A' && c <= 'F' ? c - 'A' + 10 : -1;
+                        if (digit < 0)
+                            break;
+                        value = value * 16 + digit;
+                    }
+                    if (digits == 0)
+                        throw std::invalid_argument("Invalid hexadecimal number");
+                    // Like the runtime tokenizer, eight digits make a 0xRRGGBBAA colour
+                    return { .Type = digits == 8 ? Kind::Color : Kind::Integer, .IntegerValue = value };
+                }
+
+                Float mantissa = 0;
+                Integer integral = 0;
+                int scale = 0;
+                bool fractional = false;
+                for (; m_pos < m_code.size() && IsDigit(m_code[m_pos]); ++m_pos)
+                {
+                    mantissa = mantissa * 10 + (m_code[m_pos] - '0');
+                    integral = integral * 10 + (m_code[m_pos] - '0');
+                }
+                if (m_pos < m_code.size() && m_code[m_pos] == '.')
+                {
+                    for (++m_pos; m_pos < m_code.size() && IsDigit(m_code[m_pos]); ++m_pos)
+                    {
+                        mantissa = mantissa * 10 + (m_code[m_pos] - '0');
+                        --scale;
+                        fractional = fractional || m_code[m_pos] != '0';
+                    }
+                }
+                if (m_pos < m_code.size() && (m_code[m_pos] == 'e' || m_code[m_pos] == 'E'))
+                {
+                    ++m_pos;
+                    const bool negative = m_pos < m_code.size() && m_code[m_pos] == '-';
+                    if (m_pos < m_code.size() && (m_code[m_pos] == '-' || m_code[m_pos] == '+'))
+                        ++m_pos;
+                    int exponent = 0;
+                    for (; m_pos < m_code.size() && IsDigit(m_code[m_pos]); ++m_pos)
+                        exponent = exponent * 10 + (m_code[m_pos] - '0');
+                    scale += negative ? -exponent : exponent;
+                    fractional = true; // decided from the value below
+                }
+
+                auto value = mantissa;
+                for (; scale > 0; --scale)
+                    value *= 10;
+                for (; scale < 0; ++scale)
+                    value /= 10;
+
+                if (!fractional)
+                    return { .Type = Kind::Integer, .IntegerValue = integral };
+                if (FitsInteger(value) && value == static_cast<Float>(static_cast<Integer>(value)))
+                    return { .Type = Kind::Integer, .IntegerValue = static_cast<Integer>(value) };
+                return { .Type = Kind::Float, .FloatValue = value };
+            }
+
+            static constexpr Value Apply(const char op, const Value& a, const Value& b)
+            {
+                if ((a.Type != Kind::Integer && a.Type != Kind::Float) || (b.Type != Kind::Integer && b.Type != Kind::Float))
+                    throw std::invalid_argument("Unsupported operand types");
+
+                if (op == '%')
+                {
+                    if ((b.Type == Kind::Float && !FitsInteger(b.FloatValue)) ||
+                        (a.Type == Kind::Float && !FitsInteger(a.FloatValue)))
+                        throw std::invalid_argument("Operand of % out of range");
+                    const auto divisor = b.Type == Kind::Float ? static_cast<Integer>(b.FloatValue) : b.IntegerValue;
+                    const auto dividend = a.Type == Kind::Float ? static_cast<Integer>(a.FloatValue) : a.IntegerValue;
+                    if (divisor == 0)
+                        throw std::invalid_argument("Division by zero");
+                    if (divisor == -1 && dividend == std::numeric_limits<Integer>::min())
+                        throw std::invalid_argument("Integer overflow");
+                    return { .Type = Kind::Integer, .IntegerValue = dividend % divisor };
+                }
+
+                if (a.Type == Kind::Integer && b.Type == Kind::Integer)
+                {
+                    if (op == '/' && b.IntegerValue == 0)
+                        throw std::invalid_argument("Division by zero");
+                    if (op == '/' && b.IntegerValue == -1 && a.IntegerValue == std::numeric_limits<Integer>::min())
+                        throw std::invalid_argument("Integer overflow");
+
+                    const auto x = a.IntegerValue;
+                    const auto y = b.IntegerValue;
+                    return { .Type = Kind::Integer, .IntegerValue = op == '+' ? x + y : op == '-' ? x - y : op == '*' ? x * y : x / y };
+                }
+
+                const auto x = a.AsFloat();
+                const auto y = b.AsFloat();
+                return { .Type = Kind::Float, .FloatValue = op == '+' ? x + y : op == '-' ? x - y : op == '*' ? x * y : x / y };
+            }
+        };
+
+        // Last definition of every property, sorted by key
+        constexpr std::vector<Property> Compile(const std::string_view code)
+        {
+            auto saved = Parser(code).Run();
+            std::vector<Property> properties;
+            for (auto it = saved.rbegin(); it != saved.rend(); ++it)
+            {
+                if (std::ranges::none_of(properties, [&](const Property& p) { return KeyOf(p) == KeyOf(*it); }))
+                    properties.push_back(*it);
+            }
+            std::ranges::sort(properties, [](const Property& a, const Property& b) { return KeyOf(a) < KeyOf(b); });
+            return properties;
+        }
+    }
+
+    template<std::size_t N>
+    struct StyleTable
+    {
+        std::array<Property, N> Properties;    // sorted by selector, then name
+
+        [[nodiscard]] constexpr std::optional<Value> Find(const std::string_view selector,
+                                                          const std::string_view property) const
+        {
+            const auto key = Detail::KeyOf(selector, property);
+            const auto it = std::ranges::lower_bound(Properties, key, { }, [](const Property& p) { return Detail::KeyOf(p); });
+            if (it == Properties.end() || Detail::KeyOf(*it) != key)
+                return std::nullopt;
+            return it->Val;
+        }
+
+        [[nodiscard]] constexpr bool HasSelector(const std::string_view selector) const
+        {
+            const auto key = Detail::KeyOf(selector, { });
+            const auto it = std::ranges::lower_bound(Properties, key, { }, [](const Property& p) { return Detail::KeyOf(p); });
+            return it != Properties.end() && it->Identity == key.Identity && it->Selector == key.Selector;
+        }
+
+        [[nodiscard]] static constexpr std::size_t Size() { return N; }
+    };
+
+    template<Source Code>
+    consteval auto Parse()
+    {
+        constexpr auto size = Detail::Compile(Code.View()).size();
+        StyleTable<size> table { };
+        std::ranges::copy(Detail::Compile(Code.View()), table.Properties.begin());
+        return table;
+    }
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+namespace Trema::Style::Format
+{
+    // Layout of a frozen style index image. Every reference is an offset from the start of the image (or of
+    // the string section), so an image can be written to disk and used again straight from a mapping.
+    // Sections are 8-byte aligned and numbers are stored in native byte order; an image from a machine with the
+    // other byte order is rejected by the version check.
+
+    constexpr char Magic[4] = { 'T', 'S', 'S', 'I' };
+
+    struct Header
+    {
+        char Magic[4];
+        std::uint32_t Version;
+        std::uint32_t SelectorCount;
+        std::uint32_t SelectorBucketCount;
+        std::uint32_t PropertyCount;
+        std::uint32_t PropertyBucketCount;
+        std::uint64_t SelectorSeeds;  // uint32_t[SelectorBucketCount]
+        std::uint64_t Selectors;      // SelectorRecord[SelectorCount], in perfect hash slot order
+        std::uint64_t PropertySeeds;  // uint32_t[PropertyBucketCount]
+        std::uint64_t Properties;     // PropertyRecord[PropertyCount], in perfect hash slot order
+        std::uint64_t PropertyList;   // uint32_t[PropertyCount], property slots grouped by selector
+        std::uint64_t Values;         // StoredValue[ValueCount], each distinct value once
+        std::uint64_t Strings;        // string records: uint32_t length, characters, '\0', padded to 4 bytes, each
+                                      // distinct string once
+        std::uint64_t StringsSize;
+        std::uint64_t ImageSize;
+        std::uint32_t ValueCount;
+        std::uint32_t Reserved;
+    };
+
+    enum class ValueType : std::uint32_t
+    {
+        Float = 0,
+        Integer = 1,
+        Bool = 2,
+        String = 3,
+        Null = 4,
+        Color = 5,
+    };
+
+    struct StoredValue
+    {
+        ValueType Type;
+        std::uint32_t String; // string record offset
+        std::uint64_t Bits;   // Float bits, Integer, bool or packed colour
+    };
+
+    struct SelectorRecord
+    {
+        std::uint64_t Hash;
+        std::uint32_t Name;          // string record offset
+        std::uint32_t FirstProperty; // index in the property list
+        std::uint32_t PropertyCount;
+        std::uint32_t Order;         // of the selector's first block, see SymbolTable::GetOrder
+    };
+
+    struct PropertyRecord
+    {
+        std::uint64_t Hash; // selector and property name hashes combined
+        std::uint32_t Selector;
+        std::uint32_t Name;
+        std::uint32_t Value; // index in the value section
+        std::uint32_t Reserved;
+    };
+
+    static_assert(std::is_trivially_copyable_v<Header> && sizeof(Header) == 104);
+    static_assert(sizeof(StoredValue) == 16);
+    static_assert(sizeof(SelectorRecord) == 24);
+    static_assert(sizeof(PropertyRecord) == 24);
+}
@@ -0,0 +1,380 @@
+#include <tss/sheets/FrozenStyleIndex.h>
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+#include <tss/sheets/ValuePool.h>
+#include <tss/utils/Hashing.h>
+#include <tss/utils/MappedFile.h>
+#include <tss/utils/PerfectHash.h>
+
+namespace Trema::Style
+{
+    namespace
+    {
+        constexpr std::uint64_t Align(const std::uint64_t offset)
+        {
+            return (offset + 7) & ~std::uint64_t { 7 };
+        }
+
+        template<typename T>
+        void CopySection(std::vector<std::byte>& image, const std::uint64_t offset, const std::vector<T>& section)
+        {
+            if (!section.empty())
+                std::memcpy(image.data() + offset, section.data(), section.size() * sizeof(T));
+        }
+    }
+
+    FrozenStyleIndex::FrozenStyleIndex() :
+        FrozenStyleIndex(Build({}))
+    {
+    }
+
+    FrozenStyleIndex::FrozenStyleIndex(std::shared_ptr<const std::byte> storage, const std::size_t size) :
+        m_image(std::move(storage)),
+        m_size(size)
+    {
+        const auto base = m_image.get();
+        m_header = reinterpret_cast<const Format::Header*>(base);
+        m_selectorSeeds = reinterpret_cast<const std::uint32_t*>(base + m_header->SelectorSeeds);
+        m_selectors = reinterpret_cast<const Format::SelectorRecord*>(base + m_header->Selectors);
+        m_propertySeeds = reinterpret_cast<const std::uint32_t*>(base + m_header->PropertySeeds);
+        m_properties = reinterpret_cast<const Format::PropertyRecord*>(base + m_header->Properties);
+        m_propertyList = reinterpret_cast<const std::uint32_t*>(base + m_header->PropertyList);
+        m_values = reinterpret_cast<const Format::StoredValue*>(base + m_header->Values);
+        m_strings = reinterpret_cast<const char*>(base + m_header->Strings);
+    }
+
+    FrozenStyleIndex FrozenStyleIndex::Build(const SelectorMap& selectors)
+    {
+        struct PendingProperty
+        {
+            StringRef Name;
+            Value Contents;
+        };
+
+        struct PendingSelector
+        {
+            std::string_view Name;
+            std::uint32_t Order;
+            std::vector<PendingProperty> Properties;
+        };
+
+        // Sorting makes images reproducible for a given parse result
+        std::vector<PendingSelector> pending;
+        pending.reserve(selectors.size());
+        for (const auto& [name, table] : selectors)
+        {
+            auto& selector = pending.emplace_back(PendingSelector { name, table ? table->GetOrder() : 0, {} });
+            if (!table)
+                continue;
+
+            for (const auto& [property, variable] : *table)
+                selector.Properties.push_back({ property, variable.GetValue() });
+
+            std::ranges::sort(selector.Properties, {}, [](const auto& p) { return p.Name.View(); });
+        }
+        std::ranges::sort(pending, {}, &PendingSelector::Name);
+
+        std::vector<std::uint64_t> selectorHashes;
+        std::vector<std::uint64_t> propertyHashes;
+        selectorHashes.reserve(pending.size());
+        for (const auto& selector : pending)
+        {
+            selectorHashes.push_back(Utils::Hash(selector.Name));
+            for (const auto& property : selector.Properties)
+                propertyHashes.push_back(Utils::CombineHashes(selectorHashes.back(), Utils::Hash(property.Name.View())));
+        }
+
+        const auto selectorSeeds = Utils::PerfectHash::Build(selectorHashes);
+        const auto propertySeeds = Utils::PerfectHash::Build(propertyHashes);
+        const auto selectorCount = static_cast<std::uint32_t>(selectorHashes.size());
+        const auto propertyCount = static_cast<std::uint32_t>(propertyHashes.size());
+
+        ValuePool pool;
+        std::vector<Format::SelectorRecord> selectorRecords(selectorCount);
+        std::vector<Format::PropertyRecord> propertyRecords(propertyCount);
+        std::vector<std::uint32_t> propertyList;
+        propertyList.reserve(propertyCount);
+
+        std::size_t propertyIndex = 0;
+        for (std::size_t i = 0; i < pending.size(); ++i)
+        {
+            const auto selectorSlot = Utils::PerfectHash::Lookup(selectorHashes[i], selectorSeeds.data(),
+                                                                 static_cast<std::uint32_t>(selectorSeeds.size()),
+                                                                 selectorCount);
+            selectorRecords[selectorSlot] = Format::SelectorRecord
+            {
+                .Hash = selectorHashes[i],
+                .Name = pool.AddString(pending[i].Name),
+                .FirstProperty = static_cast<std::uint32_t>(propertyList.size()),
+                .PropertyCount = static_cast<std::uint32_t>(pending[i].Properties.size()),
+                .Order = pending[i].Order
+            };
+
+            for (const auto& property : pending[i].Properties)
+            {
+                const auto hash = propertyHashes[propertyIndex++];
+                const auto slot = Utils::PerfectHash::Lookup(hash, propertySeeds.data(),
+                                                             static_cast<std::uint32_t>(propertySeeds.size()),
+                                                             propertyCount);
+                propertyRecords[slot] = Format::PropertyRecord
+                {
+                    .Hash = hash,
+                    .Selector = selectorSlot,
+                    .Name = pool.AddString(property.Name.View()),
+                    .Value = pool.Add(property.Contents),
+                    .Reserved = 0
+                };
+                propertyList.push_back(slot);
+            }
+        }
+
+        Format::Header header { };
+        std::memcpy(header.Magic, Format::Magic, sizeof(header.Magic));
+        header.Version = FormatVersion;
+        header.SelectorCount = selectorCount;
+        header.SelectorBucketCount = static_cast<std::uint32_t>(selectorSeeds.size());
+        header.PropertyCount = propertyCount;
+        header.PropertyBucketCount = static_cast<std::uint32_t>(propertySeeds.size());
+        header.SelectorSeeds = Align(sizeof(Format::Header));
+        header.Selectors = Align(header.SelectorSeeds + selectorSeeds.size() * sizeof(std::uint32_t));
+        header.PropertySeeds = Align(header.Selectors + selectorRecords.size() * sizeof(Format::SelectorRecord));
+        header.Properties = Align(header.PropertySeeds + propertySeeds.size() * sizeof(std::uint32_t));
+        header.PropertyList = Align(header.Properties + propertyRecords.size() * sizeof(Format::PropertyRecord));
+        header.Values = Align(header.PropertyList + propertyList.size() * sizeof(std::uint32_t));
+        header.ValueCount = static_cast<std::uint32_t>(pool.GetValues().size());
+        header.Strings = Align(header.Values + pool.GetValues().size() * sizeof(Format::StoredValue));
+        header.StringsSize = pool.GetStrings().size();
+        header.ImageSize = Align(header.Strings + header.StringsSize);
+
+        auto image = std::make_shared<std::vector<std::byte>>(header.ImageSize, std::byte { 0 });
+        std::memcpy(image->data(), &header, sizeof(header));
+        CopySection(*image, header.SelectorSeeds, selectorSeeds);
+        CopySection(*image, header.Selectors, selectorRecords);
+        CopySection(*image, header.PropertySeeds, propertySeeds);
+        CopySection(*image, header.Properties, propertyRecords);
+        CopySection(*image, header.PropertyList, propertyList);
+        CopySection(*image, header.Values, pool.GetValues());
+        CopySection(*image, header.Strings, pool.GetStrings());
+
+        const auto size = image->size();
+        return { std::shared_ptr<const std::byte>(image, image->data()), size };
+    }
+
+    FrozenStyleIndex FrozenStyleIndex::FromImage(std::shared_ptr<const std::byte> storage, const std::size_t size)
+    {
+        if (!storage || size < sizeof(Format::Header))
+            throw std::runtime_error("Invalid style image: truncated header");
+
+        Format::Header header;
+        std::memcpy(&header, storage.get(), sizeof(header));
+        if (std::memcmp(header.Magic, Format::Magic, sizeof(header.Magic)) != 0)
+            throw std::runtime_error("Invalid style image: bad magic");
+        if (header.Version != FormatVersion)
+            throw std::runtime_error("Invalid style image: unsupported version " + std::to_string(header.Version));
+        if (header.ImageSize > size)
+            throw std::runtime_error("Invalid style image: truncated");
+
+        const auto checkSection = [&header](const std::uint64_t offset, const std::uint64_t count, const std::uint64_t itemSize)
+        {
+            if (offset % 8 != 0 || offset > header.ImageSize || count > (header.ImageSize - offset) / itemSize)
+                throw std::runtime_error("Invalid style image: section out of bounds");
+        };
+        checkSection(header.SelectorSeeds, header.SelectorBucketCount, sizeof(std::uint32_t));
+        checkSection(header.Selectors, header.SelectorCount, sizeof(Format::SelectorRecord));
+        checkSection(header.PropertySeeds, header.PropertyBucketCount, sizeof(std::uint32_t));
+        checkSection(header.Properties, header.PropertyCount, sizeof(Format::PropertyRecord));
+        checkSection(header.PropertyList, header.PropertyCount, sizeof(std::uint32_t));
+        checkSection(header.Values, header.ValueCount, sizeof(Format::StoredValue));
+        checkSection(header.Strings, header.StringsSize, 1);
+        if (header.SelectorBucketCount != Utils::PerfectHash::BucketCountFor(header.SelectorCount) ||
+            header.PropertyBucketCount != Utils::PerfectHash::BucketCountFor(header.PropertyCount))
+            throw std::runtime_error("Invalid style image: bad bucket count");
+
+        // Lookups index records with the slots stored in the image, so these are checked once here
+        const auto base = reinterpret_cast<const std::uint8_t*>(storage.get());
+        const auto propertyList = reinterpret_cast<const std::uint32_t*>(base + header.PropertyList);
+        const auto properties = reinterpret_cast<const Format::PropertyRecord*>(base + header.Properties);
+        for (std::uint32_t i = 0; i < header.PropertyCount; ++i)
+        {
+            if (propertyList[i] >= header.PropertyCount || properties[i].Selector >= header.SelectorCount)
+                throw std::runtime_error("Invalid style image: slot out of bounds");
+        }
+
+        return { std::move(storage), static_cast<std::size_t>(header.ImageSize) };
+    }
+
+    FrozenStyleIndex FrozenStyleIndex::Load(const std::filesystem::path& path)
+    {
+        auto file = Utils::MappedFile::Open(path);
+        return FromImage(std::move(file.Data), file.Size);
+    }
+
+    void FrozenStyleIndex::Save(const std::filesystem::path& path) const
+    {
+        Utils::WriteFileAtomically(path, m_image.get(), m_size);
+    }
+
+    FrozenStyleIndex::MemoryStatistics FrozenStyleIndex::GetMemoryStatistics() const
+    {
+        return
+        {
+            .ImageBytes = m_size,
+            .IndexBytes = static_cast<std::size_t>(m_header->Values),
+            .ValueBytes = static_cast<std::size_t>(m_header->Strings - m_header->Values),
+            .StringBytes = static_cast<std::size_t>(m_header->StringsSize),
+            .PropertyCount = m_header->PropertyCount,
+            .ValueCount = m_header->ValueCount
+        };
+    }
+
+    std::uint32_t FrozenStyleIndex::FindSelector(const std::string_view name) const
+    {
+        if (m_header->SelectorCount == 0)
+            return NotFound;
+
+        const auto hash = Utils::Hash(name);
+        const auto slot = Utils::PerfectHash::Lookup(hash, m_selectorSeeds, m_header->SelectorBucketCount,
+                                                     m_header->SelectorCount);
+        const auto& record = m_selectors[slot];
+        if (record.Hash != hash || GetString(record.Name) != name)
+            return NotFound;
+
+        return slot;
+    }
+
+    std::string_view FrozenStyleIndex::GetSelectorName(const std::uint32_t selector) const
+    {
+        return GetString(m_selectors[selector].Name);
+    }
+
+    std::uint32_t FrozenStyleIndex::GetSelectorPropertyCount(const std::uint32_t selector) const
+    {
+        return m_selectors[selector].PropertyCount;
+    }
+
+    std::uint32_t FrozenStyleIndex::GetSelectorProperty(const std::uint32_t selector, const std::uint32_t index) const
+    {
+        const auto& record = m_selectors[selector];
+        if (index >= record.PropertyCount || record.FirstProperty + index >= m_header->PropertyCount)
+            throw std::out_of_range("Property index out of range");
+
+        return m_propertyList[record.FirstProperty + index];
+    }
+
+    std::uint32_t FrozenStyleIndex::FindProperty(const std::string_view selector, const std::string_view property) const
+    {
+        if (m_header->PropertyCount == 0)
+            return NotFound;
+
+        const auto hash = Utils::CombineHashes(Utils::Hash(selector), Utils::Hash(property));
+        const auto slot = Utils::PerfectHash::Lookup(hash, m_propertySeeds, m_header->PropertyBucketCount,
+                                                     m_header->PropertyCount);
+        const auto& record = m_properties[slot];
+        if (record.Hash != hash || GetString(record.Name) != property ||
+            record.Selector >= m_header->SelectorCount || GetString(m_selectors[record.Selector].Name) != selector)
+            return NotFound;
+
+        return slot;
+    }
+
+    std::uint32_t FrozenStyleIndex::GetPropertySelector(const std::uint32_t property) const
+    {
+        return m_properties[property].Selector;
+    }
+
+    std::string_view FrozenStyleIndex::GetPropertyName(const std::uint32_t property) const
+    {
+        return GetString(m_properties[property].Name);
+    }
+
+    Value FrozenStyleIndex::GetPropertyValue(const std::uint32_t property) const
+    {
+        const auto index = m_properties[property].Value;
+        if (index >= m_header->ValueCount)
+            throw std::out_of_range("Invalid style image: value out of bounds");
+
+        const auto& stored = m_values[index];
+        switch (stored.Type)
+        {
+        case Format::ValueType::Float:
+            return std::bit_cast<Float>(stored.Bits);
+        case Format::ValueType::Integer:
+            return static_cast<Integer>(stored.Bits);
+        case Format::ValueType::Bool:
+            return stored.Bits != 0;
+        case Format::ValueType::String:
+            return StringRef::Intern(GetString(stored.String));
+        case Format::ValueType::Color:
+            return Color { static_cast<std::uint32_t>(stored.Bits) };
+        case Format::ValueType::Null:
+            break;
+        }
+
+        return std::nullopt;
+    }
+
+    std::optional<std::string_view> FrozenStyleIndex::GetPropertyString(const std::uint32_t property) const
+    {
+        const auto index = m_properties[property].Value;
+        if (index >= m_header->ValueCount)
+            throw std::out_of_range("Invalid style image: value out of bounds");
+
+        const auto& stored = m_values[index];
+        if (stored.Type != Format::ValueType::String)
+            return std::nullopt;
+        return GetString(stored.String);
+    }
+
+    std::optional<Value> FrozenStyleIndex::Find(const std::string_view selector, const std::string_view property) const
+    {
+        const auto slot = FindProperty(selector, property);
+        if (slot == NotFound)
+            return std::nullopt;
+
+        return GetPropertyValue(slot);
+    }
+
+    FrozenStyleIndex::SelectorMap FrozenStyleIndex::Thaw() const
+    {
+        SelectorMap selectors;
+        selectors.reserve(SelectorCount());
+        for (std::uint32_t selector = 0; selector < SelectorCount(); ++selector)
+        {
+            auto table = std::make_shared<SymbolTable>();
+            table->SetOrder(m_selectors[selector].Order);
+            for (std::uint32_t i = 0; i < GetSelectorPropertyCount(selector); ++i)
+            {
+                const auto property = GetSelectorProperty(selector, i);
+                if (property == NotFound)
+                    throw std::runtime_error("Invalid style image: bad property list");
+
+                const auto name = GetPropertyName(property);
+                std::visit([&]<typename T0>(T0&& arg)
+                {
+                    using T = std::decay_t<T0>;
+                    if constexpr (!std::is_same_v<T, std::nullopt_t>)
+                        table->SetVariable<T>(name, arg);
+                }, GetPropertyValue(property));
+            }
+            selectors.emplace(GetSelectorName(selector), std::move(table));
+        }
+
+        return selectors;
+    }
+
+    std::string_view FrozenStyleIndex::GetString(const std::uint32_t offset) const
+    {
+        std::uint32_t size;
+        if (offset > m_header->StringsSize || m_header->StringsSize - offset < sizeof(size))
+            throw std::out_of_range("Invalid style image: string out of bounds");
+
+        std::memcpy(&size, m_strings + offset, sizeof(size));
+        if (m_header->StringsSize - offset - sizeof(size) <= size)
+            throw std::out_of_range("Invalid style image: string out of bounds");
+
+        return { m_strings + offset + sizeof(size), size };
+    }
+}
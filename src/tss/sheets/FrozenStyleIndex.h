@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <string_view>
+#include <unordered_map>
+#include <tss/sheets/FrozenStyleFormat.h>
+#include <tss/variables/SymbolTable.h>
+
+namespace Trema::Style
+{
+    // Read-only index over a parse result. Selectors and (selector, property) pairs are both addressed through
+    // minimal perfect hashes, and all records and strings live in one contiguous, position independent image:
+    // a lookup reads a bucket seed and then the record in its slot.
+    class FrozenStyleIndex final
+    {
+    public:
+        using SelectorMap = Style::SelectorMap;
+
+        // Bytes of the image by section. Properties holding equal values share one record, so ValueCount is the
+        // number of distinct values.
+        struct MemoryStatistics
+        {
+            std::size_t ImageBytes { 0 };
+            std::size_t IndexBytes { 0 }; // header, hash seeds, records and the property list
+            std::size_t ValueBytes { 0 };
+            std::size_t StringBytes { 0 };
+            std::uint32_t PropertyCount { 0 };
+            std::uint32_t ValueCount { 0 };
+        };
+
+        static constexpr std::uint32_t FormatVersion = 4;
+        static constexpr std::uint32_t NotFound = UINT32_MAX;
+
+        FrozenStyleIndex();
+
+        [[nodiscard]] static FrozenStyleIndex Build(const SelectorMap& selectors);
+        // Validates and wraps an existing image; storage must stay valid for as long as the index is used
+        [[nodiscard]] static FrozenStyleIndex FromImage(std::shared_ptr<const std::byte> storage, std::size_t size);
+        // Maps an image written by Save; lookups are served from the mapping, nothing is deserialized
+        [[nodiscard]] static FrozenStyleIndex Load(const std::filesystem::path& path);
+        void Save(const std::filesystem::path& path) const;
+
+        [[nodiscard]] std::span<const std::byte> GetImage() const { return { m_image.get(), m_size }; }
+
+        [[nodiscard]] std::uint32_t SelectorCount() const { return m_header->SelectorCount; }
+        [[nodiscard]] std::uint32_t PropertyCount() const { return m_header->PropertyCount; }
+        [[nodiscard]] MemoryStatistics GetMemoryStatistics() const;
+
+        // Selectors and properties are addressed by their perfect hash slot. Names and the views of
+        // GetPropertyString point into the image, so they are only valid while the index is alive.
+        [[nodiscard]] std::uint32_t FindSelector(std::string_view name) const;
+        [[nodiscard]] std::string_view GetSelectorName(std::uint32_t selector) const;
+        [[nodiscard]] std::uint32_t GetSelectorPropertyCount(std::uint32_t selector) const;
+        [[nodiscard]] std::uint32_t GetSelectorProperty(std::uint32_t selector, std::uint32_t index) const;
+
+        [[nodiscard]] std::uint32_t FindProperty(std::string_view selector, std::string_view property) const;
+        [[nodiscard]] std::uint32_t GetPropertySelector(std::uint32_t property) const;
+        [[nodiscard]] std::string_view GetPropertyName(std::uint32_t property) const;
+        // String values are interned, so values outlive the index
+        [[nodiscard]] Value GetPropertyValue(std::uint32_t property) const;
+        // Empty when the value isn't a string
+        [[nodiscard]] std::optional<std::string_view> GetPropertyString(std::uint32_t property) const;
+
+        [[nodiscard]] std::optional<Value> Find(std::string_view selector, std::string_view property) const;
+
+        // Typed lookup; std::string_view reads the string in place instead of interning it
+        template<typename T>
+        [[nodiscard]] std::optional<T> TryGetProperty(const std::uint32_t property) const noexcept
+        {
+            if constexpr (std::is_same_v<T, std::string_view>)
+            {
+                return GetPropertyString(property);
+            }
+            else
+            {
+                const auto value = GetPropertyValue(property);
+                return Style::TryGet<T>(&value);
+            }
+        }
+
+        template<typename T>
+        [[nodiscard]] std::optional<T> TryGet(const std::string_view selector, const std::string_view property) const noexcept
+        {
+            const auto slot = FindProperty(selector, property);
+            return slot != NotFound ? TryGetProperty<T>(slot) : std::nullopt;
+        }
+
+        // Rebuilds the symbol tables the index was built from; strings are interned, so the tables don't
+        // depend on the image
+        [[nodiscard]] SelectorMap Thaw() const;
+
+    private:
+        FrozenStyleIndex(std::shared_ptr<const std::byte> storage, std::size_t size);
+
+        std::shared_ptr<const std::byte> m_image;
+        std::size_t m_size { 0 };
+        const Format::Header* m_header { nullptr };
+        const std::uint32_t* m_selectorSeeds { nullptr };
+        const Format::SelectorRecord* m_selectors { nullptr };
+        const std::uint32_t* m_propertySeeds { nullptr };
+        const Format::PropertyRecord* m_properties { nullptr };
+        const std::uint32_t* m_propertyList { nullptr };
+        const Format::StoredValue* m_values { nullptr };
+        const char* m_strings { nullptr };
+
+        [[nodiscard]] std::string_view GetString(std::uint32_t offset) const;
+    };
+}
@@ -0,0 +1,89 @@
+#include <tss/sheets/LayeredStyleSheet.h>
+#include <stdexcept>
+#include <tss/utils/Hashing.h>
+
+namespace Trema::Style
+{
+    LayeredStyleSheet::Layer::Layer(StyleSheet sheet) :
+        m_sheet(std::move(sheet)),
+        m_filter(m_sheet.SelectorCount() + m_sheet.PropertyCount())
+    {
+        const auto& index = m_sheet.GetIndex();
+        for (std::uint32_t selector = 0; selector < index.SelectorCount(); ++selector)
+            m_filter.Insert(HashSelector(index.GetSelectorName(selector)));
+
+        for (std::uint32_t property = 0; property < index.PropertyCount(); ++property)
+        {
+            const auto selector = index.GetSelectorName(index.GetPropertySelector(property));
+            m_filter.Insert(HashProperty(selector, index.GetPropertyName(property)));
+        }
+    }
+
+    LayeredStyleSheet::LayeredStyleSheet(StyleSheet base)
+    {
+        Push(std::move(base));
+    }
+
+    void LayeredStyleSheet::Push(StyleSheet overlay)
+    {
+        Push(std::make_shared<const Layer>(std::move(overlay)));
+    }
+
+    void LayeredStyleSheet::Push(std::shared_ptr<const Layer> overlay)
+    {
+        m_layers.push_back(std::move(overlay));
+    }
+
+    std::shared_ptr<const LayeredStyleSheet::Layer> LayeredStyleSheet::Pop()
+    {
+        if (m_layers.empty())
+            throw std::out_of_range("No layer to pop");
+
+        auto layer = std::move(m_layers.back());
+        m_layers.pop_back();
+        return layer;
+    }
+
+    std::optional<Value> LayeredStyleSheet::Find(const std::string_view selector, const std::string_view property) const
+    {
+        const auto [index, slot] = FindProperty(selector, property);
+        return index ? std::optional(index->GetPropertyValue(slot)) : std::nullopt;
+    }
+
+    std::pair<const FrozenStyleIndex*, std::uint32_t> LayeredStyleSheet::FindProperty(const std::string_view selector,
+                                                                                     const std::string_view property) const
+    {
+        const auto hash = HashProperty(selector, property);
+        for (auto layer = m_layers.rbegin(); layer != m_layers.rend(); ++layer)
+        {
+            if (!(*layer)->MayContain(hash))
+                continue;
+
+            const auto& index = (*layer)->GetStyleSheet().GetIndex();
+            if (const auto slot = index.FindProperty(selector, property); slot != FrozenStyleIndex::NotFound)
+                return { &index, slot };
+        }
+        return { nullptr, FrozenStyleIndex::NotFound };
+    }
+
+    bool LayeredStyleSheet::HasSelector(const std::string_view selector) const
+    {
+        const auto hash = HashSelector(selector);
+        for (const auto& layer : m_layers)
+        {
+            if (layer->MayContain(hash) && layer->GetStyleSheet().HasSelector(selector))
+                return true;
+        }
+        return false;
+    }
+
+    std::uint64_t LayeredStyleSheet::HashProperty(const std::string_view selector, const std::string_view property)
+    {
+        return Utils::CombineHashes(Utils::Hash(selector), Utils::Hash(property));
+    }
+
+    std::uint64_t LayeredStyleSheet::HashSelector(const std::string_view selector)
+    {
+        return Utils::Hash(selector, 1);
+    }
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <tss/sheets/StyleSheet.h>
+#include <tss/utils/BloomFilter.h>
+
+namespace Trema::Style
+{
+    // Read-only view over a stack of sheets, such as a base theme under dark mode and customer overrides: a lookup
+    // returns the value of the topmost layer that defines it. Sheets aren't copied or merged, so switching themes is
+    // a Push or a Pop. Each layer keeps a Bloom filter of its (selector, property) pairs, and layers that can't
+    // hold a property are skipped without looking into them.
+    // Layers are shared between copies of the view.
+    class LayeredStyleSheet final
+    {
+    public:
+        class Layer final
+        {
+        public:
+            explicit Layer(StyleSheet sheet);
+
+            [[nodiscard]] const StyleSheet& GetStyleSheet() const { return m_sheet; }
+            [[nodiscard]] bool MayContain(const std::uint64_t hash) const { return m_filter.MayContain(hash); }
+
+        private:
+            StyleSheet m_sheet;
+            Utils::BitBloomFilter m_filter;
+        };
+
+        LayeredStyleSheet() = default;
+        explicit LayeredStyleSheet(StyleSheet base);
+
+        // Building a layer hashes the properties of its sheet once; push the same layer again to switch back for free
+        void Push(StyleSheet overlay);
+        void Push(std::shared_ptr<const Layer> overlay);
+        std::shared_ptr<const Layer> Pop();
+
+        [[nodiscard]] std::size_t LayerCount() const { return m_layers.size(); }
+        // 0 is the base
+        [[nodiscard]] const std::shared_ptr<const Layer>& GetLayer(const std::size_t index) const { return m_layers[index]; }
+
+        [[nodiscard]] std::optional<Value> Find(std::string_view selector, std::string_view property) const;
+
+        template<typename T>
+        [[nodiscard]] std::optional<T> TryGet(const std::string_view selector, const std::string_view property) const noexcept
+        {
+            const auto [index, slot] = FindProperty(selector, property);
+            return index ? index->TryGetProperty<T>(slot) : std::nullopt;
+        }
+
+        [[nodiscard]] bool HasSelector(std::string_view selector) const;
+
+        [[nodiscard]] static std::uint64_t HashProperty(std::string_view selector, std::string_view property);
+        [[nodiscard]] static std::uint64_t HashSelector(std::string_view selector);
+
+    private:
+        std::vector<std::shared_ptr<const Layer>> m_layers;
+
+        // Index of the topmost layer defining the property and its slot there, or nullptr
+        [[nodiscard]] std::pair<const FrozenStyleIndex*, std::uint32_t> FindProperty(std::string_view selector,
+                                                                                   std::string_view property) const;
+    };
+}
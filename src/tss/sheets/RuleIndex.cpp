@@ -0,0 +1,101 @@
+#include <tss/sheets/RuleIndex.h>
+#include <algorithm>
+#include <tuple>
+
+namespace Trema::Style
+{
+    RuleIndex::RuleIndex(const SelectorMap& selectors)
+    {
+        for (const auto& [text, table] : selectors)
+        {
+            auto parsed = Selector::Parse(text);
+            if (!parsed)
+                continue;
+
+            std::vector<std::uint64_t> ancestorHashes;
+            for (const auto& compound : parsed->GetCompounds().first(parsed->GetCompounds().size() - 1))
+            {
+                if (!compound.Type.empty())
+                    ancestorHashes.push_back(AncestorFilter::HashType(compound.Type));
+                if (!compound.Id.empty())
+                    ancestorHashes.push_back(AncestorFilter::HashId(compound.Id));
+                for (const auto& name : compound.Classes)
+                    ancestorHashes.push_back(AncestorFilter::HashClass(name));
+            }
+
+            const auto specificity = parsed->GetSpecificity();
+            m_rules.push_back({ text, std::move(*parsed), specificity, 0, std::move(ancestorHashes), table });
+        }
+
+        // The selector map is unordered: number the rules by the order of their blocks in the sources, so that the
+        // later of two rules of equal specificity wins. Text breaks the ties of the selectors of a list.
+        std::ranges::sort(m_rules, { }, [](const Rule& rule)
+        {
+            return std::tuple(rule.Table ? rule.Table->GetOrder() : 0, std::string_view(rule.Text));
+        });
+        for (std::uint32_t i = 0; i < m_rules.size(); ++i)
+        {
+            auto& rule = m_rules[i];
+            rule.Order = i;
+
+            const auto& subject = rule.Parsed.GetSubject();
+            if (!subject.Id.empty())
+                m_ids.try_emplace(subject.Id).first->second.push_back(i);
+            else if (!subject.Classes.empty())
+                m_classes.try_emplace(subject.Classes.front()).first->second.push_back(i);
+            else if (!subject.Type.empty())
+                m_types.try_emplace(subject.Type).first->second.push_back(i);
+            else
+                m_universal.push_back(i);
+        }
+    }
+
+    template<typename F>
+    void RuleIndex::ForEachBucket(const ElementInfo& element, const F& f) const
+    {
+        const auto visit = [&f](const Buckets& buckets, const std::string_view key)
+        {
+            if (key.empty())
+                return;
+            if (const auto it = buckets.find(key); it != buckets.end())
+                f(it->second);
+        };
+
+        visit(m_ids, element.Id);
+        for (const auto name : element.Classes)
+            visit(m_classes, name);
+        visit(m_types, element.Type);
+        f(m_universal);
+    }
+
+    void RuleIndex::Match(const ElementInfo& element, const std::span<const ElementInfo> ancestors,
+                          const AncestorFilter* filter, std::vector<const Rule*>& matches) const
+    {
+        const auto first = matches.size();
+        ForEachBucket(element, [&](const std::vector<std::uint32_t>& bucket)
+        {
+            for (const auto i : bucket)
+            {
+                const auto& rule = m_rules[i];
+                if (filter && !std::ranges::all_of(rule.AncestorHashes,
+                                                   [filter](const auto hash) { return filter->MayContain(hash); }))
+                    continue;
+
+                if (rule.Parsed.Matches(element, ancestors))
+                    matches.push_back(&rule);
+            }
+        });
+
+        std::sort(matches.begin() + static_cast<std::ptrdiff_t>(first), matches.end(), [](const Rule* a, const Rule* b)
+        {
+            return std::tie(a->Specificity, a->Order) < std::tie(b->Specificity, b->Order);
+        });
+    }
+
+    std::size_t RuleIndex::CountCandidates(const ElementInfo& element) const
+    {
+        std::size_t count = 0;
+        ForEachBucket(element, [&count](const std::vector<std::uint32_t>& bucket) { count += bucket.size(); });
+        return count;
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+#include <tss/sheets/Selector.h>
+#include <tss/utils/FlatHashMap.h>
+#include <tss/variables/SymbolTable.h>
+
+namespace Trema::Style
+{
+    // Rules of a parse result bucketed by the most selective part of the compound they apply to: its id, else its
+    // first class, else its type, else the universal bucket. Matching an element only looks at the buckets of its
+    // id, classes and type, so the cost depends on the rules that could apply rather than on the size of the sheet.
+    class RuleIndex final
+    {
+    public:
+        using SelectorMap = Style::SelectorMap;
+
+        struct Rule
+        {
+            std::string Text;
+            Selector Parsed;
+            Style::Specificity Specificity;
+            std::uint32_t Order;                        // rules are numbered in the order of their blocks
+            std::vector<std::uint64_t> AncestorHashes; // parts the ancestors need, checked against an AncestorFilter
+            std::shared_ptr<SymbolTable> Table;
+        };
+
+        // Selectors that can't be parsed are left out
+        explicit RuleIndex(const SelectorMap& selectors);
+
+        // Appends the rules matching the element, least specific first. ancestors run from the root to the parent;
+        // filter, when given, must hold the same ancestors.
+        void Match(const ElementInfo& element, std::span<const ElementInfo> ancestors, const AncestorFilter* filter,
+                   std::vector<const Rule*>& matches) const;
+
+        // Rules in the buckets an element looks at
+        [[nodiscard]] std::size_t CountCandidates(const ElementInfo& element) const;
+        [[nodiscard]] std::size_t RuleCount() const { return m_rules.size(); }
+
+    private:
+        using Buckets = Utils::FlatHashMap<std::string, std::vector<std::uint32_t>, Utils::StringHash, std::equal_to<>>;
+
+        std::vector<Rule> m_rules;
+        Buckets m_ids;
+        Buckets m_classes;
+        Buckets m_types;
+        std::vector<std::uint32_t> m_universal;
+
+        template<typename F>
+        void ForEachBucket(const ElementInfo& element, const F& f) const;
+    };
+}
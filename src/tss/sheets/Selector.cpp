@@ -0,0 +1,143 @@
+#include <tss/sheets/Selector.h>
+#include <algorithm>
+#include <tss/utils/Hashing.h>
+
+namespace Trema::Style
+{
+    namespace
+    {
+        std::optional<CompoundSelector> ParseCompound(const std::string_view text)
+        {
+            CompoundSelector compound;
+            std::size_t pos = 0;
+            const auto readName = [&text, &pos]
+            {
+                const auto end = std::min(text.find_first_of("#.*", pos), text.size());
+                const auto name = text.substr(pos, end - pos);
+                pos = end;
+                return name;
+            };
+
+            if (text.starts_with('*'))
+                pos = 1;
+            else
+                compound.Type = readName();
+
+            while (pos < text.size())
+            {
+                const char marker = text[pos++];
+                const auto name = readName();
+                if (marker == '#' && compound.Id.empty())
+                    compound.Id = name;
+                else if (marker == '.' && !name.empty())
+                    compound.Classes.emplace_back(name);
+                else if (marker != '#' || !name.empty())
+                    return std::nullopt;
+            }
+
+            return compound;
+        }
+
+        bool Contains(const std::span<const std::string_view> classes, const std::string_view name)
+        {
+            return std::ranges::find(classes, name) != classes.end();
+        }
+
+        template<typename F>
+        void ForEachPart(const ElementInfo& element, const F& f)
+        {
+            if (!element.Type.empty())
+                f(AncestorFilter::HashType(element.Type));
+            if (!element.Id.empty())
+                f(AncestorFilter::HashId(element.Id));
+            for (const auto name : element.Classes)
+                f(AncestorFilter::HashClass(name));
+        }
+    }
+
+    bool CompoundSelector::Matches(const ElementInfo& element) const
+    {
+        if (!Type.empty() && Type != element.Type)
+            return false;
+        if (!Id.empty() && Id != element.Id)
+            return false;
+
+        return std::ranges::all_of(Classes, [&element](const auto& name) { return Contains(element.Classes, name); });
+    }
+
+    std::optional<Selector> Selector::Parse(const std::string_view text)
+    {
+        Selector selector;
+        std::size_t pos = 0;
+        while (pos < text.size())
+        {
+            const auto end = std::min(text.find(' ', pos), text.size());
+            if (end != pos)
+            {
+                auto compound = ParseCompound(text.substr(pos, end - pos));
+                if (!compound)
+                    return std::nullopt;
+                selector.m_compounds.push_back(std::move(*compound));
+            }
+            pos = end + 1;
+        }
+
+        if (selector.m_compounds.empty())
+            return std::nullopt;
+        return selector;
+    }
+
+    Specificity Selector::GetSpecificity() const
+    {
+        Specificity specificity;
+        for (const auto& compound : m_compounds)
+        {
+            specificity.Ids += !compound.Id.empty();
+            specificity.Classes += static_cast<std::uint32_t>(compound.Classes.size());
+            specificity.Types += !compound.Type.empty();
+        }
+        return specificity;
+    }
+
+    bool Selector::Matches(const ElementInfo& element, std::span<const ElementInfo> ancestors) const
+    {
+        if (!GetSubject().Matches(element))
+            return false;
+
+        // Descendant combinators only: taking the nearest matching ancestor for each compound never misses a match
+        for (auto compound = m_compounds.rbegin() + 1; compound != m_compounds.rend(); ++compound)
+        {
+            while (!ancestors.empty() && !compound->Matches(ancestors.back()))
+                ancestors = ancestors.first(ancestors.size() - 1);
+            if (ancestors.empty())
+                return false;
+            ancestors = ancestors.first(ancestors.size() - 1);
+        }
+        return true;
+    }
+
+    void AncestorFilter::Push(const ElementInfo& element)
+    {
+        ForEachPart(element, [this](const std::uint64_t hash) { m_filter.Insert(hash); });
+    }
+
+    void AncestorFilter::Pop(const ElementInfo& element)
+    {
+        ForEachPart(element, [this](const std::uint64_t hash) { m_filter.Erase(hash); });
+    }
+
+    std::uint64_t AncestorFilter::HashId(const std::string_view id)
+    {
+        return Utils::CombineHashes(Utils::Hash(id), 1);
+    }
+
+    std::uint64_t AncestorFilter::HashClass(const std::string_view name)
+    {
+        return Utils::CombineHashes(Utils::Hash(name), 2);
+    }
+
+    std::uint64_t AncestorFilter::HashType(const std::string_view type)
+    {
+        return Utils::CombineHashes(Utils::Hash(type), 3);
+    }
+}
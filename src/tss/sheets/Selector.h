@@ -0,0 +1,79 @@
+#pragma once
+
+#include <compare>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <tss/utils/BloomFilter.h>
+
+namespace Trema::Style
+{
+    // What selectors can match on an element
+    struct ElementInfo
+    {
+        std::string_view Type;
+        std::string_view Id;
+        std::span<const std::string_view> Classes;
+    };
+
+    // One compound selector such as "button#ok.primary"; empty parts match anything
+    struct CompoundSelector
+    {
+        std::string Type;
+        std::string Id;
+        std::vector<std::string> Classes;
+
+        [[nodiscard]] bool Matches(const ElementInfo& element) const;
+    };
+
+    struct Specificity
+    {
+        std::uint32_t Ids { 0 };
+        std::uint32_t Classes { 0 };
+        std::uint32_t Types { 0 };
+
+        auto operator<=>(const Specificity&) const = default;
+    };
+
+    // Selector as the parser saves blocks under: compounds separated by blanks, each one matching a descendant
+    // of the previous one. "#" and "*" match every element.
+    class Selector final
+    {
+    public:
+        // Empty when the text isn't a selector
+        [[nodiscard]] static std::optional<Selector> Parse(std::string_view text);
+
+        // Outermost first; the last one is the element the rule applies to
+        [[nodiscard]] std::span<const CompoundSelector> GetCompounds() const { return m_compounds; }
+        [[nodiscard]] const CompoundSelector& GetSubject() const { return m_compounds.back(); }
+        [[nodiscard]] Specificity GetSpecificity() const;
+
+        // ancestors run from the root to the parent of the element
+        [[nodiscard]] bool Matches(const ElementInfo& element, std::span<const ElementInfo> ancestors) const;
+
+    private:
+        std::vector<CompoundSelector> m_compounds;
+    };
+
+    // Ids, classes and types of the ancestors of the element being matched, kept up to date while walking a tree:
+    // Push an element before visiting its children, Pop it after. Rules whose ancestor parts are missing from the
+    // filter are rejected without walking the ancestors.
+    class AncestorFilter final
+    {
+    public:
+        void Push(const ElementInfo& element);
+        void Pop(const ElementInfo& element);
+
+        [[nodiscard]] bool MayContain(const std::uint64_t hash) const { return m_filter.MayContain(hash); }
+
+        [[nodiscard]] static std::uint64_t HashId(std::string_view id);
+        [[nodiscard]] static std::uint64_t HashClass(std::string_view name);
+        [[nodiscard]] static std::uint64_t HashType(std::string_view type);
+
+    private:
+        Utils::BloomFilter<> m_filter;
+    };
+}
@@ -0,0 +1,83 @@
+#include <tss/sheets/SlottedStyles.h>
+#include <unordered_map>
+
+namespace Trema::Style
+{
+    namespace
+    {
+        std::vector<std::uint64_t> Bits(const std::uint32_t count)
+        {
+            return std::vector<std::uint64_t>((count + 63) / 64);
+        }
+    }
+
+    SlottedStyles::SlottedStyles(std::shared_ptr<const PropertySchema> schema, const SelectorMap& selectors) :
+        m_schema(std::move(schema))
+    {
+        // Every selector starts from the defaults
+        PropertySlots defaults;
+        defaults.m_floats.resize(m_schema->SlotCount(PropertyType::Float));
+        defaults.m_integers.resize(m_schema->SlotCount(PropertyType::Integer));
+        defaults.m_strings.resize(m_schema->SlotCount(PropertyType::String));
+        defaults.m_colors.resize(m_schema->SlotCount(PropertyType::Color));
+        defaults.m_bools = Bits(m_schema->SlotCount(PropertyType::Bool));
+        for (std::size_t type = 0; type < defaults.m_set.size(); ++type)
+            defaults.m_set[type] = Bits(m_schema->SlotCount(static_cast<PropertyType>(type)));
+
+        const auto store = [](PropertySlots& slots, const PropertySchema::Property& property, const Value& value)
+        {
+            switch (property.Type)
+            {
+            case PropertyType::Float:
+                slots.m_floats[property.Slot] = std::holds_alternative<Integer>(value)
+                    ? static_cast<Float>(std::get<Integer>(value)) : std::get<Float>(value);
+                break;
+            case PropertyType::Integer:
+                slots.m_integers[property.Slot] = std::get<Integer>(value);
+                break;
+            case PropertyType::Bool:
+                PropertySlots::SetBit(slots.m_bools, property.Slot, std::get<bool>(value));
+                break;
+            case PropertyType::String:
+                slots.m_strings[property.Slot] = std::get<StringRef>(value);
+                break;
+            case PropertyType::Color:
+                slots.m_colors[property.Slot] = std::get<Color>(value);
+                break;
+            }
+        };
+
+        for (const auto& property : m_schema->GetProperties())
+            store(defaults, property, property.Default);
+
+        // The selectors of a list share their table, and so their slots
+        std::unordered_map<const SymbolTable*, std::uint32_t> tables;
+        for (const auto& [selector, table] : selectors)
+        {
+            const auto [it, inserted] = tables.try_emplace(table.get(), static_cast<std::uint32_t>(m_slots.size()));
+            m_selectors.try_emplace(selector, it->second);
+            if (!inserted)
+                continue;
+
+            auto& slots = m_slots.emplace_back(defaults);
+            slots.m_table = table;
+
+            for (const auto& [name, variable] : *table)
+            {
+                const auto property = m_schema->Find(name.View());
+                // The parser reports mismatched values; tables built without the schema may still hold some
+                if (!property || !PropertySchema::Accepts(property->Type, variable.GetValue()))
+                    continue;
+
+                store(slots, *property, variable.GetValue());
+                PropertySlots::SetBit(slots.m_set[static_cast<std::size_t>(property->Type)], property->Slot, true);
+            }
+        }
+    }
+
+    const PropertySlots* SlottedStyles::Find(const std::string_view selector) const
+    {
+        const auto it = m_selectors.find(selector);
+        return it != m_selectors.end() ? &m_slots[it->second] : nullptr;
+    }
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include <tss/utils/FlatHashMap.h>
+#include <tss/variables/PropertySchema.h>
+#include <tss/variables/SymbolTable.h>
+
+namespace Trema::Style
+{
+    // Properties of one selector: those of the schema in typed slots (booleans packed in bits), holding the
+    // default when the sheet doesn't set them, and the others in the selector's table
+    class PropertySlots final
+    {
+    public:
+        template<typename T>
+        [[nodiscard]] T Get(const PropertyKey<T> key) const
+        {
+            if constexpr (std::is_same_v<T, Float>)
+                return m_floats[key.Slot];
+            else if constexpr (std::is_same_v<T, Integer>)
+                return m_integers[key.Slot];
+            else if constexpr (std::is_same_v<T, bool>)
+                return TestBit(m_bools, key.Slot);
+            else if constexpr (std::is_same_v<T, Color>)
+                return m_colors[key.Slot];
+            else
+                return m_strings[key.Slot].View();
+        }
+
+        // Whether the sheet set the property, rather than it holding the default
+        template<typename T>
+        [[nodiscard]] bool IsSet(const PropertyKey<T> key) const
+        {
+            return TestBit(m_set[static_cast<std::size_t>(PropertySchema::TypeOf<T>())], key.Slot);
+        }
+
+        // Properties outside the schema
+        [[nodiscard]] const Value* FindOther(const std::string_view name) const { return m_table->FindValue(name); }
+
+    private:
+        friend class SlottedStyles;
+
+        std::vector<Float> m_floats;
+        std::vector<Integer> m_integers;
+        std::vector<StringRef> m_strings;
+        std::vector<Color> m_colors;
+        std::vector<std::uint64_t> m_bools;
+        std::array<std::vector<std::uint64_t>, 5> m_set; // by PropertyType
+        std::shared_ptr<const SymbolTable> m_table;
+
+        static bool TestBit(const std::vector<std::uint64_t>& bits, const std::uint32_t index)
+        {
+            return (bits[index / 64] >> (index % 64)) & 1;
+        }
+
+        static void SetBit(std::vector<std::uint64_t>& bits, const std::uint32_t index, const bool value)
+        {
+            const auto mask = std::uint64_t { 1 } << (index % 64);
+            bits[index / 64] = value ? bits[index / 64] | mask : bits[index / 64] & ~mask;
+        }
+    };
+
+    // Parse results laid out for a schema; reading a registered property is an array access
+    class SlottedStyles final
+    {
+    public:
+        using SelectorMap = Style::SelectorMap;
+
+        SlottedStyles(std::shared_ptr<const PropertySchema> schema, const SelectorMap& selectors);
+
+        [[nodiscard]] const PropertySlots* Find(std::string_view selector) const;
+        [[nodiscard]] const PropertySchema& GetSchema() const { return *m_schema; }
+
+    private:
+        std::shared_ptr<const PropertySchema> m_schema;
+        Utils::FlatHashMap<std::string, std::uint32_t, Utils::StringHash, std::equal_to<>> m_selectors;
+        std::vector<PropertySlots> m_slots;
+    };
+}
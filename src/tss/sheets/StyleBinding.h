@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <tss/sheets/StyleSheet.h>
+#include <tss/variables/PropertySchema.h>
+
+namespace Trema::Style
+{
+    // A member of a bound struct and the property it is read from
+    template<typename T, typename M>
+    struct FieldBinding
+    {
+        std::string_view Property;
+        M T::* Member;
+    };
+
+    template<typename T, typename M>
+    constexpr FieldBinding<T, M> Field(const std::string_view property, M T::* member)
+    {
+        PropertySchema::TypeOf<M>(); // members are Float, Integer, bool, std::string_view or Color
+        return { property, member };
+    }
+
+    // Describes the fields of a struct to StyleBinding; specialize it with
+    //   static constexpr auto Fields = std::make_tuple(Field("width", &ButtonStyle::Width), ...);
+    template<typename T>
+    struct StyleFields;
+
+    // Fills structs described by StyleFields<T> from a sheet. Field names are resolved to the sheet's property slots
+    // once, for every selector, so filling a struct reads its values without hashing any property name. Strings
+    // borrow from the sheet, which the binding keeps alive.
+    template<typename T>
+    class StyleBinding final
+    {
+    public:
+        explicit StyleBinding(StyleSheet sheet) :
+            m_sheet(std::move(sheet))
+        {
+            const auto& index = m_sheet.GetIndex();
+            m_properties.assign(static_cast<std::size_t>(index.SelectorCount()) * FieldCount, FrozenStyleIndex::NotFound);
+
+            for (std::uint32_t selector = 0; selector < index.SelectorCount(); ++selector)
+            {
+                for (std::uint32_t i = 0; i < index.GetSelectorPropertyCount(selector); ++i)
+                {
+                    const auto property = index.GetSelectorProperty(selector, i);
+                    if (property != FrozenStyleIndex::NotFound)
+                        Resolve(selector, property, std::make_index_sequence<FieldCount>());
+                }
+            }
+        }
+
+        // Fields the selector doesn't set, or sets to a value of another type, keep their value. Returns false
+        // when the sheet has no such selector.
+        bool Fill(const std::string_view selector, T& out) const
+        {
+            const auto slot = m_sheet.GetIndex().FindSelector(selector);
+            if (slot == FrozenStyleIndex::NotFound)
+                return false;
+
+            Fill(slot, out);
+            return true;
+        }
+
+        // Selector slot from FindSelector, for callers that fill the same selector repeatedly
+        void Fill(const std::uint32_t selector, T& out) const
+        {
+            const auto properties = &m_properties[static_cast<std::size_t>(selector) * FieldCount];
+            FillFields(properties, out, std::make_index_sequence<FieldCount>());
+        }
+
+        // out[i] is filled from selectors[i]; structs of missing selectors are left as they are
+        void Fill(const std::span<const std::string_view> selectors, const std::span<T> out) const
+        {
+            if (selectors.size() != out.size())
+                throw std::invalid_argument("Selectors and structs must have the same size");
+
+            for (std::size_t i = 0; i < selectors.size(); ++i)
+                Fill(selectors[i], out[i]);
+        }
+
+        [[nodiscard]] std::uint32_t FindSelector(const std::string_view selector) const
+        {
+            return m_sheet.GetIndex().FindSelector(selector);
+        }
+
+        [[nodiscard]] const StyleSheet& GetSheet() const { return m_sheet; }
+
+    private:
+        static constexpr auto& Fields = StyleFields<T>::Fields;
+        static constexpr std::size_t FieldCount = std::tuple_size_v<std::remove_cvref_t<decltype(Fields)>>;
+
+        StyleSheet m_sheet;
+        std::vector<std::uint32_t> m_properties; // FieldCount per selector, NotFound where the field keeps its value
+
+        template<std::size_t... I>
+        void Resolve(const std::uint32_t selector, const std::uint32_t property, std::index_sequence<I...>)
+        {
+            const auto& index = m_sheet.GetIndex();
+            const auto name = index.GetPropertyName(property);
+            const auto value = index.GetPropertyValue(property);
+            const auto resolve = [&]<std::size_t F>(std::integral_constant<std::size_t, F>)
+            {
+                using Member = std::remove_cvref_t<decltype(std::declval<T&>().*std::get<F>(Fields).Member)>;
+                if (name == std::get<F>(Fields).Property &&
+                    PropertySchema::Accepts(PropertySchema::TypeOf<Member>(), value))
+                {
+                    m_properties[static_cast<std::size_t>(selector) * FieldCount + F] = property;
+                }
+            };
+            (resolve(std::integral_constant<std::size_t, I>()), ...);
+        }
+
+        template<std::size_t... I>
+        void FillFields(const std::uint32_t* properties, T& out, std::index_sequence<I...>) const
+        {
+            const auto& index = m_sheet.GetIndex();
+            const auto fill = [&]<std::size_t F>(std::integral_constant<std::size_t, F>)
+            {
+                if (properties[F] == FrozenStyleIndex::NotFound)
+                    return;
+
+                auto& member = out.*std::get<F>(Fields).Member;
+                using Member = std::remove_cvref_t<decltype(member)>;
+                // Types were checked while resolving; integers are widened for float fields
+                if constexpr (std::is_same_v<Member, std::string_view>)
+                {
+                    member = *index.GetPropertyString(properties[F]);
+                }
+                else
+                {
+                    const auto value = index.GetPropertyValue(properties[F]);
+                    if constexpr (std::is_same_v<Member, Float>)
+                        member = std::holds_alternative<Integer>(value) ? static_cast<Float>(std::get<Integer>(value)) : std::get<Float>(value);
+                    else
+                        member = std::get<Member>(value);
+                }
+            };
+            (fill(std::integral_constant<std::size_t, I>()), ...);
+        }
+    };
+}
@@ -0,0 +1,133 @@
+#include <tss/sheets/StyleResolver.h>
+#include <algorithm>
+#include <mutex>
+#include <string>
+
+namespace Trema::Style
+{
+    StyleResolver::StyleResolver(StyleSheet sheet) :
+        m_sheet(std::move(sheet)),
+        m_global(m_sheet.GetIndex().FindSelector("#"))
+    {
+        auto empty = std::make_shared<ComputedStyle>();
+        empty->m_sheet = m_sheet;
+        m_empty = std::move(empty);
+    }
+
+    std::shared_ptr<const ComputedStyle> StyleResolver::Resolve(const std::string_view element)
+    {
+        return Resolve(element, { });
+    }
+
+    std::shared_ptr<const ComputedStyle> StyleResolver::Resolve(const std::string_view element,
+                                                                const std::span<const std::string_view> ancestors)
+    {
+        // Reused between calls so that a cache hit doesn't allocate
+        thread_local Chain chain;
+        chain.clear();
+
+        if (m_global != FrozenStyleIndex::NotFound)
+            chain.push_back(m_global);
+        for (const auto ancestor : ancestors)
+        {
+            if (const auto scope = FindScope(ancestor); scope != FrozenStyleIndex::NotFound)
+                chain.push_back(scope);
+        }
+        if (const auto scope = FindScope(element); scope != FrozenStyleIndex::NotFound)
+            chain.push_back(scope);
+
+        {
+            std::shared_lock lock(m_mutex);
+            if (auto style = Lookup(chain, HashChain(chain)))
+            {
+                m_hits.fetch_add(1, std::memory_order_relaxed);
+                return style;
+            }
+        }
+
+        m_misses.fetch_add(1, std::memory_order_relaxed);
+        return Build(chain);
+    }
+
+    StyleResolver::Statistics StyleResolver::GetStatistics() const
+    {
+        std::shared_lock lock(m_mutex);
+        return { m_hits.load(std::memory_order_relaxed), m_misses.load(std::memory_order_relaxed), m_styles };
+    }
+
+    void StyleResolver::Clear()
+    {
+        std::unique_lock lock(m_mutex);
+        m_cache.clear();
+        m_styles = 0;
+        m_hits = 0;
+        m_misses = 0;
+    }
+
+    std::uint32_t StyleResolver::FindScope(const std::string_view id) const
+    {
+        if (id.empty())
+            return FrozenStyleIndex::NotFound;
+
+        thread_local std::string selector;
+        selector.assign("#");
+        selector.append(id);
+        return m_sheet.GetIndex().FindSelector(selector);
+    }
+
+    std::shared_ptr<const ComputedStyle> StyleResolver::Lookup(const std::span<const std::uint32_t> chain,
+                                                               const std::uint64_t hash) const
+    {
+        if (chain.empty())
+            return m_empty;
+
+        const auto bucket = m_cache.find(hash);
+        if (bucket == m_cache.end())
+            return nullptr;
+
+        for (const auto& entry : bucket->second)
+        {
+            if (std::ranges::equal(entry.Selectors, chain))
+                return entry.Style;
+        }
+        return nullptr;
+    }
+
+    std::shared_ptr<const ComputedStyle> StyleResolver::Build(const std::span<const std::uint32_t> chain)
+    {
+        const auto hash = HashChain(chain);
+        {
+            std::shared_lock lock(m_mutex);
+            if (auto style = Lookup(chain, hash))
+                return style;
+        }
+
+        // The prefix is the style of the parent chain, which is usually cached already
+        auto style = std::make_shared<ComputedStyle>(*Build(chain.first(chain.size() - 1)));
+        const auto& index = m_sheet.GetIndex();
+        const auto selector = chain.back();
+        for (std::uint32_t i = 0; i < index.GetSelectorPropertyCount(selector); ++i)
+        {
+            const auto property = index.GetSelectorProperty(selector, i);
+            style->m_properties.insert_or_assign(StringRef::Intern(index.GetPropertyName(property)),
+                                                 index.GetPropertyValue(property));
+        }
+
+        std::unique_lock lock(m_mutex);
+        // Another thread may have built the same chain in the meantime; keep the first one so that it stays shared
+        if (auto existing = Lookup(chain, hash))
+            return existing;
+
+        m_cache[hash].push_back({ Chain(chain.begin(), chain.end()), style });
+        ++m_styles;
+        return style;
+    }
+
+    std::uint64_t StyleResolver::HashChain(const std::span<const std::uint32_t> chain)
+    {
+        std::uint64_t hash = chain.size();
+        for (const auto selector : chain)
+            hash = Utils::CombineHashes(hash, selector);
+        return hash;
+    }
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <tss/sheets/StyleSheet.h>
+#include <tss/utils/FlatHashMap.h>
+#include <tss/utils/Hashing.h>
+
+namespace Trema::Style
+{
+    // Style of one element once the cascade is applied. Shared between every element that resolves to the same
+    // selector chain, so it is never modified after being built. Names and strings are interned, so the style
+    // doesn't depend on the sheet.
+    class ComputedStyle final
+    {
+    public:
+        using Properties = Utils::FlatHashMap<StringRef, Value, Utils::StringHash, std::equal_to<>>;
+
+        [[nodiscard]] const Value* Find(const std::string_view property) const noexcept
+        {
+            const auto it = m_properties.find(property);
+            return it != m_properties.end() ? &it->second : nullptr;
+        }
+
+        template<typename T>
+        [[nodiscard]] std::optional<T> TryGet(const std::string_view property) const noexcept
+        {
+            return Style::TryGet<T>(Find(property));
+        }
+
+        [[nodiscard]] std::size_t PropertyCount() const { return m_properties.size(); }
+        [[nodiscard]] Properties::const_iterator begin() const { return m_properties.begin(); }
+        [[nodiscard]] Properties::const_iterator end() const { return m_properties.end(); }
+
+    private:
+        friend class StyleResolver;
+
+        StyleSheet m_sheet;
+        Properties m_properties;
+    };
+
+    // Applies the cascade of a sheet: the global scope ("#"), then each ancestor from the root down, then the
+    // element itself, a later scope overriding an earlier one.
+    // Only the selectors that exist in the sheet take part, and the computed styles are cached by that chain:
+    // elements whose ids have no rule of their own share the style of their parent chain, and a chain is built
+    // on top of the cached style of its prefix. Resolve can be called from several threads.
+    class StyleResolver final
+    {
+    public:
+        struct Statistics
+        {
+            std::size_t Hits { 0 };
+            std::size_t Misses { 0 };
+            std::size_t Styles { 0 };
+        };
+
+        explicit StyleResolver(StyleSheet sheet);
+
+        // Ids are given without '#'; ancestors run from the root to the parent of the element
+        [[nodiscard]] std::shared_ptr<const ComputedStyle> Resolve(std::string_view element,
+                                                                   std::span<const std::string_view> ancestors);
+        [[nodiscard]] std::shared_ptr<const ComputedStyle> Resolve(std::string_view element);
+
+        [[nodiscard]] Statistics GetStatistics() const;
+        void Clear();
+
+        [[nodiscard]] const StyleSheet& GetStyleSheet() const { return m_sheet; }
+
+    private:
+        using Chain = std::vector<std::uint32_t>;
+
+        struct Entry
+        {
+            Chain Selectors;
+            std::shared_ptr<const ComputedStyle> Style;
+        };
+
+        StyleSheet m_sheet;
+        std::uint32_t m_global;
+        std::shared_ptr<const ComputedStyle> m_empty;
+
+        mutable std::shared_mutex m_mutex;
+        std::unordered_map<std::uint64_t, std::vector<Entry>> m_cache; // chain hash -> entries
+        std::size_t m_styles { 0 };
+        std::atomic<std::size_t> m_hits { 0 };
+        std::atomic<std::size_t> m_misses { 0 };
+
+        [[nodiscard]] std::uint32_t FindScope(std::string_view id) const;
+        [[nodiscard]] std::shared_ptr<const ComputedStyle> Lookup(std::span<const std::uint32_t> chain,
+                                                                  std::uint64_t hash) const;
+        [[nodiscard]] std::shared_ptr<const ComputedStyle> Build(std::span<const std::uint32_t> chain);
+        [[nodiscard]] static std::uint64_t HashChain(std::span<const std::uint32_t> chain);
+    };
+}
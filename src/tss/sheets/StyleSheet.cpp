@@ -0,0 +1,14 @@
+#include <tss/sheets/StyleSheet.h>
+
+namespace Trema::Style
+{
+    StyleSheet::StyleSheet() :
+        m_index(std::make_shared<const FrozenStyleIndex>())
+    {
+    }
+
+    StyleSheet::StyleSheet(FrozenStyleIndex index) :
+        m_index(std::make_shared<const FrozenStyleIndex>(std::move(index)))
+    {
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <tss/sheets/FrozenStyleIndex.h>
+
+namespace Trema::Style
+{
+    // Immutable parse result. Copies share the same frozen index, so a sheet can be handed to any number of
+    // threads; every lookup is const and lock-free, and the sheet does not depend on the parser that built it.
+    // Values read from a sheet are independent of it; only the std::string_view of TryGet borrows from the sheet.
+    class StyleSheet final
+    {
+    public:
+        StyleSheet();
+        explicit StyleSheet(FrozenStyleIndex index);
+
+        // Precompiled sheets: Load maps a file written by Save instead of parsing anything
+        [[nodiscard]] static StyleSheet Load(const std::filesystem::path& path) { return StyleSheet(FrozenStyleIndex::Load(path)); }
+        void Save(const std::filesystem::path& path) const { m_index->Save(path); }
+
+        [[nodiscard]] std::optional<Value> Find(std::string_view selector, std::string_view property) const
+        {
+            return m_index->Find(selector, property);
+        }
+
+        // Typed lookup that neither allocates nor throws; strings borrow from the sheet
+        template<typename T>
+        [[nodiscard]] std::optional<T> TryGet(const std::string_view selector, const std::string_view property) const noexcept
+        {
+            return m_index->TryGet<T>(selector, property);
+        }
+
+        [[nodiscard]] bool HasSelector(const std::string_view selector) const
+        {
+            return m_index->FindSelector(selector) != FrozenStyleIndex::NotFound;
+        }
+
+        [[nodiscard]] std::uint32_t SelectorCount() const { return m_index->SelectorCount(); }
+        [[nodiscard]] std::uint32_t PropertyCount() const { return m_index->PropertyCount(); }
+        [[nodiscard]] FrozenStyleIndex::MemoryStatistics GetMemoryStatistics() const { return m_index->GetMemoryStatistics(); }
+        [[nodiscard]] const FrozenStyleIndex& GetIndex() const { return *m_index; }
+
+    private:
+        std::shared_ptr<const FrozenStyleIndex> m_index;
+    };
+}
@@ -0,0 +1,266 @@
+#include <tss/sheets/StyleSheetWatcher.h>
+#include <chrono>
+#include <map>
+#include <set>
+#include <sstream>
+#include <tss/parsing/StackedStyleParser.h>
+#include <tss/tokenization/EndToEndTokenizer.h>
+
+#ifdef __linux__
+#include <cerrno>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace Trema::Style
+{
+    namespace
+    {
+        constexpr auto DebounceDelay = std::chrono::milliseconds(50);
+        constexpr auto PollInterval = std::chrono::milliseconds(250);
+    }
+
+    StyleSheetWatcher::StyleSheetWatcher(std::vector<std::filesystem::path> files) :
+        m_current(std::make_shared<const StyleSheet>())
+    {
+        m_files.reserve(files.size());
+        for (auto& file : files)
+            m_files.push_back(std::filesystem::absolute(file).lexically_normal());
+    }
+
+    StyleSheetWatcher::~StyleSheetWatcher()
+    {
+        Stop();
+    }
+
+    void StyleSheetWatcher::Start()
+    {
+        if (m_thread.joinable())
+            return;
+
+        Reload();
+
+        m_stopping = false;
+        m_ready = false;
+    #ifdef __linux__
+        if (pipe(m_wakePipe) != 0)
+            throw std::runtime_error("Unable to create watcher wake pipe");
+    #endif
+        m_thread = std::thread(&StyleSheetWatcher::Run, this);
+
+        std::unique_lock lock(m_mutex);
+        m_wake.wait(lock, [this] { return m_ready; });
+    }
+
+    void StyleSheetWatcher::Stop()
+    {
+        if (!m_thread.joinable())
+            return;
+
+        {
+            std::lock_guard lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wake.notify_all();
+    #ifdef __linux__
+        const char wake = 0;
+        [[maybe_unused]] const auto written = write(m_wakePipe[1], &wake, 1);
+    #endif
+        m_thread.join();
+
+    #ifdef __linux__
+        close(m_wakePipe[0]);
+        close(m_wakePipe[1]);
+        m_wakePipe[0] = m_wakePipe[1] = -1;
+    #endif
+    }
+
+    bool StyleSheetWatcher::Reload()
+    {
+        std::lock_guard reloadLock(m_reloadMutex);
+        MistakesContainer mistakes;
+        std::shared_ptr<const StyleSheet> sheet;
+        try
+        {
+            StackedStyleParser parser(std::make_unique<EndToEndTokenizer>("", mistakes), mistakes);
+            for (const auto& file : m_files)
+                parser.ParseFromFile(file);
+
+            sheet = std::make_shared<const StyleSheet>(parser.BuildStyleSheet());
+        }
+        catch (const std::exception& e)
+        {
+            std::lock_guard lock(m_errorMutex);
+            m_lastError = e.what();
+            return false;
+        }
+
+        // Editors that truncate before writing leave the file empty for a moment: that isn't a new sheet
+        for (const auto& file : m_files)
+        {
+            std::error_code error;
+            if (std::filesystem::file_size(file, error) == 0 && !error)
+            {
+                std::lock_guard lock(m_errorMutex);
+                m_lastError = file.string() + " is empty";
+                return false;
+            }
+        }
+
+        // A half-edited sheet doesn't replace a good one; the listener sees the mistakes with the kept snapshot
+        if (!mistakes.empty())
+        {
+            {
+                std::ostringstream ss;
+                ss << mistakes;
+                std::lock_guard lock(m_errorMutex);
+                m_lastError = ss.str();
+            }
+            if (m_listener)
+                m_listener(Current(), mistakes);
+            return false;
+        }
+
+        {
+            std::lock_guard lock(m_errorMutex);
+            m_lastError.clear();
+        }
+        m_current.store(sheet, std::memory_order_release);
+        m_generation.fetch_add(1, std::memory_order_acq_rel);
+        if (m_listener)
+            m_listener(*sheet, mistakes);
+
+        return true;
+    }
+
+    std::string StyleSheetWatcher::GetLastError() const
+    {
+        std::lock_guard lock(m_errorMutex);
+        return m_lastError;
+    }
+
+    void StyleSheetWatcher::Run()
+    {
+    #ifdef __linux__
+        Watch();
+    #else
+        Poll();
+    #endif
+    }
+
+    void StyleSheetWatcher::SignalReady()
+    {
+        {
+            std::lock_guard lock(m_mutex);
+            m_ready = true;
+        }
+        m_wake.notify_all();
+    }
+
+    void StyleSheetWatcher::Watch()
+    {
+    #ifdef __linux__
+        const int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (fd < 0)
+        {
+            Poll();
+            return;
+        }
+
+        std::map<int, std::filesystem::path> directories;
+        for (const auto& file : m_files)
+        {
+            const auto directory = file.parent_path();
+            const int wd = inotify_add_watch(fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE);
+            if (wd >= 0)
+                directories[wd] = directory;
+        }
+        if (directories.empty())
+        {
+            close(fd);
+            Poll();
+            return;
+        }
+        const std::set<std::filesystem::path> watched(m_files.begin(), m_files.end());
+        SignalReady();
+
+        // Returns true when one of the watched files was touched
+        const auto drainEvents = [&]
+        {
+            alignas(inotify_event) char buffer[4096];
+            bool changed = false;
+            ssize_t length;
+            while ((length = read(fd, buffer, sizeof(buffer))) > 0)
+            {
+                for (ssize_t offset = 0; offset < length;)
+                {
+                    const auto event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                    if (event->len > 0 && directories.contains(event->wd) &&
+                        watched.contains(directories[event->wd] / event->name))
+                        changed = true;
+                    offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+                }
+            }
+            return changed;
+        };
+
+        // Waits again when a signal interrupts the wait
+        pollfd fds[2] = { { fd, POLLIN, 0 }, { m_wakePipe[0], POLLIN, 0 } };
+        const auto wait = [&](const nfds_t count, const int timeout)
+        {
+            int ready;
+            while ((ready = poll(fds, count, timeout)) < 0 && errno == EINTR)
+            {
+            }
+            return ready;
+        };
+
+        while (!m_stopping)
+        {
+            if (wait(2, -1) < 0 || fds[1].revents)
+                break;
+
+            if (!drainEvents())
+                continue;
+
+            // Editors often write a file in several steps: wait until things settle down
+            while (!m_stopping && wait(1, static_cast<int>(DebounceDelay.count())) > 0)
+                drainEvents();
+
+            if (!m_stopping)
+                Reload();
+        }
+
+        close(fd);
+    #endif
+    }
+
+    void StyleSheetWatcher::Poll()
+    {
+        const auto lastWriteTimes = [this]
+        {
+            std::vector<std::filesystem::file_time_type> times;
+            for (const auto& file : m_files)
+            {
+                std::error_code error;
+                times.push_back(std::filesystem::last_write_time(file, error));
+            }
+            return times;
+        };
+
+        auto previous = lastWriteTimes();
+        SignalReady();
+        std::unique_lock lock(m_mutex);
+        while (!m_wake.wait_for(lock, PollInterval, [this] { return m_stopping.load(); }))
+        {
+            lock.unlock();
+            if (auto current = lastWriteTimes(); current != previous)
+            {
+                previous = std::move(current);
+                Reload();
+            }
+            lock.lock();
+        }
+    }
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <tss/errors/MistakesContainer.h>
+#include <tss/sheets/StyleSheet.h>
+
+namespace Trema::Style
+{
+    // Watches a set of sheet files, reparses them on a background thread when they change and publishes the
+    // result by swapping an atomic snapshot pointer. Readers take a snapshot with Current() and never wait
+    // on a reload; a snapshot is released when the last reader drops it.
+    // Uses inotify on Linux (watching parent directories, so editors that save by renaming are seen) and
+    // polls modification times elsewhere.
+    class StyleSheetWatcher final
+    {
+    public:
+        using Listener = std::function<void(const StyleSheet& sheet, const MistakesContainer& mistakes)>;
+
+        explicit StyleSheetWatcher(std::vector<std::filesystem::path> files);
+        StyleSheetWatcher(const StyleSheetWatcher&) = delete;
+        StyleSheetWatcher& operator=(const StyleSheetWatcher&) = delete;
+        ~StyleSheetWatcher();
+
+        // Called on the watcher thread after every reload; when the files have mistakes, with the kept snapshot.
+        // Set before Start()
+        void SetListener(Listener listener) { m_listener = std::move(listener); }
+
+        // Parses the files once on the calling thread, then returns once changes are being watched
+        void Start();
+        void Stop();
+        // Reparses and publishes immediately; returns false and keeps the current snapshot if a file can't be read,
+        // is empty or has mistakes, which GetLastError() then describes until a reload succeeds
+        bool Reload();
+
+        [[nodiscard]] StyleSheet Current() const { return *m_current.load(std::memory_order_acquire); }
+        [[nodiscard]] std::uint64_t GetGeneration() const { return m_generation.load(std::memory_order_acquire); }
+        [[nodiscard]] std::string GetLastError() const;
+
+    private:
+        std::vector<std::filesystem::path> m_files;
+        std::atomic<std::shared_ptr<const StyleSheet>> m_current;
+        std::atomic<std::uint64_t> m_generation { 0 };
+        Listener m_listener;
+
+        std::thread m_thread;
+        std::atomic<bool> m_stopping { false };
+        bool m_ready { false };
+        std::mutex m_mutex;
+        std::mutex m_reloadMutex;
+        std::condition_variable m_wake;
+        mutable std::mutex m_errorMutex;
+        std::string m_lastError;
+    #ifdef __linux__
+        int m_wakePipe[2] { -1, -1 };
+    #endif
+
+        void Run();
+        void SignalReady();
+        void Watch();
+        void Poll();
+    };
+}
@@ -0,0 +1,146 @@
+#include <tss/sheets/TreeStyler.h>
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+namespace Trema::Style
+{
+    std::uint32_t ElementTree::Add(std::string id, const std::uint32_t parent)
+    {
+        if (parent != NoParent && parent >= m_ids.size())
+            throw std::out_of_range("The parent must be added before its children");
+
+        m_ids.push_back(std::move(id));
+        m_parents.push_back(parent);
+        return static_cast<std::uint32_t>(m_ids.size() - 1);
+    }
+
+    std::uint32_t StyleBuffers::FindProperty(const std::string_view property) const
+    {
+        const auto it = std::ranges::find(m_properties, property);
+        return it != m_properties.end() ? static_cast<std::uint32_t>(it - m_properties.begin()) : NotFound;
+    }
+
+    struct TreeStyler::Walk
+    {
+        const ElementTree& Tree;
+        std::vector<std::uint32_t> FirstChild; // children of e are Children[FirstChild[e], FirstChild[e + 1])
+        std::vector<std::uint32_t> Children;
+        std::vector<std::uint32_t> Sizes;      // elements in the subtree of each element
+        const Value* Global;
+        StyleBuffers& Buffers;
+        Utils::TaskGroup Group; // last, so that it waits for the tasks before the rest is destroyed
+    };
+
+    TreeStyler::TreeStyler(const SelectorMap& selectors, std::vector<std::string> properties) :
+        m_properties(std::move(properties))
+    {
+        m_rows.reserve(selectors.size() * m_properties.size());
+        for (const auto& [selector, table] : selectors)
+        {
+            m_scopes.try_emplace(selector, m_rows.size());
+            for (const auto& property : m_properties)
+            {
+                const auto value = table->FindValue(property);
+                m_rows.push_back(value ? *value : Value(std::nullopt));
+            }
+        }
+    }
+
+    StyleBuffers TreeStyler::Compute(const ElementTree& tree) const
+    {
+        return Compute(tree, Utils::ThreadPool::Default());
+    }
+
+    StyleBuffers TreeStyler::Compute(const ElementTree& tree, Utils::ThreadPool& pool) const
+    {
+        const auto count = tree.Size();
+
+        StyleBuffers buffers;
+        buffers.m_properties = m_properties;
+        buffers.m_elementCount = count;
+        buffers.m_values.assign(count * m_properties.size(), Value(std::nullopt));
+
+        Walk walk { tree, std::vector<std::uint32_t>(count + 1), std::vector<std::uint32_t>(count),
+                    std::vector<std::uint32_t>(count, 1), FindRow(""), buffers, Utils::TaskGroup(pool) };
+
+        // Parents come first, so children can be bucketed by parent and subtree sizes summed in reverse
+        for (std::uint32_t e = 0; e < count; ++e)
+        {
+            if (const auto parent = tree.GetParent(e); parent != ElementTree::NoParent)
+                ++walk.FirstChild[parent + 1];
+        }
+        std::partial_sum(walk.FirstChild.begin(), walk.FirstChild.end(), walk.FirstChild.begin());
+        auto next = walk.FirstChild;
+        for (std::uint32_t e = 0; e < count; ++e)
+        {
+            if (const auto parent = tree.GetParent(e); parent != ElementTree::NoParent)
+                walk.Children[next[parent]++] = e;
+        }
+        for (auto e = static_cast<std::uint32_t>(count); e-- > 0;)
+        {
+            if (const auto parent = tree.GetParent(e); parent != ElementTree::NoParent)
+                walk.Sizes[parent] += walk.Sizes[e];
+        }
+
+        for (std::uint32_t e = 0; e < count; ++e)
+        {
+            if (tree.GetParent(e) != ElementTree::NoParent)
+                continue;
+
+            if (walk.Sizes[e] >= TaskGrain)
+                walk.Group.Run([this, &walk, e] { StyleSubtree(walk, e); });
+            else
+                StyleSubtree(walk, e);
+        }
+        walk.Group.Wait();
+
+        return buffers;
+    }
+
+    const Value* TreeStyler::FindRow(const std::string_view id) const
+    {
+        thread_local std::string selector;
+        selector.assign("#");
+        selector.append(id);
+
+        const auto it = m_scopes.find(selector);
+        return it != m_scopes.end() ? m_rows.data() + it->second : nullptr;
+    }
+
+    void TreeStyler::StyleSubtree(Walk& walk, const std::uint32_t root) const
+    {
+        const auto count = walk.Buffers.m_elementCount;
+        auto* values = walk.Buffers.m_values.data();
+
+        std::vector<std::uint32_t> pending { root };
+        while (!pending.empty())
+        {
+            const auto e = pending.back();
+            pending.pop_back();
+
+            const auto own = walk.Tree.GetId(e).empty() ? nullptr : FindRow(walk.Tree.GetId(e));
+            const auto parent = walk.Tree.GetParent(e);
+            for (std::size_t p = 0; p < m_properties.size(); ++p)
+            {
+                auto& value = values[p * count + e];
+                if (own && !std::holds_alternative<std::nullopt_t>(own[p]))
+                    value = own[p];
+                else if (parent != ElementTree::NoParent)
+                    value = values[p * count + parent];
+                else if (walk.Global)
+                    value = walk.Global[p];
+            }
+
+            // The element is styled before its children are queued, so their tasks can read its row
+            for (auto c = walk.FirstChild[e]; c < walk.FirstChild[e + 1]; ++c)
+            {
+                const auto child = walk.Children[c];
+                if (walk.Sizes[child] >= TaskGrain)
+                    walk.Group.Run([this, &walk, child] { StyleSubtree(walk, child); });
+                else
+                    pending.push_back(child);
+            }
+        }
+    }
+}
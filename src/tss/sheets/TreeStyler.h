@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <tss/utils/ThreadPool.h>
+#include <tss/variables/SymbolTable.h>
+
+namespace Trema::Style
+{
+    // Flat element tree; every parent is added before its children
+    class ElementTree final
+    {
+    public:
+        static constexpr std::uint32_t NoParent = UINT32_MAX;
+
+        // id without '#'; returns the index of the element
+        std::uint32_t Add(std::string id, std::uint32_t parent = NoParent);
+
+        [[nodiscard]] std::size_t Size() const { return m_ids.size(); }
+        [[nodiscard]] std::string_view GetId(const std::uint32_t element) const { return m_ids[element]; }
+        [[nodiscard]] std::uint32_t GetParent(const std::uint32_t element) const { return m_parents[element]; }
+
+    private:
+        std::vector<std::string> m_ids;
+        std::vector<std::uint32_t> m_parents;
+    };
+
+    // Computed values stored one column per property: GetColumn(p)[element]. Properties that no scope of an
+    // element sets hold std::nullopt.
+    class StyleBuffers final
+    {
+    public:
+        static constexpr std::uint32_t NotFound = UINT32_MAX;
+
+        [[nodiscard]] std::span<const std::string> GetProperties() const { return m_properties; }
+        [[nodiscard]] std::uint32_t FindProperty(std::string_view property) const;
+        [[nodiscard]] std::span<const Value> GetColumn(const std::uint32_t property) const
+        {
+            return { m_values.data() + property * m_elementCount, m_elementCount };
+        }
+        [[nodiscard]] std::size_t ElementCount() const { return m_elementCount; }
+
+    private:
+        friend class TreeStyler;
+
+        std::vector<std::string> m_properties;
+        std::size_t m_elementCount { 0 };
+        std::vector<Value> m_values;
+    };
+
+    // Computes a set of properties for every element of a tree: an element takes the values of its own scope
+    // ("#id"), and inherits the others from its parent, roots inheriting from the global scope.
+    // Inherited values are read from the parent's row of the output rather than looked up again, and subtrees
+    // are styled as separate tasks on a work-stealing pool.
+    class TreeStyler final
+    {
+    public:
+        using SelectorMap = Style::SelectorMap;
+
+        // Subtrees with fewer elements are styled by the task that reaches them
+        static constexpr std::size_t TaskGrain = 512;
+
+        TreeStyler(const SelectorMap& selectors, std::vector<std::string> properties);
+
+        [[nodiscard]] StyleBuffers Compute(const ElementTree& tree) const;
+        [[nodiscard]] StyleBuffers Compute(const ElementTree& tree, Utils::ThreadPool& pool) const;
+
+    private:
+        std::vector<std::string> m_properties;
+        // Values each scope sets, std::nullopt when unset: the row of a scope starts at m_rows[m_scopes[selector]]
+        Utils::FlatHashMap<std::string, std::size_t, Utils::StringHash, std::equal_to<>> m_scopes;
+        std::vector<Value> m_rows;
+
+        struct Walk;
+
+        [[nodiscard]] const Value* FindRow(std::string_view id) const;
+        void StyleSubtree(Walk& walk, std::uint32_t root) const;
+    };
+}
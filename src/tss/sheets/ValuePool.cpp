@@ -0,0 +1,89 @@
+#include <tss/sheets/ValuePool.h>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+
+namespace Trema::Style
+{
+    std::size_t ValuePool::StoredValueHash::operator()(const Format::StoredValue& value) const
+    {
+        const auto tag = static_cast<std::uint64_t>(value.Type) << 32 | value.String;
+        return static_cast<std::size_t>(Utils::CombineHashes(Utils::MixHash(tag), Utils::MixHash(value.Bits)));
+    }
+
+    bool ValuePool::StoredValueEqual::operator()(const Format::StoredValue& a, const Format::StoredValue& b) const
+    {
+        // Strings are pooled first, so equal strings have the same offset; floats compare by their bits
+        return a.Type == b.Type && a.String == b.String && a.Bits == b.Bits;
+    }
+
+    std::uint32_t ValuePool::Add(const Value& value)
+    {
+        Format::StoredValue stored { };
+        std::visit([this, &stored]<typename T0>(T0&& arg)
+        {
+            using T = std::decay_t<T0>;
+            if constexpr (std::is_same_v<T, Float>)
+            {
+                stored.Type = Format::ValueType::Float;
+                stored.Bits = std::bit_cast<std::uint64_t>(arg);
+            }
+            else if constexpr (std::is_same_v<T, Integer>)
+            {
+                stored.Type = Format::ValueType::Integer;
+                stored.Bits = static_cast<std::uint64_t>(arg);
+            }
+            else if constexpr (std::is_same_v<T, bool>)
+            {
+                stored.Type = Format::ValueType::Bool;
+                stored.Bits = arg ? 1 : 0;
+            }
+            else if constexpr (std::is_same_v<T, StringRef>)
+            {
+                stored.Type = Format::ValueType::String;
+                stored.String = AddString(arg.View());
+            }
+            else if constexpr (std::is_same_v<T, Color>)
+            {
+                stored.Type = Format::ValueType::Color;
+                stored.Bits = arg.Rgba;
+            }
+            else
+            {
+                stored.Type = Format::ValueType::Null;
+            }
+        }, value);
+
+        ++m_statistics.ValueRequests;
+        const auto [it, inserted] = m_valueIndex.try_emplace(stored, static_cast<std::uint32_t>(m_values.size()));
+        if (inserted)
+        {
+            m_values.push_back(stored);
+            m_statistics.Values = m_values.size();
+        }
+        return it->second;
+    }
+
+    std::uint32_t ValuePool::AddString(const std::string_view string)
+    {
+        ++m_statistics.StringRequests;
+        if (const auto it = m_stringIndex.find(string); it != m_stringIndex.end())
+            return it->second;
+
+        // Record: uint32_t length, characters, '\0', padded to 4 bytes
+        const auto offset = m_strings.size();
+        if (offset > UINT32_MAX || string.size() > UINT32_MAX)
+            throw std::length_error("Too many strings for a style image");
+
+        const auto size = static_cast<std::uint32_t>(string.size());
+        const auto recordSize = (sizeof(size) + string.size() + 1 + 3) & ~std::size_t { 3 };
+        m_strings.resize(m_strings.size() + recordSize, std::byte { 0 });
+        std::memcpy(m_strings.data() + offset, &size, sizeof(size));
+        std::memcpy(m_strings.data() + offset + sizeof(size), string.data(), string.size());
+
+        m_stringIndex.try_emplace(std::string(string), static_cast<std::uint32_t>(offset));
+        m_statistics.Strings = m_stringIndex.size();
+        m_statistics.StringBytes = m_strings.size();
+        return static_cast<std::uint32_t>(offset);
+    }
+}
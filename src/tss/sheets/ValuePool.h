@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <tss/sheets/FrozenStyleFormat.h>
+#include <tss/tokenization/TokenValue.h>
+#include <tss/utils/FlatHashMap.h>
+#include <tss/utils/Hashing.h>
+
+namespace Trema::Style
+{
+    // Hash-conses the values and strings of a frozen image while it is built. Equal values share one stored
+    // record and every string is written once, whether it names a selector or a property or is itself a value.
+    class ValuePool final
+    {
+    public:
+        struct Statistics
+        {
+            std::size_t ValueRequests { 0 };
+            std::size_t Values { 0 };
+            std::size_t StringRequests { 0 };
+            std::size_t Strings { 0 };
+            std::size_t StringBytes { 0 }; // size of the string section, records included
+        };
+
+        // Index of the value's record
+        std::uint32_t Add(const Value& value);
+        // Offset of the string's record in the string section
+        std::uint32_t AddString(std::string_view string);
+
+        [[nodiscard]] const std::vector<Format::StoredValue>& GetValues() const { return m_values; }
+        [[nodiscard]] const std::vector<std::byte>& GetStrings() const { return m_strings; }
+        [[nodiscard]] const Statistics& GetStatistics() const { return m_statistics; }
+
+    private:
+        struct StoredValueHash
+        {
+            std::size_t operator()(const Format::StoredValue& value) const;
+        };
+
+        struct StoredValueEqual
+        {
+            bool operator()(const Format::StoredValue& a, const Format::StoredValue& b) const;
+        };
+
+        std::vector<Format::StoredValue> m_values;
+        std::vector<std::byte> m_strings;
+        Utils::FlatHashMap<Format::StoredValue, std::uint32_t, StoredValueHash, StoredValueEqual> m_valueIndex;
+        Utils::FlatHashMap<std::string, std::uint32_t, Utils::StringHash, std::equal_to<>> m_stringIndex;
+        Statistics m_statistics;
+    };
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Trema::Style
+{
+    // Straight (not premultiplied) sRGB colour packed as 0xRRGGBBAA, the way sheets write it
+    struct Color
+    {
+        std::uint32_t Rgba { 0 };
+
+        [[nodiscard]] static constexpr Color FromChannels(const std::uint8_t r, const std::uint8_t g, const std::uint8_t b,
+                                                          const std::uint8_t a)
+        {
+            return { static_cast<std::uint32_t>(r) << 24 | static_cast<std::uint32_t>(g) << 16 |
+                     static_cast<std::uint32_t>(b) << 8 | a };
+        }
+
+        [[nodiscard]] constexpr std::uint8_t R() const { return static_cast<std::uint8_t>(Rgba >> 24); }
+        [[nodiscard]] constexpr std::uint8_t G() const { return static_cast<std::uint8_t>(Rgba >> 16); }
+        [[nodiscard]] constexpr std::uint8_t B() const { return static_cast<std::uint8_t>(Rgba >> 8); }
+        [[nodiscard]] constexpr std::uint8_t A() const { return static_cast<std::uint8_t>(Rgba); }
+
+        friend constexpr bool operator==(Color, Color) = default;
+    };
+}
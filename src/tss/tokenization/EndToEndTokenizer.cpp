@@ -1,3 +1,4 @@
+#include <cctype>
 #include <format>
 #include <utility>
 #include <tss/tokenization/EndToEndTokenizer.h>
@@ -41,14 +42,14 @@ namespace Trema::Style
             return true;
 
         if ((lastType == TokenType::LeftParenthesis || lastType == TokenType::VariableAssignment || lastType ==
-            TokenType::PropertyAssignment) && string[0] == '-' && std::isdigit(string[1]))
+            TokenType::PropertyAssignment || lastType == TokenType::Operator) && string[0] == '-' && std::isdigit(string[1]))
             return true;
 
         if (string[2] == '\0')
             return false;
 
         if ((lastType == TokenType::LeftParenthesis || lastType == TokenType::PropertyAssignment || lastType ==
-                TokenType::VariableAssignment) &&
+                TokenType::VariableAssignment || lastType == TokenType::Operator) &&
             string[0] == '-' &&
             string[1] == '.' &&
             std::isdigit(string[2]))
@@ -90,6 +91,25 @@ namespace Trema::Style
         return val;
     }
 
+    std::optional<Color> EndToEndTokenizer::ColorFromHex(const std::string_view string)
+    {
+        // Exactly eight digits, 0xRRGGBBAA; other hexadecimal literals stay integers
+        constexpr std::size_t Length = 10;
+        if (string.size() < Length || string[0] != '0' || (string[1] != 'x' && string[1] != 'X') ||
+            (string.size() > Length && std::isxdigit(static_cast<unsigned char>(string[Length]))))
+            return std::nullopt;
+
+        std::uint32_t rgba = 0;
+        for (std::size_t i = 2; i < Length; ++i)
+        {
+            const char c = string[i];
+            if (!std::isxdigit(static_cast<unsigned char>(c)))
+                return std::nullopt;
+            rgba = rgba << 4 | static_cast<std::uint32_t>(std::isdigit(static_cast<unsigned char>(c)) ? c - '0' : (c | 0x20) - 'a' + 10);
+        }
+        return Color { rgba };
+    }
+
     bool EndToEndTokenizer::IsAllowedIdentifierStartChar(const char c)
     {
         switch (c)
@@ -120,6 +140,7 @@ namespace Trema::Style
         case '}':
         case '=':
         case '#':
+        case ',':
         case '*':
         case '/':
         case ' ':
@@ -149,6 +170,7 @@ namespace Trema::Style
         case '}':
         case '=':
         case '#':
+        case ',':
         case '*':
         case '/':
         case ' ':
@@ -208,11 +230,20 @@ namespace Trema::Style
                 return ParseSingleCharToken(pos, TokenType::VariableAssignment);
             if (c == '#')
                 return ParseSingleCharToken(pos, TokenType::Identity);
+            if (c == ',')
+                return ParseSingleCharToken(pos, TokenType::Comma);
+            if (c == '@')
+                return ParseDirective(pos);
+            if (c == '.' && pos + 1 < m_code.size() && IsAllowedIdentifierStartChar(m_code[pos + 1]))
+                return ParseSingleCharToken(pos, TokenType::Class);
+            if (c == '*' && IsInSelector(pos))
+                return ParseSingleCharToken(pos, TokenType::Universal);
             if (c == '\'' || c == '"')
                 return ParseStringLiteral(pos, mistakes);
             if (IsCommentStart(m_code.substr(pos)))
                 return ParseComment(pos);
-            if (IsOperator(c))
+            // A '-' starting an operand is the sign of a number ("-5", "2 * -3"), not a subtraction
+            if (IsOperator(c) && (c != '-' || !IsFloatNumber(m_code.substr(pos), m_lastType)))
                 return ParseOperator(pos);
             if (IsAllowedIdentifierStartChar(c))
                 return ParseIdentifier(pos);
@@ -242,6 +273,13 @@ namespace Trema::Style
         }
     }
 
+    bool EndToEndTokenizer::IsInSelector(const unsigned int pos) const
+    {
+        // A selector runs up to a block, an expression up to the end of its statement or block
+        const auto end = m_code.find_first_of("{;}", pos + 1);
+        return end != std::string_view::npos && m_code[end] == '{';
+    }
+
     Token EndToEndTokenizer::ParseSingleCharToken(unsigned int& pos, TokenType type)
     {
         m_lastType = type;
@@ -268,7 +306,7 @@ namespace Trema::Style
             }
         }
         l -= pos;
-        auto symbol = std::string(m_code.substr(pos + 1, l - 1));
+        const StringRef symbol(m_code.substr(pos + 1, l - 1));
         Token t(TokenType::LiteralString, m_linePos, m_line, symbol);
         m_cursor = pos + l + 1;
         m_linePos += l + 1;
@@ -290,7 +328,7 @@ namespace Trema::Style
             l++;
         }
         l -= pos;
-        auto symbol = std::string(m_code.substr(pos + 2, l - 2));
+        const StringRef symbol(m_code.substr(pos + 2, l - 2));
         Token t(TokenType::Comment, m_linePos, m_line, symbol);
         m_cursor = pos + l + 2;
         m_linePos += l + 2;
@@ -304,7 +342,7 @@ namespace Trema::Style
         m_lastType = TokenType::Operator;
         m_cursor = pos + 1;
         m_linePos++;
-        std::string symbol(std::format("{}\0", c));
+        const StringRef symbol(std::string_view(&c, 1));
         Token t(TokenType::Operator, m_linePos, m_line, symbol);
         return t;
     }
@@ -317,7 +355,7 @@ namespace Trema::Style
             l++;
         }
         l -= pos;
-        const auto symbol = std::string(m_code.substr(pos, l));
+        const auto symbol = m_code.substr(pos, l);
         if (IsBoolValue(symbol))
         {
             const bool val = symbol == "true";
@@ -327,24 +365,50 @@ namespace Trema::Style
             m_lastType = TokenType::LiteralBool;
             return t;
         }
-        Token t(TokenType::Identifier, m_linePos, m_line, symbol);
+        Token t(TokenType::Identifier, m_linePos, m_line, StringRef(symbol));
         m_cursor = pos + l;
         m_linePos += l;
         m_lastType = TokenType::Identifier;
         return t;
     }
 
+    Token EndToEndTokenizer::ParseDirective(unsigned int& pos)
+    {
+        unsigned int l = pos + 1;
+        while (m_code.size() > l && IsAllowedIdentifierChar(m_code[l]))
+        {
+            l++;
+        }
+        l -= pos;
+        Token t(TokenType::Directive, m_linePos, m_line, StringRef(m_code.substr(pos + 1, l - 1)));
+        m_cursor = pos + l;
+        m_linePos += l;
+        m_lastType = TokenType::Directive;
+        return t;
+    }
+
     Token EndToEndTokenizer::ParseNumber(unsigned int& pos)
     {
         const std::string_view offset = m_code.substr(pos);
+        if (const auto color = ColorFromHex(offset))
+        {
+            m_linePos += 10;
+            pos += 10;
+            Token t(TokenType::LiteralColor, m_linePos, m_line, *color);
+            m_cursor = pos;
+            m_lastType = TokenType::LiteralColor;
+            return t;
+        }
+
         double intPart;
         char* end;
         double fValue = strtod(offset.data(), &end);
         const auto endIndex = end - offset.data();
         m_linePos += endIndex;
         pos += endIndex;
+        // Whole numbers out of the range of Integer stay floats: converting them would be undefined
         if (const double fractPart = modf(fValue, &intPart);
-            fractPart == 0 || IsHexNumber(offset))
+            (fractPart == 0 || IsHexNumber(offset)) && intPart >= -9223372036854775808.0 && intPart < 9223372036854775808.0)
         {
             Token t(TokenType::LiteralNumber, m_linePos, m_line, static_cast<int64_t>(intPart));
             m_cursor = pos;
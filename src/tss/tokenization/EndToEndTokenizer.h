@@ -1,6 +1,7 @@
 #pragma once
 
 #include <deque>
+#include <optional>
 #include <tss/tokenization/ITokenizer.h>
 #include <tss/tokenization/TokenType.h>
 #include <tss/errors/MistakesContainer.h>
@@ -39,13 +40,16 @@ namespace Trema
             Token ParseComment(unsigned int& pos);
             Token ParseOperator(unsigned int& pos);
             Token ParseIdentifier(unsigned int& pos);
+            Token ParseDirective(unsigned int& pos);
             Token ParseNumber(unsigned int& pos);
             void HandleUnknownToken(unsigned int& pos, MistakesContainer& mistakes);
+            [[nodiscard]] bool IsInSelector(unsigned int pos) const;
 
             [[nodiscard]] static bool IsOperator(char c);
             [[nodiscard]] static bool IsAllowedIdentifierChar(char c);
             [[nodiscard]] static bool IsAllowedIdentifierStartChar(char c);
             [[nodiscard]] static Integer IntFromHex(std::string_view string);
+            [[nodiscard]] static std::optional<Color> ColorFromHex(std::string_view string);
             [[nodiscard]] static bool IsBoolValue(std::string_view string);
             [[nodiscard]] static bool IsHexNumber(std::string_view string);
             [[nodiscard]] static bool IsFloatNumber(std::string_view string, TokenType lastType);
@@ -0,0 +1,122 @@
+#include <tss/tokenization/StringRef.h>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <unordered_set>
+#include <vector>
+
+namespace Trema::Style
+{
+    namespace
+    {
+        struct EmptyRecord
+        {
+            std::uint32_t Size { 0 };
+            char Data[4] { };
+        };
+
+        constexpr EmptyRecord EmptyString;
+
+        class StringPool final
+        {
+        public:
+            const char* Intern(const std::string_view string)
+            {
+                if (string.empty())
+                    return EmptyString.Data;
+
+                {
+                    std::shared_lock lock(m_mutex);
+                    if (const auto it = m_strings.find(string); it != m_strings.end())
+                        return it->data();
+                }
+
+                std::unique_lock lock(m_mutex);
+                if (const auto it = m_strings.find(string); it != m_strings.end())
+                    return it->data();
+
+                const auto data = Allocate(string);
+                m_strings.emplace(data, string.size());
+                return data;
+            }
+
+            std::size_t InternedBytes()
+            {
+                std::shared_lock lock(m_mutex);
+                return m_interned;
+            }
+
+        private:
+            static constexpr std::size_t BlockSize = 64 * 1024;
+
+            char* Allocate(const std::string_view string)
+            {
+                if (string.size() > UINT32_MAX)
+                    throw std::length_error("String too long to be interned");
+
+                const auto recordSize = (sizeof(std::uint32_t) + string.size() + 1 + 3) & ~std::size_t { 3 };
+                char* record;
+                if (recordSize > BlockSize / 4)
+                {
+                    // Large strings get a block of their own so they don't waste the tail of the current one
+                    m_blocks.push_back(std::make_unique<char[]>(recordSize));
+                    record = m_blocks.back().get();
+                }
+                else
+                {
+                    if (m_used + recordSize > BlockSize)
+                    {
+                        if (m_current)
+                            m_blocks.push_back(std::move(m_current));
+                        m_current = std::make_unique<char[]>(BlockSize);
+                        m_used = 0;
+                    }
+                    record = m_current.get() + m_used;
+                    m_used += recordSize;
+                }
+
+                m_interned += recordSize;
+                const auto size = static_cast<std::uint32_t>(string.size());
+                std::memcpy(record, &size, sizeof(size));
+                std::memcpy(record + sizeof(size), string.data(), string.size());
+                record[sizeof(size) + string.size()] = '\0';
+                return record + sizeof(size);
+            }
+
+            std::shared_mutex m_mutex;
+            std::unordered_set<std::string_view> m_strings;
+            std::vector<std::unique_ptr<char[]>> m_blocks;
+            std::unique_ptr<char[]> m_current;
+            std::size_t m_used { BlockSize };
+            std::size_t m_interned { 0 };
+        };
+
+        StringPool& GetPool()
+        {
+            // Intentionally leaked: handles may still be read by static destructors at exit
+            static auto* pool = new StringPool();
+            return *pool;
+        }
+    }
+
+    StringRef::StringRef() :
+        m_data(EmptyString.Data)
+    {
+    }
+
+    StringRef::StringRef(const std::string_view string) :
+        m_data(GetPool().Intern(string))
+    {
+    }
+
+    std::size_t StringRef::InternedBytes()
+    {
+        return GetPool().InternedBytes();
+    }
+
+    std::ostream& operator<<(std::ostream& os, const StringRef string)
+    {
+        return os << string.View();
+    }
+}
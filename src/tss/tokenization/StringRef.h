@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace Trema::Style
+{
+    // Trivially copyable handle on an immutable string record laid out as a 32-bit length, the characters
+    // and a null terminator. Records are interned in a process-wide pool and are never freed, so handles
+    // can be copied around freely without any allocation or ownership tracking.
+    class StringRef final
+    {
+    public:
+        StringRef();
+        StringRef(std::string_view string);
+        StringRef(const std::string& string) : StringRef(std::string_view(string)) {}
+        StringRef(const char* string) : StringRef(std::string_view(string)) {}
+
+        [[nodiscard]] static StringRef Intern(std::string_view string) { return StringRef(string); }
+        // Bytes taken by the records of the pool. It only grows with strings it has never seen: parsing the same
+        // sheet again adds nothing, but every edited string, identifier or comment reloaded stays until exit.
+        [[nodiscard]] static std::size_t InternedBytes();
+
+        [[nodiscard]] const char* Data() const { return m_data; }
+        [[nodiscard]] const char* CStr() const { return m_data; }
+        [[nodiscard]] std::size_t Size() const
+        {
+            std::uint32_t size;
+            std::memcpy(&size, m_data - sizeof(size), sizeof(size));
+            return size;
+        }
+        [[nodiscard]] bool Empty() const { return Size() == 0; }
+        [[nodiscard]] std::string_view View() const { return { m_data, Size() }; }
+        [[nodiscard]] std::string Str() const { return std::string(View()); }
+
+        operator std::string_view() const { return View(); }
+
+        friend bool operator==(const StringRef a, const StringRef b) { return a.m_data == b.m_data || a.View() == b.View(); }
+        friend bool operator==(const StringRef a, const std::string_view b) { return a.View() == b; }
+        friend bool operator==(const StringRef a, const std::string& b) { return a.View() == b; }
+        friend bool operator==(const StringRef a, const char* b) { return a.View() == b; }
+
+        friend std::ostream& operator<<(std::ostream& os, StringRef string);
+
+    private:
+        const char* m_data;
+    };
+}
+
+template<>
+struct std::hash<Trema::Style::StringRef>
+{
+    std::size_t operator()(const Trema::Style::StringRef string) const noexcept
+    {
+        return std::hash<std::string_view>{}(string.View());
+    }
+};
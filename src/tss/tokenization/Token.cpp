@@ -88,6 +88,21 @@ namespace Trema::Style
         case TokenType::Operator:
             ss << "Operator ('" << ValueAsString() << "'):";
             break;
+        case TokenType::Directive:
+            ss << "Directive ('@" << ValueAsString() << "'):";
+            break;
+        case TokenType::Class:
+            ss << "Class ('.'):";
+            break;
+        case TokenType::Universal:
+            ss << "Universal ('*'):";
+            break;
+        case TokenType::Comma:
+            ss << "Comma (','):";
+            break;
+        case TokenType::LiteralColor:
+            ss << "Color ('" << ValueAsString() << "'):";
+            break;
         }
         ss << GetPosition() << ">\n";
         auto str = ss.str();
@@ -21,6 +21,11 @@ namespace Trema
             LiteralBool = 13,
             Comment = 14, // /* */
             Operator = 15, // + - * / %
+            Directive = 16, // @name
+            Class = 17, // . before a class name
+            Universal = 18, // * in a selector
+            Comma = 19, // , between the selectors of a list
+            LiteralColor = 20, // 0xRRGGBBAA
             EndOfCode = -1 // End of expression
         };
     }
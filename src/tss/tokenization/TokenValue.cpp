@@ -1,4 +1,5 @@
 #include <tss/tokenization/TokenValue.h>
+#include <format>
 
 namespace Trema
 {
@@ -16,8 +17,10 @@ namespace Trema
                         return std::to_string(arg);
                     else if constexpr (std::is_same_v<T, bool>)
                         return arg ? "true" : "false";
-                    else if constexpr (std::is_same_v<T, std::string>)
-                        return arg;
+                    else if constexpr (std::is_same_v<T, StringRef>)
+                        return arg.Str();
+                    else if constexpr (std::is_same_v<T, Color>)
+                        return std::format("0x{:08X}", arg.Rgba);
                     else
                         return "null";
                 },
@@ -1,8 +1,12 @@
 #pragma once
 #include <cstdint>
 #include <optional>
+#include <type_traits>
 #include <variant>
 #include <string>
+#include <string_view>
+#include <tss/tokenization/Color.h>
+#include <tss/tokenization/StringRef.h>
 
 namespace Trema
 {
@@ -11,9 +15,34 @@ namespace Trema
         using Float = double;
         using Integer = int64_t;
 
-        using Value = std::variant<Float, Integer, bool, std::string, std::nullopt_t>;
+        using Value = std::variant<Float, Integer, bool, StringRef, Color, std::nullopt_t>;
         using TokenValue = Value;
 
+        static_assert(sizeof(Value) <= 16, "Value must fit in 16 bytes");
+        static_assert(std::is_trivially_copyable_v<Value>, "Value must be trivially copyable");
+
         std::string GetIdentity(const Value &tokenValue);
+
+        // Typed read of a value that neither allocates nor throws: empty when there is no value or it holds
+        // another type. std::string_view borrows the characters of the value's StringRef.
+        template<typename T>
+        [[nodiscard]] std::optional<T> TryGet(const Value* value) noexcept
+        {
+            if (!value)
+                return std::nullopt;
+
+            if constexpr (std::is_same_v<T, std::string_view>)
+            {
+                if (const auto string = std::get_if<StringRef>(value))
+                    return string->View();
+                return std::nullopt;
+            }
+            else
+            {
+                if (const auto typed = std::get_if<T>(value))
+                    return *typed;
+                return std::nullopt;
+            }
+        }
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Trema::Utils
+{
+    // Counting Bloom filter over precomputed 64-bit hashes: MayContain can give false positives, never false
+    // negatives. Counters make Erase possible, so the filter can follow a walk down a tree and back up; a
+    // counter that saturates stays set.
+    template<std::size_t Bits = 12>
+    class BloomFilter final
+    {
+    public:
+        static constexpr std::size_t Size = std::size_t { 1 } << Bits;
+
+        void Insert(const std::uint64_t hash)
+        {
+            Increment(m_counters[First(hash)]);
+            Increment(m_counters[Second(hash)]);
+        }
+
+        void Erase(const std::uint64_t hash)
+        {
+            Decrement(m_counters[First(hash)]);
+            Decrement(m_counters[Second(hash)]);
+        }
+
+        [[nodiscard]] bool MayContain(const std::uint64_t hash) const
+        {
+            return m_counters[First(hash)] && m_counters[Second(hash)];
+        }
+
+        void Clear() { m_counters.fill(0); }
+
+    private:
+        static constexpr std::uint8_t Saturated = UINT8_MAX;
+
+        std::array<std::uint8_t, Size> m_counters { };
+
+        static std::size_t First(const std::uint64_t hash) { return hash & (Size - 1); }
+        static std::size_t Second(const std::uint64_t hash) { return (hash >> 32) & (Size - 1); }
+
+        static void Increment(std::uint8_t& counter)
+        {
+            if (counter != Saturated)
+                ++counter;
+        }
+
+        static void Decrement(std::uint8_t& counter)
+        {
+            if (counter != Saturated && counter != 0)
+                --counter;
+        }
+    };
+
+    // Plain Bloom filter sized at construction for an expected number of hashes, about 16 bits each; hashes can't be
+    // removed. Lookups test 3 bits taken from the hash by double hashing.
+    class BitBloomFilter final
+    {
+    public:
+        BitBloomFilter() : BitBloomFilter(0) { }
+        explicit BitBloomFilter(const std::size_t expected) :
+            m_words(std::bit_ceil(std::max<std::size_t>(expected * 16, 64)) / 64),
+            m_mask(m_words.size() * 64 - 1)
+        {
+        }
+
+        void Insert(const std::uint64_t hash)
+        {
+            for (std::uint64_t i = 0; i < Probes; ++i)
+            {
+                const auto bit = Probe(hash, i);
+                m_words[bit / 64] |= std::uint64_t { 1 } << (bit % 64);
+            }
+        }
+
+        [[nodiscard]] bool MayContain(const std::uint64_t hash) const
+        {
+            for (std::uint64_t i = 0; i < Probes; ++i)
+            {
+                const auto bit = Probe(hash, i);
+                if (!(m_words[bit / 64] & (std::uint64_t { 1 } << (bit % 64))))
+                    return false;
+            }
+            return true;
+        }
+
+        [[nodiscard]] std::size_t SizeInBytes() const { return m_words.size() * sizeof(std::uint64_t); }
+
+    private:
+        static constexpr std::uint64_t Probes = 3;
+
+        std::vector<std::uint64_t> m_words;
+        std::uint64_t m_mask;
+
+        [[nodiscard]] std::uint64_t Probe(const std::uint64_t hash, const std::uint64_t i) const
+        {
+            return ((hash >> 32) + i * ((hash & 0xFFFFFFFF) | 1)) & m_mask;
+        }
+    };
+}
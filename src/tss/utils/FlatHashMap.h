@@ -0,0 +1,396 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TSS_FLAT_HASH_MAP_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace Trema::Utils
+{
+    namespace Detail
+    {
+        using ControlByte = std::int8_t;
+
+        // Control bytes: full slots hold the 7 low bits of their hash, free slots have the sign bit set
+        constexpr ControlByte EmptyControl = -128;
+        constexpr ControlByte DeletedControl = -2;
+        constexpr std::size_t GroupWidth = 16;
+
+        class ControlGroup final
+        {
+        public:
+            explicit ControlGroup(const ControlByte* ctrl)
+            {
+            #if TSS_FLAT_HASH_MAP_SSE2
+                m_ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl));
+            #else
+                std::memcpy(m_ctrl, ctrl, GroupWidth);
+            #endif
+            }
+
+            [[nodiscard]] std::uint32_t Match(const ControlByte h2) const
+            {
+            #if TSS_FLAT_HASH_MAP_SSE2
+                return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), m_ctrl)));
+            #else
+                std::uint32_t mask = 0;
+                for (std::size_t i = 0; i < GroupWidth; ++i)
+                    mask |= static_cast<std::uint32_t>(m_ctrl[i] == h2) << i;
+                return mask;
+            #endif
+            }
+
+            [[nodiscard]] std::uint32_t MatchEmpty() const { return Match(EmptyControl); }
+
+            [[nodiscard]] std::uint32_t MatchFree() const
+            {
+            #if TSS_FLAT_HASH_MAP_SSE2
+                return static_cast<std::uint32_t>(_mm_movemask_epi8(m_ctrl));
+            #else
+                std::uint32_t mask = 0;
+                for (std::size_t i = 0; i < GroupWidth; ++i)
+                    mask |= static_cast<std::uint32_t>(m_ctrl[i] < 0) << i;
+                return mask;
+            #endif
+            }
+
+        private:
+        #if TSS_FLAT_HASH_MAP_SSE2
+            __m128i m_ctrl;
+        #else
+            ControlByte m_ctrl[GroupWidth];
+        #endif
+        };
+    }
+
+    // Open-addressing hash map storing keys and values inline (Swiss table layout): one control byte per
+    // slot, probed 16 at a time, so most lookups touch a single control group and a single slot.
+    // Lookups are heterogeneous when Hasher and KeyEqual are transparent.
+    template<typename Key, typename T, typename Hasher = std::hash<Key>, typename KeyEqual = std::equal_to<>>
+    class FlatHashMap final
+    {
+    public:
+        using key_type = Key;
+        using mapped_type = T;
+        using value_type = std::pair<Key, T>;
+        using size_type = std::size_t;
+
+        template<bool Const>
+        class Iterator final
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = FlatHashMap::value_type;
+            using difference_type = std::ptrdiff_t;
+            using pointer = std::conditional_t<Const, const value_type*, value_type*>;
+            using reference = std::conditional_t<Const, const value_type&, value_type&>;
+
+            Iterator() = default;
+            Iterator(const Detail::ControlByte* ctrl, const Detail::ControlByte* end, pointer slot) :
+                m_ctrl(ctrl), m_end(end), m_slot(slot)
+            {
+                SkipFree();
+            }
+
+            operator Iterator<true>() const { return Iterator<true>(m_ctrl, m_end, m_slot); }
+
+            reference operator*() const { return *m_slot; }
+            pointer operator->() const { return m_slot; }
+
+            Iterator& operator++()
+            {
+                ++m_ctrl;
+                ++m_slot;
+                SkipFree();
+                return *this;
+            }
+
+            Iterator operator++(int)
+            {
+                auto copy = *this;
+                ++*this;
+                return copy;
+            }
+
+            friend bool operator==(const Iterator& a, const Iterator& b) { return a.m_ctrl == b.m_ctrl; }
+
+        private:
+            void SkipFree()
+            {
+                while (m_ctrl != m_end && *m_ctrl < 0)
+                {
+                    ++m_ctrl;
+                    ++m_slot;
+                }
+            }
+
+            const Detail::ControlByte* m_ctrl { nullptr };
+            const Detail::ControlByte* m_end { nullptr };
+            pointer m_slot { nullptr };
+        };
+
+        using iterator = Iterator<false>;
+        using const_iterator = Iterator<true>;
+
+        FlatHashMap() = default;
+
+        FlatHashMap(const FlatHashMap& other) :
+            m_hasher(other.m_hasher), m_equal(other.m_equal)
+        {
+            reserve(other.m_size);
+            for (const auto& slot : other)
+                InsertUnique(m_hasher(slot.first), slot);
+        }
+
+        FlatHashMap(FlatHashMap&& other) noexcept
+        {
+            swap(other);
+        }
+
+        FlatHashMap& operator=(FlatHashMap other) noexcept
+        {
+            swap(other);
+            return *this;
+        }
+
+        ~FlatHashMap()
+        {
+            DestroySlots();
+            Deallocate(m_ctrl, m_slots, m_capacity);
+        }
+
+        void swap(FlatHashMap& other) noexcept
+        {
+            std::swap(m_ctrl, other.m_ctrl);
+            std::swap(m_slots, other.m_slots);
+            std::swap(m_capacity, other.m_capacity);
+            std::swap(m_size, other.m_size);
+            std::swap(m_growthLeft, other.m_growthLeft);
+            std::swap(m_hasher, other.m_hasher);
+            std::swap(m_equal, other.m_equal);
+        }
+
+        [[nodiscard]] iterator begin() { return iterator(m_ctrl, m_ctrl + m_capacity, m_slots); }
+        [[nodiscard]] iterator end() { return iterator(m_ctrl + m_capacity, m_ctrl + m_capacity, m_slots + m_capacity); }
+        [[nodiscard]] const_iterator begin() const { return const_iterator(m_ctrl, m_ctrl + m_capacity, m_slots); }
+        [[nodiscard]] const_iterator end() const { return const_iterator(m_ctrl + m_capacity, m_ctrl + m_capacity, m_slots + m_capacity); }
+
+        [[nodiscard]] size_type size() const { return m_size; }
+        [[nodiscard]] bool empty() const { return m_size == 0; }
+        [[nodiscard]] size_type capacity() const { return m_capacity; }
+
+        void clear()
+        {
+            DestroySlots();
+            if (m_capacity)
+                std::memset(m_ctrl, Detail::EmptyControl, m_capacity + Detail::GroupWidth);
+            m_size = 0;
+            m_growthLeft = MaxLoad(m_capacity);
+        }
+
+        void reserve(const size_type count)
+        {
+            if (count > MaxLoad(m_capacity))
+                Rehash(CapacityFor(count));
+        }
+
+        template<typename K>
+        [[nodiscard]] iterator find(const K& key)
+        {
+            const auto index = FindIndex(key, m_hasher(key));
+            return index == NotFound ? end() : IteratorAt(index);
+        }
+
+        template<typename K>
+        [[nodiscard]] const_iterator find(const K& key) const
+        {
+            const auto index = FindIndex(key, m_hasher(key));
+            return index == NotFound ? end() : const_iterator(m_ctrl + index, m_ctrl + m_capacity, m_slots + index);
+        }
+
+        template<typename K>
+        [[nodiscard]] bool contains(const K& key) const { return FindIndex(key, m_hasher(key)) != NotFound; }
+
+        template<typename K, typename... Args>
+        std::pair<iterator, bool> try_emplace(K&& key, Args&&... args)
+        {
+            const auto hash = m_hasher(key);
+            if (const auto index = FindIndex(key, hash); index != NotFound)
+                return { IteratorAt(index), false };
+
+            const auto index = InsertUnique(hash, std::piecewise_construct,
+                                            std::forward_as_tuple(std::forward<K>(key)),
+                                            std::forward_as_tuple(std::forward<Args>(args)...));
+            return { IteratorAt(index), true };
+        }
+
+        template<typename K, typename V>
+        std::pair<iterator, bool> insert_or_assign(K&& key, V&& value)
+        {
+            auto result = try_emplace(std::forward<K>(key), std::forward<V>(value));
+            if (!result.second)
+                result.first->second = std::forward<V>(value);
+            return result;
+        }
+
+        template<typename K>
+        size_type erase(const K& key)
+        {
+            const auto index = FindIndex(key, m_hasher(key));
+            if (index == NotFound)
+                return 0;
+
+            std::destroy_at(m_slots + index);
+            SetControl(index, Detail::DeletedControl);
+            --m_size;
+            return 1;
+        }
+
+    private:
+        static constexpr size_type NotFound = static_cast<size_type>(-1);
+
+        Detail::ControlByte* m_ctrl { nullptr };
+        value_type* m_slots { nullptr };
+        size_type m_capacity { 0 };
+        size_type m_size { 0 };
+        size_type m_growthLeft { 0 };
+        [[no_unique_address]] Hasher m_hasher;
+        [[no_unique_address]] KeyEqual m_equal;
+
+        static size_type MaxLoad(const size_type capacity) { return capacity - capacity / 8; }
+
+        static size_type CapacityFor(const size_type count)
+        {
+            size_type capacity = Detail::GroupWidth;
+            while (MaxLoad(capacity) < count)
+                capacity *= 2;
+            return capacity;
+        }
+
+        static size_type H1(const size_type hash) { return hash >> 7; }
+        static Detail::ControlByte H2(const size_type hash) { return static_cast<Detail::ControlByte>(hash & 0x7F); }
+
+        iterator IteratorAt(const size_type index)
+        {
+            return iterator(m_ctrl + index, m_ctrl + m_capacity, m_slots + index);
+        }
+
+        template<typename K>
+        size_type FindIndex(const K& key, const size_type hash) const
+        {
+            if (m_capacity == 0)
+                return NotFound;
+
+            const auto mask = m_capacity - 1;
+            const auto h2 = H2(hash);
+            auto pos = H1(hash) & mask;
+            for (size_type step = Detail::GroupWidth;; step += Detail::GroupWidth)
+            {
+                const Detail::ControlGroup group(m_ctrl + pos);
+                for (auto bits = group.Match(h2); bits; bits &= bits - 1)
+                {
+                    const auto index = (pos + std::countr_zero(bits)) & mask;
+                    if (m_equal(m_slots[index].first, key))
+                        return index;
+                }
+
+                if (group.MatchEmpty())
+                    return NotFound;
+
+                pos = (pos + step) & mask;
+            }
+        }
+
+        size_type FindFreeIndex(const size_type hash) const
+        {
+            const auto mask = m_capacity - 1;
+            auto pos = H1(hash) & mask;
+            for (size_type step = Detail::GroupWidth;; step += Detail::GroupWidth)
+            {
+                if (const auto bits = Detail::ControlGroup(m_ctrl + pos).MatchFree())
+                    return (pos + std::countr_zero(bits)) & mask;
+
+                pos = (pos + step) & mask;
+            }
+        }
+
+        template<typename... Args>
+        size_type InsertUnique(const size_type hash, Args&&... args)
+        {
+            if (m_growthLeft == 0)
+                Rehash(CapacityFor(m_size + 1));
+
+            const auto index = FindFreeIndex(hash);
+            if (m_ctrl[index] == Detail::EmptyControl)
+                --m_growthLeft;
+
+            std::construct_at(m_slots + index, std::forward<Args>(args)...);
+            SetControl(index, H2(hash));
+            ++m_size;
+            return index;
+        }
+
+        void SetControl(const size_type index, const Detail::ControlByte value)
+        {
+            m_ctrl[index] = value;
+            // The first group is mirrored after the end so probes can load 16 bytes from any position
+            if (index < Detail::GroupWidth)
+                m_ctrl[m_capacity + index] = value;
+        }
+
+        void Rehash(const size_type capacity)
+        {
+            auto* const oldCtrl = m_ctrl;
+            auto* const oldSlots = m_slots;
+            const auto oldCapacity = m_capacity;
+
+            m_ctrl = new Detail::ControlByte[capacity + Detail::GroupWidth];
+            m_slots = std::allocator<value_type>().allocate(capacity);
+            m_capacity = capacity;
+            m_size = 0;
+            m_growthLeft = MaxLoad(capacity);
+            std::memset(m_ctrl, Detail::EmptyControl, capacity + Detail::GroupWidth);
+
+            for (size_type i = 0; i < oldCapacity; ++i)
+            {
+                if (oldCtrl[i] < 0)
+                    continue;
+
+                InsertUnique(m_hasher(oldSlots[i].first), std::move(oldSlots[i]));
+                std::destroy_at(oldSlots + i);
+            }
+
+            Deallocate(oldCtrl, oldSlots, oldCapacity);
+        }
+
+        void DestroySlots()
+        {
+            if constexpr (!std::is_trivially_destructible_v<value_type>)
+            {
+                for (size_type i = 0; i < m_capacity; ++i)
+                {
+                    if (m_ctrl[i] >= 0)
+                        std::destroy_at(m_slots + i);
+                }
+            }
+        }
+
+        static void Deallocate(Detail::ControlByte* ctrl, value_type* slots, const size_type capacity)
+        {
+            delete[] ctrl;
+            if (slots)
+                std::allocator<value_type>().deallocate(slots, capacity);
+        }
+    };
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+
+namespace Trema::Utils
+{
+    // Finalizer from MurmurHash3, spreads every input bit over the whole word
+    constexpr std::uint64_t MixHash(std::uint64_t h)
+    {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    // Stable across runs and platforms (hashes are persisted in precompiled sheets) and usable in constant
+    // expressions. FNV-1a is fine for the short identifiers found in stylesheets.
+    constexpr std::uint64_t Hash(const std::string_view string, const std::uint64_t seed = 0)
+    {
+        std::uint64_t h = 0xcbf29ce484222325ULL ^ MixHash(seed);
+        for (const char c : string)
+        {
+            h ^= static_cast<unsigned char>(c);
+            h *= 0x100000001b3ULL;
+        }
+        return MixHash(h);
+    }
+
+    // For larger buffers such as file contents: reads 8 bytes per step. Results depend on the byte order, so
+    // only use it for data that stays on one machine.
+    inline std::uint64_t HashContents(const std::string_view data, const std::uint64_t seed = 0)
+    {
+        std::uint64_t h = MixHash(seed ^ data.size());
+        std::size_t i = 0;
+        for (; i + sizeof(std::uint64_t) <= data.size(); i += sizeof(std::uint64_t))
+        {
+            std::uint64_t word;
+            std::memcpy(&word, data.data() + i, sizeof(word));
+            h = std::rotl((h ^ MixHash(word)) * 0x9e3779b97f4a7c15ULL, 31);
+        }
+
+        std::uint64_t tail = 0;
+        std::memcpy(&tail, data.data() + i, data.size() - i);
+        return MixHash(h ^ MixHash(tail + 1));
+    }
+
+    constexpr std::uint64_t CombineHashes(const std::uint64_t a, const std::uint64_t b)
+    {
+        return MixHash(a ^ (b + 0x9e3779b97f4a7c15ULL + (a << 6) + (a >> 2)));
+    }
+
+    // Transparent hasher so string keyed containers can be queried with any string-like type
+    struct StringHash
+    {
+        using is_transparent = void;
+
+        std::size_t operator()(const std::string_view string) const noexcept
+        {
+            return static_cast<std::size_t>(Hash(string));
+        }
+    };
+}
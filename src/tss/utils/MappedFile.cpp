@@ -0,0 +1,89 @@
+#include <tss/utils/MappedFile.h>
+#include <format>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define TSS_HAS_MMAP 1
+#endif
+
+namespace Trema::Utils
+{
+    MappedFile MappedFile::Open(const std::filesystem::path& path)
+    {
+    #ifdef TSS_HAS_MMAP
+        const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            throw std::runtime_error(std::format("File not found: \"{}\"", path.string()));
+
+        struct stat status {};
+        if (fstat(fd, &status) != 0)
+        {
+            close(fd);
+            throw std::runtime_error(std::format("Unable to read \"{}\"", path.string()));
+        }
+
+        const auto size = static_cast<std::size_t>(status.st_size);
+        if (size == 0)
+        {
+            close(fd);
+            return {};
+        }
+
+        void* address = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (address == MAP_FAILED)
+            throw std::runtime_error(std::format("Unable to map \"{}\"", path.string()));
+
+        return
+        {
+            std::shared_ptr<const std::byte>(static_cast<const std::byte*>(address),
+                                             [size](const std::byte* data) { munmap(const_cast<std::byte*>(data), size); }),
+            size
+        };
+    #else
+        std::ifstream file(path, std::ios::in | std::ios::binary);
+        if (!file)
+            throw std::runtime_error(std::format("File not found: \"{}\"", path.string()));
+
+        auto contents = std::make_shared<std::vector<std::byte>>(std::filesystem::file_size(path));
+        if (!file.read(reinterpret_cast<char*>(contents->data()), static_cast<std::streamsize>(contents->size())))
+            throw std::runtime_error(std::format("Unable to read \"{}\"", path.string()));
+
+        const auto size = contents->size();
+        return { std::shared_ptr<const std::byte>(contents, contents->data()), size };
+    #endif
+    }
+
+    void WriteFileAtomically(const std::filesystem::path& path, const void* data, const std::size_t size)
+    {
+        // Unique so that concurrent writers of the same file don't share a temporary file
+        auto temporary = path;
+        temporary += std::format(".{:08x}.tmp", std::random_device()());
+
+        {
+            std::ofstream file(temporary, std::ios::out | std::ios::binary | std::ios::trunc);
+            if (!file || !file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size)) || !file.flush())
+            {
+                file.close();
+                std::error_code error;
+                std::filesystem::remove(temporary, error);
+                throw std::runtime_error(std::format("Unable to write \"{}\"", path.string()));
+            }
+        }
+
+        std::error_code error;
+        std::filesystem::rename(temporary, path, error);
+        if (error)
+        {
+            std::filesystem::remove(temporary, error);
+            throw std::runtime_error(std::format("Unable to replace \"{}\"", path.string()));
+        }
+    }
+}
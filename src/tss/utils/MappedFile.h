@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+
+namespace Trema::Utils
+{
+    // Read-only contents of a whole file. On POSIX systems the file is mapped, so pages are loaded on first use
+    // and shared by every process mapping the same file; elsewhere it is read into memory.
+    // The contents stay valid for as long as one copy of Data is alive.
+    struct MappedFile
+    {
+        std::shared_ptr<const std::byte> Data;
+        std::size_t Size { 0 };
+
+        [[nodiscard]] static MappedFile Open(const std::filesystem::path& path);
+    };
+
+    // Writes to a temporary file next to path and renames it over path, so that readers (including processes
+    // that mapped the previous version) never see a partially written file
+    void WriteFileAtomically(const std::filesystem::path& path, const void* data, std::size_t size);
+}
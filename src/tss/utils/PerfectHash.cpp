@@ -0,0 +1,67 @@
+#include <tss/utils/PerfectHash.h>
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+namespace Trema::Utils
+{
+    std::vector<std::uint32_t> PerfectHash::Build(const std::span<const std::uint64_t> hashes)
+    {
+        constexpr std::uint32_t MaxSeed = 1u << 24;
+
+        std::vector<std::uint64_t> sorted(hashes.begin(), hashes.end());
+        std::ranges::sort(sorted);
+        if (std::ranges::adjacent_find(sorted) != sorted.end())
+            throw std::runtime_error("Perfect hash keys must be distinct");
+
+        const auto slotCount = static_cast<std::uint32_t>(hashes.size());
+        const auto bucketCount = BucketCountFor(hashes.size());
+
+        std::vector<std::vector<std::uint32_t>> buckets(bucketCount);
+        for (std::uint32_t i = 0; i < slotCount; ++i)
+            buckets[Bucket(hashes[i], bucketCount)].push_back(i);
+
+        // Place the largest buckets first, while most slots are still free
+        std::vector<std::uint32_t> order(bucketCount);
+        std::iota(order.begin(), order.end(), 0);
+        std::ranges::stable_sort(order, [&buckets](const auto a, const auto b)
+        {
+            return buckets[a].size() > buckets[b].size();
+        });
+
+        std::vector<std::uint32_t> seeds(bucketCount, 0);
+        std::vector<bool> taken(slotCount, false);
+        std::vector<std::uint32_t> slots;
+        for (const auto bucket : order)
+        {
+            const auto& keys = buckets[bucket];
+            if (keys.empty())
+                break;
+
+            for (std::uint32_t seed = 0;; ++seed)
+            {
+                if (seed == MaxSeed)
+                    throw std::runtime_error("Unable to build perfect hash");
+
+                slots.clear();
+                for (const auto key : keys)
+                {
+                    const auto slot = Slot(hashes[key], seed, slotCount);
+                    if (taken[slot] || std::ranges::find(slots, slot) != slots.end())
+                        break;
+                    slots.push_back(slot);
+                }
+
+                if (slots.size() == keys.size())
+                {
+                    for (const auto slot : slots)
+                        taken[slot] = true;
+                    seeds[bucket] = seed;
+                    break;
+                }
+            }
+        }
+
+        return seeds;
+    }
+}
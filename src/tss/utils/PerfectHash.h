@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+#include <tss/utils/Hashing.h>
+
+namespace Trema::Utils
+{
+    // Minimal perfect hashing over precomputed 64-bit key hashes (hash and displace): keys are split into
+    // buckets, and each bucket gets a seed that sends all of its keys to distinct free slots. A lookup is a
+    // seed load followed by a slot computation; callers must still verify the key stored in the slot.
+    class PerfectHash final
+    {
+    public:
+        // Returns one seed per bucket; hashes must be distinct
+        [[nodiscard]] static std::vector<std::uint32_t> Build(std::span<const std::uint64_t> hashes);
+
+        [[nodiscard]] static std::uint32_t BucketCountFor(const std::size_t keyCount)
+        {
+            return static_cast<std::uint32_t>(keyCount / 2 + 1);
+        }
+
+        [[nodiscard]] static std::uint32_t Bucket(const std::uint64_t hash, const std::uint32_t bucketCount)
+        {
+            return static_cast<std::uint32_t>(((hash >> 32) * bucketCount) >> 32);
+        }
+
+        [[nodiscard]] static std::uint32_t Slot(const std::uint64_t hash, const std::uint32_t seed, const std::uint32_t slotCount)
+        {
+            const auto mixed = MixHash(hash + seed * 0x9e3779b97f4a7c15ULL) & 0xFFFFFFFFULL;
+            return static_cast<std::uint32_t>((mixed * slotCount) >> 32);
+        }
+
+        [[nodiscard]] static std::uint32_t Lookup(const std::uint64_t hash, const std::uint32_t* seeds,
+                                                  const std::uint32_t bucketCount, const std::uint32_t slotCount)
+        {
+            return Slot(hash, seeds[Bucket(hash, bucketCount)], slotCount);
+        }
+    };
+}
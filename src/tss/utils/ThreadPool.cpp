@@ -0,0 +1,177 @@
+#include <tss/utils/ThreadPool.h>
+#include <algorithm>
+#include <utility>
+
+namespace Trema::Utils
+{
+    namespace
+    {
+        // Pool and queue of the worker running on this thread, if any
+        thread_local const ThreadPool* CurrentPool = nullptr;
+        thread_local std::size_t CurrentWorker = 0;
+    }
+
+    ThreadPool::ThreadPool(const std::size_t threadCount)
+    {
+        // hardware_concurrency() may not be known
+        const auto count = std::max<std::size_t>(threadCount, 1);
+        m_workers.reserve(count);
+        for (std::size_t i = 0; i < count; ++i)
+            m_workers.push_back(std::make_unique<Worker>());
+
+        m_threads.reserve(count);
+        for (std::size_t i = 0; i < count; ++i)
+            m_threads.emplace_back(&ThreadPool::Run, this, i);
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wake.notify_all();
+
+        for (auto& thread : m_threads)
+            thread.join();
+    }
+
+    ThreadPool& ThreadPool::Default()
+    {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    void ThreadPool::Enqueue(std::function<void()> task)
+    {
+        if (CurrentPool == this)
+        {
+            auto& worker = *m_workers[CurrentWorker];
+            std::lock_guard lock(worker.Mutex);
+            worker.Tasks.push_back(std::move(task));
+            m_queued.fetch_add(1);
+        }
+        else
+        {
+            std::lock_guard lock(m_mutex);
+            m_tasks.push_back(std::move(task));
+            m_queued.fetch_add(1);
+        }
+
+        // A worker counts itself as sleeping before checking m_queued, so either it sees the task or this sees it.
+        // Taking the lock then orders the notification after its check
+        if (m_sleeping.load() == 0)
+            return;
+
+        {
+            std::lock_guard lock(m_mutex);
+        }
+        m_wake.notify_one();
+    }
+
+    bool ThreadPool::RunPending()
+    {
+        std::function<void()> task;
+        const auto take = [this, &task](std::deque<std::function<void()>>& tasks, const bool newest)
+        {
+            if (tasks.empty())
+                return false;
+
+            if (newest)
+            {
+                task = std::move(tasks.back());
+                tasks.pop_back();
+            }
+            else
+            {
+                task = std::move(tasks.front());
+                tasks.pop_front();
+            }
+            m_queued.fetch_sub(1);
+            return true;
+        };
+
+        const auto own = CurrentPool == this ? CurrentWorker : 0;
+        bool found = false;
+        if (CurrentPool == this)
+        {
+            std::lock_guard lock(m_workers[own]->Mutex);
+            found = take(m_workers[own]->Tasks, true);
+        }
+        if (!found)
+        {
+            std::lock_guard lock(m_mutex);
+            found = take(m_tasks, false);
+        }
+        for (std::size_t i = 1; !found && i <= m_workers.size(); ++i)
+        {
+            auto& victim = *m_workers[(own + i) % m_workers.size()];
+            std::lock_guard lock(victim.Mutex);
+            found = take(victim.Tasks, false);
+        }
+
+        if (found)
+            task();
+        return found;
+    }
+
+    void ThreadPool::Run(const std::size_t worker)
+    {
+        CurrentPool = this;
+        CurrentWorker = worker;
+
+        while (true)
+        {
+            if (RunPending())
+                continue;
+
+            std::unique_lock lock(m_mutex);
+            m_sleeping.fetch_add(1);
+            m_wake.wait(lock, [this] { return m_stopping || m_queued.load() > 0; });
+            m_sleeping.fetch_sub(1);
+            if (m_stopping && m_queued.load() == 0)
+                return;
+        }
+    }
+
+    TaskGroup::~TaskGroup()
+    {
+        Drain();
+    }
+
+    void TaskGroup::Wait()
+    {
+        Drain();
+
+        std::lock_guard lock(m_mutex);
+        if (auto error = std::exchange(m_error, nullptr))
+            std::rethrow_exception(error);
+    }
+
+    void TaskGroup::Finish()
+    {
+        auto pending = m_pending.load(std::memory_order_relaxed);
+        while (pending > 1 && !m_pending.compare_exchange_weak(pending, pending - 1, std::memory_order_release))
+        {
+        }
+        if (pending > 1)
+            return;
+
+        // The last task finishes under the lock, which Drain takes before returning: the group can't go away
+        // before the task is done with it
+        std::lock_guard lock(m_mutex);
+        if (m_pending.fetch_sub(1, std::memory_order_release) == 1)
+            m_done.notify_all();
+    }
+
+    void TaskGroup::Drain()
+    {
+        while (m_pending.load(std::memory_order_acquire) > 0 && m_pool.RunPending())
+        {
+        }
+
+        // Whatever is left is running on other threads
+        std::unique_lock lock(m_mutex);
+        m_done.wait(lock, [this] { return m_pending.load(std::memory_order_acquire) == 0; });
+    }
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace Trema::Utils
+{
+    // Fixed set of worker threads. Tasks submitted from outside the pool go to a shared queue, taken in submission
+    // order; tasks submitted by a worker go to its own queue, which it runs newest first while idle workers steal
+    // the oldest ones, so nested work stays on the thread whose cache holds its data.
+    // Waiting on a task's future from inside another task can deadlock once every worker is waiting: use a
+    // TaskGroup for nested work.
+    class ThreadPool final
+    {
+    public:
+        explicit ThreadPool(std::size_t threadCount = std::thread::hardware_concurrency());
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+        // Runs the tasks still queued before returning
+        ~ThreadPool();
+
+        template<typename F>
+        auto Submit(F&& task) -> std::future<std::invoke_result_t<std::decay_t<F>>>
+        {
+            using Result = std::invoke_result_t<std::decay_t<F>>;
+            auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+            auto future = packaged->get_future();
+            Enqueue([packaged] { (*packaged)(); });
+            return future;
+        }
+
+        [[nodiscard]] std::size_t ThreadCount() const { return m_threads.size(); }
+
+        // Shared pool with one thread per core
+        [[nodiscard]] static ThreadPool& Default();
+
+    private:
+        friend class TaskGroup;
+
+        struct Worker
+        {
+            std::mutex Mutex;
+            std::deque<std::function<void()>> Tasks;
+        };
+
+        std::vector<std::thread> m_threads;
+        std::vector<std::unique_ptr<Worker>> m_workers;
+        std::deque<std::function<void()>> m_tasks;
+        std::atomic<std::size_t> m_queued { 0 };
+        // Workers waiting for a task, so that Enqueue only takes m_mutex when one may need waking
+        std::atomic<std::size_t> m_sleeping { 0 };
+        std::mutex m_mutex;
+        std::condition_variable m_wake;
+        bool m_stopping { false };
+
+        void Enqueue(std::function<void()> task);
+        // Runs one queued task on the calling thread, if there is any
+        bool RunPending();
+        void Run(std::size_t worker);
+    };
+
+    // Fork-join over a pool: Wait runs queued tasks instead of blocking, so tasks can spawn and wait for
+    // subtasks at any depth; it only sleeps once the tasks left are running on other threads. The first exception thrown by a task is rethrown by Wait.
+    class TaskGroup final
+    {
+    public:
+        explicit TaskGroup(ThreadPool& pool) : m_pool(pool) { }
+        TaskGroup(const TaskGroup&) = delete;
+        TaskGroup& operator=(const TaskGroup&) = delete;
+        ~TaskGroup();
+
+        template<typename F>
+        void Run(F&& task)
+        {
+            m_pending.fetch_add(1, std::memory_order_relaxed);
+            m_pool.Enqueue([this, task = std::forward<F>(task)]() mutable
+            {
+                try
+                {
+                    task();
+                }
+                catch (...)
+                {
+                    std::lock_guard lock(m_mutex);
+                    if (!m_error)
+                        m_error = std::current_exception();
+                }
+                Finish();
+            });
+        }
+
+        void Wait();
+
+    private:
+        ThreadPool& m_pool;
+        std::atomic<std::size_t> m_pending { 0 };
+        std::mutex m_mutex;
+        std::condition_variable m_done;
+        std::exception_ptr m_error;
+
+        void Finish();
+        void Drain();
+    };
+}
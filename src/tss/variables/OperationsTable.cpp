@@ -120,6 +120,9 @@ namespace Trema::Style
 
             throw std::runtime_error("Unsupported operand types for % operator");
         });
+
+        // A '-' without a left operand: the parser pushes a 0 for it, and it binds tighter than * / and %
+        InsertOperator("unary -", 3, false, GetOperator("-").Operation);
     }
 
     void OperationsTable::InsertOperator(const std::string& name, const int priority, const bool leftAssociative,
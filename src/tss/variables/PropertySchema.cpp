@@ -0,0 +1,59 @@
+#include <tss/variables/PropertySchema.h>
+#include <format>
+#include <stdexcept>
+
+namespace Trema::Style
+{
+    const PropertySchema::Property* PropertySchema::Find(const std::string_view name) const
+    {
+        const auto it = m_byName.find(name);
+        return it != m_byName.end() ? &m_properties[it->second] : nullptr;
+    }
+
+    bool PropertySchema::Accepts(const PropertyType type, const Value& value)
+    {
+        switch (type)
+        {
+        case PropertyType::Float:
+            return std::holds_alternative<Float>(value) || std::holds_alternative<Integer>(value);
+        case PropertyType::Integer:
+            return std::holds_alternative<Integer>(value);
+        case PropertyType::Bool:
+            return std::holds_alternative<bool>(value);
+        case PropertyType::String:
+            return std::holds_alternative<StringRef>(value);
+        case PropertyType::Color:
+            return std::holds_alternative<Color>(value);
+        }
+        return false;
+    }
+
+    std::string_view PropertySchema::GetTypeName(const PropertyType type)
+    {
+        switch (type)
+        {
+        case PropertyType::Float:
+            return "Float";
+        case PropertyType::Integer:
+            return "Integer";
+        case PropertyType::Bool:
+            return "Bool";
+        case PropertyType::String:
+            return "String";
+        case PropertyType::Color:
+            return "Color";
+        }
+        return "Unknown";
+    }
+
+    std::uint32_t PropertySchema::Add(std::string name, const PropertyType type, Value defaultValue)
+    {
+        if (m_byName.find(name) != m_byName.end())
+            throw std::invalid_argument(std::format("Property \"{}\" is already registered", name));
+
+        const auto slot = m_slotCounts[static_cast<std::size_t>(type)]++;
+        m_byName.try_emplace(name, static_cast<std::uint32_t>(m_properties.size()));
+        m_properties.push_back({ std::move(name), type, slot, defaultValue });
+        return slot;
+    }
+}
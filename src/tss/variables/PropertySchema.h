@@ -0,0 +1,88 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include <tss/tokenization/TokenValue.h>
+#include <tss/utils/FlatHashMap.h>
+#include <tss/utils/Hashing.h>
+
+namespace Trema::Style
+{
+    enum class PropertyType
+    {
+        Float,
+        Integer,
+        Bool,
+        String,
+        Color,
+    };
+
+    // Typed handle to a registered property: its slot among the properties of the same type
+    template<typename T>
+    struct PropertyKey
+    {
+        std::uint32_t Slot;
+    };
+
+    // Properties an application knows up front, with their type and default value. The parser reports values of
+    // the wrong type, and SlottedStyles stores these properties in fixed slots instead of looking them up by name.
+    class PropertySchema final
+    {
+    public:
+        struct Property
+        {
+            std::string Name;
+            PropertyType Type;
+            std::uint32_t Slot;
+            Value Default;
+        };
+
+        // T is Float, Integer, bool, std::string_view or Color; throws if the name is already registered
+        template<typename T>
+        PropertyKey<T> Register(std::string name, const T defaultValue)
+        {
+            if constexpr (std::is_same_v<T, std::string_view>)
+                return { Add(std::move(name), TypeOf<T>(), StringRef(defaultValue)) };
+            else
+                return { Add(std::move(name), TypeOf<T>(), defaultValue) };
+        }
+
+        [[nodiscard]] const Property* Find(std::string_view name) const;
+        [[nodiscard]] std::span<const Property> GetProperties() const { return m_properties; }
+        [[nodiscard]] std::uint32_t SlotCount(const PropertyType type) const { return m_slotCounts[static_cast<std::size_t>(type)]; }
+
+        // Integers are accepted where floats are expected, since "2" and "2.0" both read as integers
+        [[nodiscard]] static bool Accepts(PropertyType type, const Value& value);
+        [[nodiscard]] static std::string_view GetTypeName(PropertyType type);
+
+        template<typename T>
+        static constexpr PropertyType TypeOf()
+        {
+            if constexpr (std::is_same_v<T, Float>)
+                return PropertyType::Float;
+            else if constexpr (std::is_same_v<T, Integer>)
+                return PropertyType::Integer;
+            else if constexpr (std::is_same_v<T, bool>)
+                return PropertyType::Bool;
+            else if constexpr (std::is_same_v<T, Color>)
+                return PropertyType::Color;
+            else
+            {
+                static_assert(std::is_same_v<T, std::string_view>, "Properties are Float, Integer, bool, std::string_view or Color");
+                return PropertyType::String;
+            }
+        }
+
+    private:
+        std::vector<Property> m_properties;
+        Utils::FlatHashMap<std::string, std::uint32_t, Utils::StringHash, std::equal_to<>> m_byName;
+        std::array<std::uint32_t, 5> m_slotCounts { };
+
+        std::uint32_t Add(std::string name, PropertyType type, Value defaultValue);
+    };
+}
@@ -1,30 +1,152 @@
 #include <tss/variables/SymbolTable.h>
+#include <iterator>
 
 namespace Trema::Style
 {
+    SymbolTable::Iterator::Iterator(const SymbolTable* table, const std::size_t chunk) :
+        m_table(table),
+        m_chunk(chunk)
+    {
+        if (m_chunk > 0)
+        {
+            m_entry = m_table->m_chunks[m_chunk - 1]->begin();
+            SkipShadowed();
+        }
+    }
+
+    SymbolTable::Iterator& SymbolTable::Iterator::operator++()
+    {
+        ++m_entry;
+        SkipShadowed();
+        return *this;
+    }
+
+    void SymbolTable::Iterator::SkipShadowed()
+    {
+        while (m_chunk > 0)
+        {
+            if (m_entry == m_table->m_chunks[m_chunk - 1]->end())
+            {
+                if (--m_chunk > 0)
+                    m_entry = m_table->m_chunks[m_chunk - 1]->begin();
+                continue;
+            }
+
+            if (!m_table->IsShadowed(m_entry->first, m_chunk - 1))
+                break;
+
+            ++m_entry;
+        }
+    }
+
     SymbolTable::SymbolTable() = default;
 
     std::ostream &operator<<(std::ostream &os, const SymbolTable &st)
     {
-        for(const auto& [key, val] : st.m_variables)
+        for(const auto& [key, val] : st)
         {
-            os << "\t[" << key << ":" << val->GetIdentity() << "]\n";
+            os << "\t[" << key << ":" << val.GetIdentity() << "]\n";
         }
 
         os << std::endl;
         return os;
     }
 
-    SymbolTable::SymbolTable(const SymbolTable& st) : m_variables(st.m_variables)
+    SymbolTable::SymbolTable(const SymbolTable& st) : m_chunks(st.m_chunks), m_order(st.m_order)
     {
 
     }
 
+    const Variable* SymbolTable::GetVariable(const std::string_view name) const
+    {
+        for (auto chunk = m_chunks.rbegin(); chunk != m_chunks.rend(); ++chunk)
+        {
+            if (const auto it = (*chunk)->find(name); it != (*chunk)->end())
+                return &it->second;
+        }
+
+        return nullptr;
+    }
+
+    std::size_t SymbolTable::Size() const
+    {
+        if (m_chunks.size() == 1)
+            return m_chunks.front()->size();
+
+        return static_cast<std::size_t>(std::distance(begin(), end()));
+    }
+
     void SymbolTable::Append(const SymbolTable &st)
     {
-        for(const auto& [name, val] : st.m_variables)
+        const auto chunks = st.m_chunks;
+        for(const auto& chunk : chunks)
         {
-            m_variables[name] = val;
+            m_chunks.push_back(chunk);
+            MergeChunks();
         }
     }
-}
\ No newline at end of file
+
+    void SymbolTable::Compact()
+    {
+        if (m_chunks.size() <= 1)
+            return;
+
+        auto chunk = std::make_shared<Chunk>();
+        chunk->reserve(Size());
+        for (const auto& [name, variable] : *this)
+            chunk->try_emplace(name, variable);
+
+        m_chunks.clear();
+        m_chunks.push_back(std::move(chunk));
+    }
+
+    SymbolTable::Chunk& SymbolTable::MutableTop()
+    {
+        // A chunk referenced by another table is frozen; writes go to a fresh chunk on top of it
+        if (m_chunks.empty() || m_chunks.back().use_count() > 1)
+        {
+            m_chunks.push_back(std::make_shared<Chunk>());
+            MergeChunks();
+        }
+
+        return *m_chunks.back();
+    }
+
+    void SymbolTable::MergeChunks()
+    {
+        while (m_chunks.size() >= 2)
+        {
+            const auto& newer = m_chunks[m_chunks.size() - 1];
+            auto& older = m_chunks[m_chunks.size() - 2];
+            if (newer->size() * 2 < older->size())
+                break;
+
+            if (older.use_count() > 1)
+                older = std::make_shared<Chunk>(*older);
+
+            older->reserve(older->size() + newer->size());
+            for (const auto& [name, variable] : *newer)
+                older->insert_or_assign(name, variable);
+
+            m_chunks.pop_back();
+        }
+    }
+
+    bool SymbolTable::IsShadowed(const std::string_view name, const std::size_t chunk) const
+    {
+        for (auto i = chunk + 1; i < m_chunks.size(); ++i)
+        {
+            if (m_chunks[i]->contains(name))
+                return true;
+        }
+
+        return false;
+    }
+
+    void AppendBlock(std::shared_ptr<SymbolTable>& table, const SymbolTable& block)
+    {
+        if (table.use_count() > 1)
+            table = std::make_shared<SymbolTable>(*table);
+        table->Append(block);
+    }
+}
@@ -1,28 +1,71 @@
 #pragma once
 
-#include <unordered_map>
+#include <cstdint>
 #include <memory>
 #include <sstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <tss/utils/FlatHashMap.h>
+#include <tss/utils/Hashing.h>
 #include "Variable.h"
 
 namespace Trema::Style
 {
+    // Persistent symbol table made of a stack of immutable, shareable chunks, newest last.
+    // Copies and Append share chunks instead of copying entries; writes go to a chunk owned by this table
+    // only. Chunks are merged geometrically (a chunk is merged into the one below once it is at least half
+    // its size) so there are O(log n) chunks and each entry is copied O(log n) times over its lifetime.
     class SymbolTable final : public std::enable_shared_from_this<SymbolTable>
     {
     public:
+        using Chunk = Utils::FlatHashMap<StringRef, Variable, Utils::StringHash, std::equal_to<>>;
+
+        class Iterator final
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = Chunk::value_type;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const value_type*;
+            using reference = const value_type&;
+
+            Iterator() = default;
+            Iterator(const SymbolTable* table, std::size_t chunk);
+
+            reference operator*() const { return *m_entry; }
+            pointer operator->() const { return &*m_entry; }
+            Iterator& operator++();
+            Iterator operator++(int) { auto copy = *this; ++*this; return copy; }
+
+            friend bool operator==(const Iterator& a, const Iterator& b)
+            {
+                return a.m_chunk == b.m_chunk && (a.m_chunk == 0 || a.m_entry == b.m_entry);
+            }
+
+        private:
+            void SkipShadowed();
+
+            const SymbolTable* m_table { nullptr };
+            std::size_t m_chunk { 0 }; // 1-based index of the current chunk, walking from newest to oldest
+            Chunk::const_iterator m_entry;
+        };
+
         SymbolTable();
         SymbolTable(const SymbolTable& st);
         SymbolTable& operator=(const SymbolTable&) = delete;
 
-        template<typename T> void SetVariable(const std::string &name, const Value& value)
+        template<typename T> void SetVariable(const std::string_view name, const Value& value, const bool helper = false)
         {
             if(std::is_same_v<T, Float> ||
                 std::is_same_v<T, Integer> ||
-                std::is_same_v<T, char> ||
-                std::is_same_v<T, bool>
+                std::is_same_v<T, StringRef> ||
+                std::is_same_v<T, bool> ||
+                std::is_same_v<T, Color>
                 )
             {
-                m_variables[name] = std::make_shared<Variable>(value);
+                MutableTop().insert_or_assign(name, Variable(value, helper));
             }
             else
             {
@@ -30,17 +73,46 @@ namespace Trema::Style
             }
         }
 
-        bool HasVariable(const std::string &name) const { return m_variables.contains(name); }
-        std::shared_ptr<Variable> GetVariable(const std::string& name) { return m_variables[name]; }
+        [[nodiscard]] bool HasVariable(const std::string_view name) const { return GetVariable(name) != nullptr; }
+        // Returns nullptr when the variable is not defined; never inserts
+        [[nodiscard]] const Variable* GetVariable(std::string_view name) const;
+        [[nodiscard]] const Value* FindValue(const std::string_view name) const
+        {
+            const auto variable = GetVariable(name);
+            return variable ? &variable->GetValue() : nullptr;
+        }
+        [[nodiscard]] std::size_t Size() const;
+        [[nodiscard]] std::size_t ChunkCount() const { return m_chunks.size(); }
+
+        // Position of the selector's first block in the sources, which breaks ties between rules of equal
+        // specificity. Copies keep it; Append doesn't change it.
+        [[nodiscard]] std::uint32_t GetOrder() const { return m_order; }
+        void SetOrder(const std::uint32_t order) { m_order = order; }
+
+        // Entries of st override ours; st's chunks are shared, not copied
         void Append(const SymbolTable &st);
+        // Merges every chunk into a single one for the fastest lookups
+        void Compact();
 
         friend std::ostream& operator<<(std::ostream& os, const SymbolTable& st);
 
-        auto begin() { return m_variables.begin(); }
-        auto end() { return m_variables.end(); }
+        [[nodiscard]] Iterator begin() const { return { this, m_chunks.size() }; }
+        [[nodiscard]] Iterator end() const { return { this, 0 }; }
 
     private:
-        std::unordered_map<std::string, std::shared_ptr<Variable>> m_variables;
+        std::vector<std::shared_ptr<Chunk>> m_chunks;
+        std::uint32_t m_order { 0 };
+
+        Chunk& MutableTop();
+        void MergeChunks();
+        [[nodiscard]] bool IsShadowed(std::string_view name, std::size_t chunk) const;
     };
-}
 
+    // Tables by selector; transparent, so it can be searched with a std::string_view or const char* as is.
+    // The selectors of a list ("#ok, #cancel { }") share one table.
+    using SelectorMap = std::unordered_map<std::string, std::shared_ptr<SymbolTable>, Utils::StringHash, std::equal_to<>>;
+
+    // Appends a block to the table of a selector, first copying the table when someone else holds it too (such as
+    // the other selectors of a list); the copy shares its chunks
+    void AppendBlock(std::shared_ptr<SymbolTable>& table, const SymbolTable& block);
+}
@@ -9,8 +9,9 @@
 
 namespace Trema::Style
 {
-    Variable::Variable(Value value) :
-        m_value(std::move(value))
+    Variable::Variable(Value value, const bool helper) :
+        m_value(std::move(value)),
+        m_helper(helper)
     {
     }
 
@@ -25,6 +26,10 @@ namespace Trema::Style
                 return VariableType::Number;
             else if constexpr (std::is_same_v<T, bool>)
                 return VariableType::Bool;
+            else if constexpr (std::is_same_v<T, StringRef>)
+                return VariableType::String;
+            else if constexpr (std::is_same_v<T, Color>)
+                return VariableType::Color;
             else
                 throw std::runtime_error("Unsupported variable type");
         }, m_value);
@@ -41,9 +46,6 @@ namespace Trema::Style
         return os;
     }
 
-    Variable::~Variable()
-    = default;
-
     Value Variable::CopyValue() const
     {
         return CopyValue(m_value);
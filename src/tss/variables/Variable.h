@@ -1,7 +1,6 @@
 #pragma once
 
 #include <string>
-#include <memory>
 #include <tss/tokenization/TokenValue.h>
 
 namespace Trema::Style
@@ -11,21 +10,23 @@ namespace Trema::Style
         Number,
         Bool,
         String,
+        Color,
     };
 
-    class Variable final : public std::enable_shared_from_this<Variable>
+    // Stored inline in symbol tables, so it stays small and trivially copyable: the Value it wraps, and whether it
+    // was defined with '=' rather than ':'
+    class Variable final
     {
     public:
-        explicit Variable(Value value);
-        Variable(const Variable&) = delete;
-        Variable& operator=(const Variable&) = delete;
-        ~Variable();
+        explicit Variable(Value value, bool helper = false);
 
         Value CopyValue() const;
         static Value CopyValue(Value v) ;
 
-        [[nodiscard]] Value GetValue() const { return m_value; }
+        [[nodiscard]] const Value& GetValue() const { return m_value; }
         [[nodiscard]] VariableType GetType() const;
+        // Defined with '=': a helper for the sheet to copy rather than a property for the application
+        [[nodiscard]] bool IsHelper() const { return m_helper; }
 
         std::string GetIdentity() const;
 
@@ -33,5 +34,6 @@ namespace Trema::Style
 
     private:
         Value m_value;
+        bool m_helper;
     };
 }
@@ -0,0 +1,38 @@
+#pragma once
+#include <catch2/catch_test_macros.hpp>
+#include <filesystem>
+#include <string>
+#include <tss/parsing/StackedStyleParser.h>
+#include <tss/tokenization/EndToEndTokenizer.h>
+
+// Helpers shared by the tests
+namespace Trema::Style::Testing
+{
+    // Parse results of code that must have no mistakes
+    inline SelectorMap ParseSelectors(const std::string& code)
+    {
+        MistakesContainer mistakes;
+        StackedStyleParser parser(std::make_unique<EndToEndTokenizer>(code, mistakes), mistakes);
+        parser.ParseFromCode(code);
+        REQUIRE(mistakes.empty());
+        return parser.GetVariables();
+    }
+
+    inline StyleSheet ParseSheet(const std::string& code)
+    {
+        MistakesContainer mistakes;
+        StackedStyleParser parser(std::make_unique<EndToEndTokenizer>(code, mistakes), mistakes);
+        parser.ParseFromCode(code);
+        REQUIRE(mistakes.empty());
+        return parser.BuildStyleSheet();
+    }
+
+    // An empty directory under the temporary directory, emptied first if an earlier run left it
+    inline std::filesystem::path MakeDirectory(const std::string& name)
+    {
+        const auto directory = std::filesystem::temp_directory_path() / name;
+        std::filesystem::remove_all(directory);
+        std::filesystem::create_directories(directory);
+        return directory;
+    }
+}
@@ -0,0 +1,156 @@
+#include <catch2/catch_test_macros.hpp>
+#include <tss/animation/TransitionEngine.h>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <tss-test/TestHelpers.h>
+
+using namespace Trema::Style;
+using namespace Trema::Style::Testing;
+
+TEST_CASE("TransitionEngine interpolates numbers", "[TransitionEngine]")
+{
+    // Given
+    TransitionEngine engine;
+    std::vector<TransitionEngine::Handle> handles;
+    for (int i = 0; i < 11; ++i)
+        handles.push_back(engine.Start(Float { 0 }, Float { 10.0 * i }, 2.0));
+    const auto width = engine.Start(Integer { 100 }, Integer { 200 }, 2.0);
+    const auto eased = engine.Start(Float { 0 }, Float { 1 }, 2.0, Easing::EaseIn);
+
+    // When
+    engine.Advance(0.5);
+
+    // Then
+    for (int i = 0; i < 11; ++i)
+        REQUIRE(std::abs(std::get<Float>(engine.Sample(handles[i])) - 2.5 * i) < 1e-4);
+    REQUIRE(std::get<Integer>(engine.Sample(width)) == 125);
+    REQUIRE(std::abs(std::get<Float>(engine.Sample(eased)) - 0.0625) < 1e-6);
+    REQUIRE_FALSE(engine.IsFinished(width));
+    REQUIRE(engine.ActiveCount() == 13);
+
+    engine.Advance(5);
+    REQUIRE(std::get<Integer>(engine.Sample(width)) == 200);
+    REQUIRE(engine.IsFinished(width));
+}
+
+TEST_CASE("TransitionEngine lands exactly on values a float can't hold", "[TransitionEngine]")
+{
+    // Given
+    TransitionEngine engine;
+    const auto still = engine.Start(Integer { 123456789 }, Integer { 123456789 }, 1.0);
+    const auto count = engine.Start(Integer { 0 }, Integer { 987654321 }, 1.0, Easing::EaseInOut);
+    const auto tenth = engine.Start(Float { 0 }, Float { 0.1 }, 1.0);
+    const auto back = engine.Start(Float { 1e10 + 0.3 }, Float { 0.1 }, 1.0, Easing::EaseOut);
+    const std::array<Keyframe, 3> keyframes { Keyframe { 0, Float { 0 } }, Keyframe { 0.3, Float { 2.7 } },
+                                              Keyframe { 1, Float { 0.1 } } };
+    const auto keyframed = engine.Start(keyframes, 1.0);
+    const auto instant = engine.Start(Float { 0 }, Float { 0.3 }, 0);
+
+    // When
+    const auto first = engine.Sample(still);
+    engine.Advance(0.25);
+    const auto moving = engine.Sample(still);
+    engine.Advance(1);
+
+    // Then
+    REQUIRE(std::get<Integer>(first) == 123456789);
+    REQUIRE(std::get<Integer>(moving) == 123456789);
+    REQUIRE(std::get<Integer>(engine.Sample(still)) == 123456789);
+    REQUIRE(std::get<Integer>(engine.Sample(count)) == 987654321);
+    REQUIRE(std::get<Float>(engine.Sample(tenth)) == 0.1);
+    REQUIRE(std::get<Float>(engine.Sample(back)) == 0.1);
+    REQUIRE(std::get<Float>(engine.Sample(keyframed)) == 0.1);
+    REQUIRE(std::get<Float>(engine.Sample(instant)) == 0.3);
+    REQUIRE(engine.IsFinished(tenth));
+}
+
+TEST_CASE("TransitionEngine blends premultiplied colours", "[TransitionEngine]")
+{
+    // Given
+    TransitionEngine engine;
+    const auto fade = engine.Start(Color { 0xFF000000 }, Color { 0x0000FFFF }, 1.0);
+    const auto solid = engine.Start(Color { 0xFF0000FF }, Color { 0x0000FFFF }, 1.0);
+
+    // When
+    const auto start = std::get<Color>(engine.Sample(solid));
+    engine.Advance(0.5);
+
+    // Then
+    REQUIRE(start == Color { 0xFF0000FF });
+    // The transparent red doesn't show while fading in
+    REQUIRE(std::get<Color>(engine.Sample(fade)) == Color { 0x0000FF80 });
+    REQUIRE(std::get<Color>(engine.Sample(solid)) == Color { 0x800080FF });
+}
+
+TEST_CASE("TransitionEngine blends colours in linear light", "[TransitionEngine]")
+{
+    // Given
+    TransitionEngine engine(ColorSpace::Linear);
+    const auto crossfade = engine.Start(Color { 0x000000FF }, Color { 0xFFFFFFFF }, 1.0);
+
+    // When
+    engine.Advance(0.5);
+
+    // Then
+    REQUIRE(std::get<Color>(engine.Sample(crossfade)) == Color { 0xBCBCBCFF });
+}
+
+TEST_CASE("TransitionEngine goes through keyframes", "[TransitionEngine]")
+{
+    // Given
+    TransitionEngine engine;
+    const std::array<Keyframe, 3> keyframes { Keyframe { 0, Integer { 0 } }, Keyframe { 0.25, Integer { 100 } },
+                                              Keyframe { 1, Integer { 40 } } };
+    const auto bounce = engine.Start(keyframes, 4.0);
+
+    // When
+    engine.Advance(0.5);
+    const auto rising = std::get<Integer>(engine.Sample(bounce));
+    engine.Advance(2.5);
+    const auto falling = std::get<Integer>(engine.Sample(bounce));
+
+    // Then
+    REQUIRE(rising == 50);
+    REQUIRE(falling == 60);
+}
+
+TEST_CASE("TransitionEngine transitions between computed styles", "[TransitionEngine]")
+{
+    // Given
+    StyleResolver light(ParseSheet("#button { width: 100; color: 0xFFFFFFFF; label: \"OK\"; height: 20; }"));
+    StyleResolver dark(ParseSheet("#button { width: 200; color: 0x000000FF; label: \"Cancel\"; height: 20; }"));
+    TransitionEngine engine;
+
+    // When
+    const auto transitions = engine.Start(*light.Resolve("button"), *dark.Resolve("button"), 1.0);
+    engine.Advance(1.0);
+
+    // Then
+    REQUIRE(transitions.size() == 2);
+    for (const auto& [property, handle] : transitions)
+    {
+        if (property == "width")
+            REQUIRE(std::get<Integer>(engine.Sample(handle)) == 200);
+        else
+            REQUIRE(std::get<Color>(engine.Sample(handle)) == Color { 0x000000FF });
+    }
+}
+
+TEST_CASE("TransitionEngine rejects invalid transitions", "[TransitionEngine]")
+{
+    // Given
+    TransitionEngine engine;
+    const auto handle = engine.Start(Float { 0 }, Float { 1 }, 0);
+
+    // When
+    engine.Stop(handle);
+
+    // Then
+    REQUIRE_THROWS_AS(engine.Start(Float { 0 }, Color { 0 }, 1.0), std::invalid_argument);
+    REQUIRE_THROWS_AS(engine.Start(StringRef("a"), StringRef("b"), 1.0), std::invalid_argument);
+    REQUIRE_THROWS_AS(engine.Sample(handle), std::out_of_range);
+    REQUIRE(engine.ActiveCount() == 0);
+}
@@ -0,0 +1,81 @@
+#include <tss/parsing/HeaderGenerator.h>
+#include <catch2/catch_test_macros.hpp>
+#include <tss-test/TestHelpers.h>
+
+using namespace Trema::Style;
+using namespace Trema::Style::Testing;
+
+TEST_CASE("HeaderGenerator emits a struct per selector", "[HeaderGenerator]")
+{
+    // Given
+    const auto selectors = ParseSelectors("spacing = 4;\n"
+                                          "#main-window { title-size: spacing; ratio: 0.1; label: \"Say \\\"; shown: false; }");
+    const HeaderGenerator generator("Ui");
+
+    // When
+    const auto header = generator.Generate(selectors, "theme.tss");
+
+    // Then
+    REQUIRE(header ==
+        "// Generated by tss-codegen from theme.tss. Do not edit.\n"
+        "#pragma once\n"
+        "#include <limits>\n"
+        "#include <string_view>\n"
+        "#include <tss/tokenization/TokenValue.h>\n"
+        "\n"
+        "namespace Ui\n"
+        "{\n"
+        "    struct MainWindow\n"
+        "    {\n"
+        "        static constexpr std::string_view Selector = \"#main-window\";\n"
+        "        std::string_view Label { \"Say \\\\\" };\n"
+        "        Trema::Style::Float Ratio { 0.1 };\n"
+        "        bool Shown { false };\n"
+        "        Trema::Style::Integer TitleSize { 4 };\n"
+        "    };\n"
+        "\n"
+        "    struct Root\n"
+        "    {\n"
+        "        static constexpr std::string_view Selector = \"#\";\n"
+        "        Trema::Style::Integer Spacing { 4 };\n"
+        "    };\n"
+        "}\n");
+}
+
+TEST_CASE("HeaderGenerator emits colours", "[HeaderGenerator]")
+{
+    // Given
+    const auto selectors = ParseSelectors("#button { accent: 0xCC0000FF; }");
+    const HeaderGenerator generator("Ui");
+
+    // When
+    const auto header = generator.Generate(selectors, "theme.tss");
+
+    // Then
+    REQUIRE(header.find("        Trema::Style::Color Accent { 0xCC0000FF };\n") != std::string::npos);
+}
+
+TEST_CASE("HeaderGenerator turns selectors into type names", "[HeaderGenerator]")
+{
+    // Given
+    // When
+
+    // Then
+    REQUIRE(HeaderGenerator::ToTypeName("#") == "Root");
+    REQUIRE(HeaderGenerator::ToTypeName("#button") == "Button");
+    REQUIRE(HeaderGenerator::ToTypeName("side_panel") == "SidePanel");
+    REQUIRE(HeaderGenerator::ToTypeName("#tab-bar-2") == "TabBar2");
+    REQUIRE(HeaderGenerator::ToTypeName("#---").empty());
+}
+
+TEST_CASE("HeaderGenerator rejects names that collide", "[HeaderGenerator]")
+{
+    // Given
+    const auto selectors = ParseSelectors("#tab-bar { width: 1; } #tab_bar { width: 2; }");
+    const HeaderGenerator generator;
+
+    // When
+
+    // Then
+    REQUIRE_THROWS_AS(generator.Generate(selectors, "theme.tss"), std::runtime_error);
+}
@@ -0,0 +1,178 @@
+#include <tss/parsing/SheetLoader.h>
+#include <tss/parsing/StackedStyleParser.h>
+#include <tss/tokenization/EndToEndTokenizer.h>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <format>
+#include <fstream>
+#include <tss-test/TestHelpers.h>
+
+using namespace Trema::Style;
+using namespace Trema::Style::Testing;
+
+namespace
+{
+    Integer GetInteger(const StackedStyleParser& parser, const std::string& selector, const std::string_view name)
+    {
+        return std::get<Integer>(parser.GetVariables().at(selector)->GetVariable(name)->GetValue());
+    }
+}
+
+TEST_CASE("Imported root variables are visible to the importer", "[Import]")
+{
+    // Given
+    const auto directory = MakeDirectory("tss-import-test");
+    std::ofstream(directory / "base.tss") << "spacing = 8;";
+    std::ofstream(directory / "button.tss") << "@import \"base.tss\";\n#button { margin: spacing; }";
+    MistakesContainer mistakes;
+    StackedStyleParser parser(std::make_unique<EndToEndTokenizer>("", mistakes), mistakes);
+
+    // When
+    parser.ParseFromFile(directory / "button.tss");
+
+    // Then
+    REQUIRE(mistakes.empty());
+    REQUIRE(GetInteger(parser, "#button", "margin") == 8);
+    REQUIRE(GetInteger(parser, "#", "spacing") == 8);
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("A file imported by many sheets is parsed once", "[Import]")
+{
+    // Given
+    const auto directory = MakeDirectory("tss-import-shared-test");
+    std::ofstream(directory / "base.tss") << "size = 4;";
+    std::vector<SheetLoader::Source> sources;
+    for (int i = 0; i < 20; ++i)
+    {
+        const auto path = directory / std::format("component{}.tss", i);
+        std::ofstream(path) << std::format("@import \"base.tss\";\n#component{} {{ width: size; }}", i);
+        sources.push_back({ .Path = path });
+    }
+    SheetLoader loader;
+    Trema::Utils::ThreadPool pool(4);
+
+    // When
+    const auto sheets = loader.Load(sources, pool);
+    const auto parsed = loader.GetParsedCount();
+    const auto reloaded = loader.Load(sources, pool);
+
+    // Then
+    REQUIRE(sheets.size() == 21);
+    REQUIRE(sheets.front()->Path.filename() == "base.tss");
+    REQUIRE(parsed == 21);
+    REQUIRE(loader.GetParsedCount() == 0);
+    REQUIRE(reloaded.front() == sheets.front());
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("Imports contribute in depth-first order", "[Import]")
+{
+    // Given
+    const auto directory = MakeDirectory("tss-import-order-test");
+    std::ofstream(directory / "colors.tss") << "accent = 1;";
+    std::ofstream(directory / "theme.tss") << "@import \"colors.tss\";\naccent = 2;\n#panel { tone: accent; }";
+    std::ofstream(directory / "app.tss") << "@import \"theme.tss\";\n@import \"colors.tss\";\n#app { tone: accent; }";
+    MistakesContainer mistakes;
+    StackedStyleParser parser(std::make_unique<EndToEndTokenizer>("", mistakes), mistakes);
+
+    // When
+    parser.ParseFromFile(directory / "app.tss");
+
+    // Then
+    REQUIRE(mistakes.empty());
+    REQUIRE(GetInteger(parser, "#panel", "tone") == 2);
+    // colors.tss was contributed before theme.tss, so theme.tss wins
+    REQUIRE(GetInteger(parser, "#app", "tone") == 2);
+    REQUIRE(GetInteger(parser, "#", "accent") == 2);
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("Import cycles are reported and broken", "[Import]")
+{
+    // Given
+    const auto directory = MakeDirectory("tss-import-cycle-test");
+    std::ofstream(directory / "a.tss") << "@import \"b.tss\";\na = 1;";
+    std::ofstream(directory / "b.tss") << "@import \"a.tss\";\nb = 2;";
+    MistakesContainer mistakes;
+    StackedStyleParser parser(std::make_unique<EndToEndTokenizer>("", mistakes), mistakes);
+
+    // When
+    parser.ParseFromFile(directory / "a.tss");
+
+    // Then
+    REQUIRE(mistakes.size() == 1);
+    REQUIRE(mistakes.front().Code == ErrorCode::ImportCycle);
+    REQUIRE(mistakes.front().File == std::filesystem::weakly_canonical(directory / "b.tss").string());
+    REQUIRE(GetInteger(parser, "#", "a") == 1);
+    REQUIRE(GetInteger(parser, "#", "b") == 2);
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("Missing imports are reported on the importer", "[Import]")
+{
+    // Given
+    const auto directory = MakeDirectory("tss-import-missing-test");
+    std::ofstream(directory / "main.tss") << "x = 1;\n@import \"missing.tss\";";
+    MistakesContainer mistakes;
+    StackedStyleParser parser(std::make_unique<EndToEndTokenizer>("", mistakes), mistakes);
+
+    // When
+    parser.ParseFromFile(directory / "main.tss");
+
+    // Then
+    REQUIRE(mistakes.size() == 1);
+    REQUIRE(mistakes.front().Code == ErrorCode::UnresolvedImport);
+    REQUIRE(mistakes.front().Extra == "missing.tss");
+    REQUIRE(mistakes.front().Line == 2);
+    REQUIRE(GetInteger(parser, "#", "x") == 1);
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("Edited imports are parsed again with their importers", "[Import]")
+{
+    // Given
+    const auto directory = MakeDirectory("tss-import-edit-test");
+    std::ofstream(directory / "base.tss") << "size = 4;";
+    std::ofstream(directory / "other.tss") << "#other { width: 1; }";
+    std::ofstream(directory / "main.tss") << "@import \"base.tss\";\n@import \"other.tss\";\n#main { width: size; }";
+    const std::vector<SheetLoader::Source> sources = { { .Path = directory / "main.tss" } };
+    SheetLoader loader;
+    Trema::Utils::ThreadPool pool(2);
+    (void) loader.Load(sources, pool);
+
+    // When
+    std::ofstream(directory / "base.tss") << "size = 12;";
+    std::filesystem::last_write_time(directory / "base.tss",
+                                     std::filesystem::last_write_time(directory / "base.tss") + std::chrono::seconds(1));
+    const auto sheets = loader.Load(sources, pool);
+
+    // Then
+    REQUIRE(loader.GetParsedCount() == 2);
+    REQUIRE(std::get<Integer>(sheets.back()->Variables.at("#main")->GetVariable("width")->GetValue()) == 12);
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("Only @import directives count as imports", "[Import]")
+{
+    // Given
+    const std::string commented = "/* @import \"base.tss\"; */\n#button { label: \"@import\"; }";
+    const std::string imported = "@import \"base.tss\";\n#button { label: \"ok\"; }";
+    MistakesContainer mistakes;
+    StackedStyleParser parser(std::make_unique<EndToEndTokenizer>("", mistakes), mistakes);
+
+    // When
+    parser.ParseFromCode(commented);
+
+    // Then
+    REQUIRE_FALSE(SheetLoader::HasImports(commented));
+    REQUIRE(SheetLoader::HasImports(imported));
+    REQUIRE(mistakes.empty());
+    REQUIRE(parser.TryGet<std::string_view>("#button", "label") == "@import");
+}
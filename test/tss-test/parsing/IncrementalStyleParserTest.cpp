@@ -0,0 +1,197 @@
+#include <tss/parsing/IncrementalStyleParser.h>
+#include <tss/parsing/StackedStyleParser.h>
+#include <tss/tokenization/EndToEndTokenizer.h>
+#include <catch2/catch_test_macros.hpp>
+
+using namespace Trema::Style;
+
+namespace
+{
+    const std::string Code =
+        "baseWidth = 100;\n"
+        "spacing = 4;\n"
+        "#button {\n"
+        "  width: baseWidth;\n"
+        "  label: \"OK; {really}\";\n"
+        "}\n"
+        "#panel { padding: spacing; }\n"
+        "#button { height: 20; }\n";
+
+    Integer GetInteger(const StyleParser& parser, const std::string& selector, const std::string& property)
+    {
+        return std::get<Integer>(parser.GetVariables().at(selector)->GetVariable(property)->GetValue());
+    }
+
+    void RequireSameResults(const IncrementalStyleParser& parser)
+    {
+        MistakesContainer mistakes;
+        StackedStyleParser reference(std::make_unique<EndToEndTokenizer>("", mistakes), mistakes);
+        reference.ParseFromCode(parser.GetCode());
+
+        REQUIRE(parser.GetVariables().size() == reference.GetVariables().size());
+        for (const auto& [selector, table] : reference.GetVariables())
+        {
+            REQUIRE(parser.GetVariables().contains(selector));
+            const auto& incremental = *parser.GetVariables().at(selector);
+            REQUIRE(incremental.Size() == table->Size());
+            for (const auto& [name, variable] : *table)
+            {
+                REQUIRE(incremental.HasVariable(name));
+                REQUIRE(incremental.GetVariable(name)->GetIdentity() == variable.GetIdentity());
+            }
+        }
+
+        // Blocks are numbered differently, but in the same order
+        for (const auto& [first, firstTable] : reference.GetVariables())
+        {
+            for (const auto& [second, secondTable] : reference.GetVariables())
+            {
+                if (first != "#" && second != "#")
+                    REQUIRE((firstTable->GetOrder() < secondTable->GetOrder()) ==
+                            (parser.GetVariables().at(first)->GetOrder() < parser.GetVariables().at(second)->GetOrder()));
+            }
+        }
+    }
+}
+
+TEST_CASE("Initial parse matches the stacked parser", "[IncrementalStyleParser]")
+{
+    // Given
+    IncrementalStyleParser parser;
+
+    // When
+    parser.ParseFromCode(Code);
+
+    // Then
+    REQUIRE(parser.UnitCount() == 6);
+    REQUIRE(GetInteger(parser, "#button", "width") == 100);
+    REQUIRE(GetInteger(parser, "#button", "height") == 20);
+    REQUIRE(std::get<StringRef>(parser.GetVariables().at("#button")->GetVariable("label")->GetValue()) == "OK; {really}");
+    RequireSameResults(parser);
+}
+
+TEST_CASE("Editing a property only reparses its block", "[IncrementalStyleParser]")
+{
+    // Given
+    IncrementalStyleParser parser;
+    parser.ParseFromCode(Code);
+    const auto offset = Code.find("20");
+
+    // When
+    parser.ApplyEdit(offset, 2, "32");
+
+    // Then
+    REQUIRE(parser.GetReparsedUnitCount() == 1);
+    REQUIRE(GetInteger(parser, "#button", "height") == 32);
+    REQUIRE(GetInteger(parser, "#button", "width") == 100);
+    RequireSameResults(parser);
+}
+
+TEST_CASE("Editing a root variable reparses the blocks reading it", "[IncrementalStyleParser]")
+{
+    // Given
+    IncrementalStyleParser parser;
+    parser.ParseFromCode(Code);
+    const auto offset = Code.find("100");
+
+    // When
+    parser.ApplyEdit(offset, 3, "250");
+
+    // Then
+    REQUIRE(parser.GetReparsedUnitCount() == 2);
+    REQUIRE(GetInteger(parser, "#", "baseWidth") == 250);
+    REQUIRE(GetInteger(parser, "#button", "width") == 250);
+    REQUIRE(GetInteger(parser, "#panel", "padding") == 4);
+    RequireSameResults(parser);
+}
+
+TEST_CASE("Edits that change unit boundaries", "[IncrementalStyleParser]")
+{
+    // Given
+    IncrementalStyleParser parser;
+    parser.ParseFromCode(Code);
+
+    SECTION("Inserting a block")
+    {
+        // When
+        parser.ApplyEdit(Code.find("#panel"), 0, "#label { size: spacing; }\n");
+
+        // Then
+        REQUIRE(parser.UnitCount() == 7);
+        REQUIRE(GetInteger(parser, "#label", "size") == 4);
+        RequireSameResults(parser);
+    }
+
+    SECTION("Removing a block")
+    {
+        // When
+        const auto begin = Code.find("#panel");
+        parser.ApplyEdit(begin, Code.find("#button {", begin) - begin, "");
+
+        // Then
+        REQUIRE_FALSE(parser.GetVariables().contains("#panel"));
+        RequireSameResults(parser);
+    }
+
+    SECTION("Merging two blocks and splitting them again")
+    {
+        // When
+        const auto brace = Code.find("}\n#panel");
+        parser.ApplyEdit(brace, 1, "");
+
+        // Then
+        REQUIRE(parser.UnitCount() == 3);
+        REQUIRE(GetInteger(parser, "#button", "height") == 20);
+
+        // When
+        parser.ApplyEdit(brace, 0, "}");
+
+        // Then
+        REQUIRE(parser.UnitCount() == 6);
+        REQUIRE(GetInteger(parser, "#panel", "padding") == 4);
+        RequireSameResults(parser);
+    }
+
+    SECTION("Typing at the end of the code")
+    {
+        // When
+        for (const char c : std::string("gap = spacing;"))
+            parser.ApplyEdit(parser.GetCode().size(), 0, std::string(1, c));
+
+        // Then
+        REQUIRE(GetInteger(parser, "#", "gap") == 4);
+        RequireSameResults(parser);
+    }
+}
+
+TEST_CASE("Incremental mistakes use document lines", "[IncrementalStyleParser]")
+{
+    // Given
+    IncrementalStyleParser parser;
+    parser.ParseFromCode(Code);
+
+    // When
+    parser.ApplyEdit(Code.find("#panel"), 0, "name = 'unfinished;\n");
+    const auto mistakes = parser.GetMistakes();
+
+    // Then
+    REQUIRE(mistakes.size() == 1);
+    REQUIRE(mistakes.front().Code == ErrorCode::UnfinishedString);
+    REQUIRE(mistakes.front().Line == 7);
+}
+
+TEST_CASE("Failed edits leave the document untouched", "[IncrementalStyleParser]")
+{
+    // Given
+    IncrementalStyleParser parser;
+    parser.ParseFromCode(Code);
+
+    // When
+
+    // Then
+    REQUIRE_THROWS_AS(parser.ApplyEdit(Code.size() + 1, 0, "x"), std::out_of_range);
+    REQUIRE_THROWS_AS(parser.ApplyEdit(0, 0, "}"), std::runtime_error);
+    REQUIRE(parser.GetCode() == Code);
+    REQUIRE(parser.UnitCount() == 6);
+    RequireSameResults(parser);
+}
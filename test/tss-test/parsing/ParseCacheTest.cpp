@@ -0,0 +1,112 @@
+#include <tss/parsing/ParseCache.h>
+#include <tss/parsing/StackedStyleParser.h>
+#include <tss/tokenization/EndToEndTokenizer.h>
+#include <catch2/catch_test_macros.hpp>
+#include <fstream>
+#include <tss-test/TestHelpers.h>
+
+using namespace Trema::Style;
+using namespace Trema::Style::Testing;
+
+namespace
+{
+    FrozenStyleIndex Parse(const std::string& code, MistakesContainer& mistakes)
+    {
+        StackedStyleParser parser(std::make_unique<EndToEndTokenizer>("", mistakes), mistakes);
+        parser.ParseFromCode(code);
+        return parser.Freeze();
+    }
+}
+
+TEST_CASE("ParseCache returns stored results and mistakes", "[ParseCache]")
+{
+    // Given
+    const auto directory = MakeDirectory("tss-cache-test");
+    const ParseCache cache(directory / "cache");
+    const std::string code = "#button { width: 100; label: \"OK\"; } x = ;";
+    MistakesContainer mistakes;
+    const auto index = Parse(code, mistakes);
+    REQUIRE_FALSE(mistakes.empty());
+
+    // When
+    cache.Store(code, index, mistakes);
+    const auto entry = cache.Find(code);
+
+    // Then
+    REQUIRE(entry.has_value());
+    REQUIRE(std::get<Integer>(*entry->Index.Find("#button", "width")) == 100);
+    REQUIRE(std::get<StringRef>(*entry->Index.Find("#button", "label")) == "OK");
+    REQUIRE(entry->Mistakes.size() == mistakes.size());
+    REQUIRE(entry->Mistakes.front().Code == mistakes.front().Code);
+    REQUIRE(entry->Mistakes.front().Line == mistakes.front().Line);
+    REQUIRE(entry->Mistakes.front().Extra == mistakes.front().Extra);
+    REQUIRE_FALSE(cache.Find(code + " ").has_value());
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("ParseCache ignores damaged entries", "[ParseCache]")
+{
+    // Given
+    const auto directory = MakeDirectory("tss-cache-damaged-test");
+    const ParseCache cache(directory);
+    const std::string code = "#button { width: 100; }";
+    MistakesContainer mistakes;
+    cache.Store(code, Parse(code, mistakes), mistakes);
+
+    // When
+    std::ofstream(cache.GetEntryPath(code), std::ios::binary | std::ios::trunc) << "TSSC garbage";
+
+    // Then
+    REQUIRE_FALSE(cache.Find(code).has_value());
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("ParseFromFile reuses cached results", "[ParseCache]")
+{
+    // Given
+    const auto directory = MakeDirectory("tss-cache-parser-test");
+    const auto path = directory / "theme.tss";
+    const std::string code = "#button { width: 100; }";
+    std::ofstream(path, std::ios::binary) << code;
+    const auto cache = std::make_shared<const ParseCache>(directory / "cache");
+
+    // A planted entry proves the second parse is served from the cache
+    MistakesContainer planted;
+    planted << CompilationMistake { .Line = 3, .Position = 7, .Code = ErrorCode::UndefinedSymbol, .Extra = "planted" };
+
+    SECTION("A miss parses and stores the result")
+    {
+        // When
+        MistakesContainer mistakes;
+        StackedStyleParser parser(std::make_unique<EndToEndTokenizer>("", mistakes), mistakes);
+        parser.SetCache(cache);
+        parser.ParseFromFile(path);
+
+        // Then
+        REQUIRE(std::get<Integer>(parser.GetVariables().at("#button")->GetVariable("width")->GetValue()) == 100);
+        REQUIRE(std::filesystem::exists(cache->GetEntryPath(code)));
+    }
+
+    SECTION("A hit skips parsing")
+    {
+        // Given
+        MistakesContainer ignored;
+        cache->Store(code, Parse("#button { width: 42; }", ignored), planted);
+
+        // When
+        MistakesContainer mistakes;
+        StackedStyleParser parser(std::make_unique<EndToEndTokenizer>("", mistakes), mistakes);
+        parser.SetCache(cache);
+        parser.ParseFromFile(path);
+
+        // Then
+        REQUIRE(std::get<Integer>(parser.GetVariables().at("#button")->GetVariable("width")->GetValue()) == 42);
+        REQUIRE(mistakes.size() == 1);
+        REQUIRE(mistakes.front().Extra == "planted");
+        REQUIRE(mistakes.front().Line == 3);
+    }
+
+    std::filesystem::remove_all(directory);
+}
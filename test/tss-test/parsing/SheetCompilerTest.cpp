@@ -0,0 +1,86 @@
+#include <tss/parsing/SheetCompiler.h>
+#include <tss/sheets/StyleSheet.h>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <fstream>
+#include <tss-test/TestHelpers.h>
+
+using namespace Trema::Style;
+using namespace Trema::Style::Testing;
+
+TEST_CASE("SheetCompiler compiles every sheet of a directory", "[SheetCompiler]")
+{
+    // Given
+    const auto directory = MakeDirectory("tss-compiler-test");
+    std::filesystem::create_directories(directory / "sources" / "widgets");
+    std::ofstream(directory / "sources" / "base.tss") << "size = 4;";
+    std::ofstream(directory / "sources" / "widgets" / "button.tss") << "@import \"../base.tss\";\n#button { width: size; }";
+    SheetCompiler compiler(directory / "sources", directory / "out");
+    Trema::Utils::ThreadPool pool(2);
+
+    // When
+    const auto report = compiler.Compile(pool);
+
+    // Then
+    REQUIRE(report.Sheets.size() == 2);
+    REQUIRE(report.CompiledCount() == 2);
+    REQUIRE(report.FailedCount() == 0);
+    const auto sheet = StyleSheet::Load(directory / "out" / "widgets" / "button.tssc");
+    REQUIRE(std::get<Integer>(*sheet.Find("#button", "width")) == 4);
+    REQUIRE(std::filesystem::exists(directory / "out" / "base.tssc"));
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("SheetCompiler only compiles sheets whose sources changed", "[SheetCompiler]")
+{
+    // Given
+    const auto directory = MakeDirectory("tss-compiler-incremental-test");
+    std::filesystem::create_directory(directory / "sources");
+    std::ofstream(directory / "sources" / "base.tss") << "size = 4;";
+    std::ofstream(directory / "sources" / "button.tss") << "@import \"base.tss\";\n#button { width: size; }";
+    std::ofstream(directory / "sources" / "label.tss") << "#label { width: 1; }";
+    Trema::Utils::ThreadPool pool(2);
+    (void) SheetCompiler(directory / "sources", directory / "out").Compile(pool);
+
+    // When
+    const auto unchanged = SheetCompiler(directory / "sources", directory / "out").Compile(pool);
+    std::ofstream(directory / "sources" / "base.tss") << "size = 10;";
+    const auto edited = SheetCompiler(directory / "sources", directory / "out").Compile(pool);
+
+    // Then
+    REQUIRE(unchanged.CompiledCount() == 0);
+    REQUIRE(edited.CompiledCount() == 2);
+    REQUIRE_FALSE(edited.Sheets[2].Compiled);
+    const auto sheet = StyleSheet::Load(directory / "out" / "button.tssc");
+    REQUIRE(std::get<Integer>(*sheet.Find("#button", "width")) == 10);
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("SheetCompiler fails sheets with mistakes on every run", "[SheetCompiler]")
+{
+    // Given
+    const auto directory = MakeDirectory("tss-compiler-mistakes-test");
+    std::filesystem::create_directory(directory / "sources");
+    std::ofstream(directory / "sources" / "broken.tss") << "x = 1;";
+    Trema::Utils::ThreadPool pool(2);
+    SheetCompiler compiler(directory / "sources", directory / "out");
+    REQUIRE(compiler.Compile(pool).FailedCount() == 0);
+    std::ofstream(directory / "sources" / "broken.tss") << "@import \"missing.tss\";\nx = 1;";
+
+    // When
+    const auto first = compiler.Compile(pool);
+    const auto second = compiler.Compile(pool);
+
+    // Then
+    REQUIRE(first.Sheets.front().Mistakes.size() == 1);
+    REQUIRE(first.FailedCount() == 1);
+    REQUIRE_FALSE(std::filesystem::exists(first.Sheets.front().Output));
+    REQUIRE(second.CompiledCount() == 1);
+    REQUIRE(second.FailedCount() == 1);
+    REQUIRE(second.Sheets.front().Mistakes.front().Code == ErrorCode::UnresolvedImport);
+    REQUIRE_FALSE(std::filesystem::exists(second.Sheets.front().Output));
+
+    std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,165 @@
+#include <tss/parsing/SheetOptimizer.h>
+#include <catch2/catch_test_macros.hpp>
+#include <bit>
+#include <limits>
+#include <tss-test/TestHelpers.h>
+
+using namespace Trema::Style;
+using namespace Trema::Style::Testing;
+
+namespace
+{
+    bool SameValues(const SheetOptimizer::SelectorMap& a, const SheetOptimizer::SelectorMap& b)
+    {
+        const auto contains = [](const SheetOptimizer::SelectorMap& x, const SheetOptimizer::SelectorMap& y)
+        {
+            for (const auto& [selector, table] : x)
+            {
+                const auto it = y.find(selector);
+                if (it == y.end() || it->second->Size() != table->Size())
+                    return false;
+
+                for (const auto& [name, variable] : *table)
+                {
+                    const auto value = it->second->FindValue(name.View());
+                    // Compares the bits of floats, so -0.0 differs from 0.0
+                    if (!value || value->index() != variable.GetValue().index() ||
+                        (std::holds_alternative<Float>(*value)
+                             ? std::bit_cast<std::uint64_t>(std::get<Float>(*value)) !=
+                               std::bit_cast<std::uint64_t>(std::get<Float>(variable.GetValue()))
+                             : Variable(*value).GetIdentity() != variable.GetIdentity()))
+                        return false;
+                }
+            }
+            return true;
+        };
+        return contains(a, b) && contains(b, a);
+    }
+}
+
+TEST_CASE("SheetOptimizer drops helpers and the selectors they leave empty", "[SheetOptimizer]")
+{
+    // Given
+    const auto selectors = ParseSelectors("invisible: 0x00000000;\n"
+                                          "scope {\n"
+                                          "  red: 0xCC0000FF;\n"
+                                          "  #element { text-color: red; }\n"
+                                          "  #hidden { text-color: invisible; }\n"
+                                          "}\n"
+                                          "#empty { }");
+    const std::string_view properties[] { "text-color" };
+    SheetOptimizer optimizer(properties);
+
+    // When
+    const auto optimized = optimizer.Optimize(selectors);
+
+    // Then
+    REQUIRE(optimized.size() == 2);
+    REQUIRE(std::get<Color>(*optimized.at("#element")->FindValue("text-color")) == Color { 0xCC0000FF });
+    REQUIRE(std::get<Color>(*optimized.at("#hidden")->FindValue("text-color")) == Color { 0 });
+    REQUIRE(optimizer.GetStatistics().RemovedProperties == 2);
+    REQUIRE(optimizer.GetStatistics().RemovedSelectors == 3); // "#", "scope" and "#empty"
+}
+
+TEST_CASE("SheetOptimizer drops the helpers defined with '=' by default", "[SheetOptimizer]")
+{
+    // Given
+    const auto selectors = ParseSelectors("spacing = 4;\n"
+                                          "gap: spacing;\n"
+                                          "base {\n"
+                                          "  accent = 0x3366CCFF;\n"
+                                          "  #ok { color: accent; margin = spacing * 2; }\n"
+                                          "}");
+    SheetOptimizer optimizer;
+
+    // When
+    const auto optimized = optimizer.Optimize(selectors);
+
+    // Then
+    REQUIRE(optimized.size() == 2);
+    REQUIRE(optimized.at("#")->Size() == 1);
+    REQUIRE(std::get<Integer>(*optimized.at("#")->FindValue("gap")) == 4);
+    REQUIRE(optimized.at("#ok")->Size() == 1);
+    REQUIRE(std::get<Color>(*optimized.at("#ok")->FindValue("color")) == Color { 0x3366CCFF });
+    REQUIRE(optimizer.GetStatistics().RemovedProperties == 3);
+    REQUIRE(optimizer.GetStatistics().RemovedSelectors == 1); // "base"
+    REQUIRE(SheetOptimizer::Minify(selectors) == "gap:4;spacing=4;base{accent=0x3366CCFF;}#ok{color:0x3366CCFF;margin=8;}");
+}
+
+TEST_CASE("SheetOptimizer shares the table of selectors with the same properties", "[SheetOptimizer]")
+{
+    // Given
+    const auto selectors = ParseSelectors("#ok, #retry { width: 10; label: \"Go\"; }\n"
+                                          "#apply { label: \"Go\"; width: 4 + 6; }\n"
+                                          "#cancel { width: 10; label: \"Stop\"; }");
+    SheetOptimizer optimizer;
+
+    // When
+    const auto optimized = optimizer.Optimize(selectors);
+
+    // Then
+    REQUIRE(optimized.at("#ok") == optimized.at("#retry"));
+    REQUIRE(optimized.at("#ok") != optimized.at("#cancel"));
+    REQUIRE(optimized.at("#ok")->ChunkCount() == 1);
+    REQUIRE(optimized.at("#apply")->ChunkCount() == 1);
+    REQUIRE(optimized.at("#apply")->GetOrder() > optimized.at("#ok")->GetOrder());
+    REQUIRE(std::get<Integer>(*optimized.at("#apply")->FindValue("width")) == 10);
+    REQUIRE(optimizer.GetStatistics().Tables == 2);
+    REQUIRE(optimizer.GetStatistics().RemovedSelectors == 1); // the empty root
+}
+
+TEST_CASE("SheetOptimizer minifies to literals only", "[SheetOptimizer]")
+{
+    // Given
+    SheetOptimizer optimizer;
+    const auto optimized = optimizer.Optimize(ParseSelectors("spacing: 4;\n"
+                                                             "base {\n"
+                                                             "  accent: 0x3366CCFF;\n"
+                                                             "  #ok, #cancel { margin: spacing * 2; color: accent; }\n"
+                                                             "}\n"
+                                                             "#title { text: 'Say \"hi\"'; shown: false; ratio: 0 - 0.25; }"));
+
+    // When
+    const auto code = SheetOptimizer::Minify(optimized);
+
+    // Then
+    REQUIRE(code == "spacing:4;base{accent:0x3366CCFF;}#cancel,#ok{color:0x3366CCFF;margin:8;}"
+                    "#title{ratio:-.25;shown:false;text:'Say \"hi\"';}");
+}
+
+TEST_CASE("Minified sheets parse back to the same values", "[SheetOptimizer]")
+{
+    // Given
+    auto selectors = ParseSelectors("#a { width: 3; label: \"it's\"; on: true; tint: 0x10203040; }");
+    auto table = std::make_shared<SymbolTable>();
+    table->SetVariable<Integer>("big", std::numeric_limits<Integer>::max());
+    table->SetVariable<Integer>("small", std::numeric_limits<Integer>::min());
+    table->SetVariable<Integer>("negative", -(Integer { 1 } << 60) - 3);
+    table->SetVariable<Float>("whole", 2.0);
+    table->SetVariable<Float>("negative-zero", -0.0);
+    table->SetVariable<Float>("huge", 1e300);
+    table->SetVariable<Float>("tiny", -1.5e-300);
+    table->SetVariable<Float>("third", 1.0 / 3);
+    selectors.emplace("#b", table);
+
+    // When
+    const auto code = SheetOptimizer::Minify(selectors);
+
+    // Then
+    REQUIRE(SameValues(ParseSelectors(code), selectors));
+}
+
+TEST_CASE("SheetOptimizer refuses values TSS can't spell", "[SheetOptimizer]")
+{
+    // Given
+    SheetOptimizer::SelectorMap nan { { "#a", std::make_shared<SymbolTable>() } };
+    nan.at("#a")->SetVariable<Float>("ratio", std::numeric_limits<Float>::quiet_NaN());
+    SheetOptimizer::SelectorMap quotes { { "#a", std::make_shared<SymbolTable>() } };
+    quotes.at("#a")->SetVariable<StringRef>("text", StringRef("\"it's\""));
+
+    // When
+
+    // Then
+    REQUIRE_THROWS_AS(SheetOptimizer::Minify(nan), std::runtime_error);
+    REQUIRE_THROWS_AS(SheetOptimizer::Minify(quotes), std::runtime_error);
+}
@@ -3,6 +3,9 @@
 #include <tss/variables/SymbolTable.h>
 #include <tss/errors/MistakesContainer.h>
 #include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
 
 using namespace Trema::Style;
 
@@ -110,4 +113,280 @@ TEST_CASE("Variable copying", "[StackedStyleParser]")
     REQUIRE(symbolTable->HasVariable("width"));
     REQUIRE(std::get<Integer>(symbolTable->GetVariable("baseWidth")->GetValue()) == 150);
     REQUIRE(std::get<Integer>(symbolTable->GetVariable("width")->GetValue()) == 150);
-}
\ No newline at end of file
+}
+TEST_CASE("String literal assignment", "[StackedStyleParser]")
+{
+    // Given
+    MistakesContainer mistakes;
+    const std::string code = "#label {\n"
+                       "  text: \"Hello\";\n"
+                       "  copy: text;\n"
+                       "}\n";
+    auto tokenizer = std::make_unique<EndToEndTokenizer>(code, mistakes);
+    StackedStyleParser parser(std::move(tokenizer), mistakes);
+
+    // When
+    parser.ParseFromCode(code);
+
+    // Then
+    REQUIRE(mistakes.empty());
+    const auto symbolTable = parser.GetVariables().at("#label");
+    REQUIRE(std::get<StringRef>(symbolTable->GetVariable("text")->GetValue()) == "Hello");
+    REQUIRE(std::get<StringRef>(symbolTable->GetVariable("copy")->GetValue()) == "Hello");
+}
+
+TEST_CASE("Batch parsing merges like sequential parsing", "[StackedStyleParser]")
+{
+    // Given
+    std::vector<std::string> codes;
+    for (int i = 0; i < 64; ++i)
+    {
+        codes.push_back("#shared { width: " + std::to_string(i) + "; }\n"
+                        "#own" + std::to_string(i) + " { height: " + std::to_string(i) + "; }\n"
+                        "broken" + std::to_string(i) + " = ;");
+    }
+    Trema::Utils::ThreadPool pool(4);
+
+    MistakesContainer sequentialMistakes;
+    StackedStyleParser sequential(std::make_unique<EndToEndTokenizer>("", sequentialMistakes), sequentialMistakes);
+    for (const auto& code : codes)
+        sequential.ParseFromCode(code);
+
+    // When
+    MistakesContainer mistakes;
+    StackedStyleParser parser(std::make_unique<EndToEndTokenizer>("", mistakes), mistakes);
+    parser.ParseCodes(codes, pool);
+
+    // Then
+    REQUIRE(parser.GetVariables().size() == sequential.GetVariables().size());
+    REQUIRE(std::get<Integer>(parser.GetVariables().at("#shared")->GetVariable("width")->GetValue()) == 63);
+    for (const auto& [selector, table] : sequential.GetVariables())
+    {
+        REQUIRE(parser.GetVariables().at(selector)->Size() == table->Size());
+        for (const auto& [name, variable] : *table)
+            REQUIRE(parser.GetVariables().at(selector)->GetVariable(name)->GetIdentity() == variable.GetIdentity());
+    }
+    REQUIRE(mistakes.size() == sequentialMistakes.size());
+    for (std::size_t i = 0; i < mistakes.size(); ++i)
+        REQUIRE(mistakes[i].Extra == sequentialMistakes[i].Extra);
+}
+
+TEST_CASE("Batch parsing stops merging at the first failure", "[StackedStyleParser]")
+{
+    // Given
+    const auto directory = std::filesystem::temp_directory_path() / "tss-batch-test";
+    std::filesystem::create_directories(directory);
+    std::ofstream(directory / "first.tss") << "#first { width: 1; }";
+    std::ofstream(directory / "last.tss") << "#last { width: 3; }";
+    const std::vector<std::filesystem::path> paths = { directory / "first.tss", directory / "missing.tss",
+                                                       directory / "last.tss" };
+    MistakesContainer mistakes;
+    StackedStyleParser parser(std::make_unique<EndToEndTokenizer>("", mistakes), mistakes);
+
+    // When
+
+    // Then
+    REQUIRE_THROWS_AS(parser.ParseFiles(paths), std::runtime_error);
+    REQUIRE(parser.GetVariables().contains("#first"));
+    REQUIRE_FALSE(parser.GetVariables().contains("#last"));
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("Parser lookups take string views and borrow values", "[StackedStyleParser]")
+{
+    // Given
+    const std::string code = "#button { label: \"OK\"; width: 100; }";
+    MistakesContainer mistakes;
+    StackedStyleParser parser(std::make_unique<EndToEndTokenizer>("", mistakes), mistakes);
+    parser.ParseFromCode(code);
+    const auto selector = std::string_view(code).substr(0, 7);
+
+    // When
+    const auto value = parser.FindValue(selector, "width");
+
+    // Then
+    REQUIRE(selector == "#button");
+    REQUIRE(value == parser.FindSelector(selector)->FindValue("width"));
+    REQUIRE(std::get<Integer>(*value) == 100);
+    REQUIRE(parser.TryGet<std::string_view>(selector, "label") == "OK");
+    REQUIRE_FALSE(parser.TryGet<bool>(selector, "width").has_value());
+    REQUIRE(parser.FindSelector("#missing") == nullptr);
+    REQUIRE(parser.FindValue(selector, "height") == nullptr);
+}
+
+TEST_CASE("Compound and descendant selectors are saved under their text", "[StackedStyleParser]")
+{
+    // Given
+    const std::string code = "button.primary { width: 1; }\n"
+                             "#dialog  .primary { width: 2; }\n"
+                             "* { width: 3; }\n"
+                             ".primary\n#ok { width: 4; }";
+    MistakesContainer mistakes;
+    StackedStyleParser parser(std::make_unique<EndToEndTokenizer>("", mistakes), mistakes);
+
+    // When
+    parser.ParseFromCode(code);
+
+    // Then
+    REQUIRE(mistakes.empty());
+    REQUIRE(parser.TryGet<Integer>("button.primary", "width") == 1);
+    REQUIRE(parser.TryGet<Integer>("#dialog .primary", "width") == 2);
+    REQUIRE(parser.TryGet<Integer>("*", "width") == 3);
+    REQUIRE(parser.TryGet<Integer>(".primary #ok", "width") == 4);
+}
+
+TEST_CASE("Selectors of a list share one block", "[StackedStyleParser]")
+{
+    // Given
+    const std::string code = "#ok, #cancel,\n.primary button { width: 10; label: \"Button\"; }\n"
+                             "#cancel { label: \"Cancel\"; }";
+    MistakesContainer mistakes;
+    StackedStyleParser parser(std::make_unique<EndToEndTokenizer>("", mistakes), mistakes);
+
+    // When
+    parser.ParseFromCode(code);
+
+    // Then
+    REQUIRE(mistakes.empty());
+    REQUIRE(parser.FindSelector("#ok") == parser.FindSelector(".primary button"));
+    REQUIRE(parser.FindSelector("#ok") != parser.FindSelector("#cancel"));
+    REQUIRE(parser.TryGet<std::string_view>("#ok", "label") == "Button");
+    REQUIRE(parser.TryGet<std::string_view>("#cancel", "label") == "Cancel");
+    REQUIRE(parser.TryGet<Integer>("#cancel", "width") == 10);
+}
+
+TEST_CASE("Empty entries of a selector list are mistakes", "[StackedStyleParser]")
+{
+    // Given
+    const std::string code = ", #a { width: 1; }\n#b,, #c { width: 2; }\n#d, { width: 3; }";
+    MistakesContainer mistakes;
+    StackedStyleParser parser(std::make_unique<EndToEndTokenizer>("", mistakes), mistakes);
+
+    // When
+    parser.ParseFromCode(code);
+
+    // Then
+    REQUIRE(mistakes.size() == 3);
+    for (const auto& mistake : mistakes)
+    {
+        REQUIRE(mistake.Code == ErrorCode::UnexpectedToken);
+        REQUIRE(mistake.Extra == ",");
+    }
+    REQUIRE(parser.FindSelector("") == nullptr);
+    REQUIRE(parser.TryGet<Integer>("#a", "width") == 1);
+    REQUIRE(parser.FindSelector("#b") == parser.FindSelector("#c"));
+    REQUIRE(parser.TryGet<Integer>("#d", "width") == 3);
+}
+
+TEST_CASE("Merging files keeps selector lists shared", "[StackedStyleParser]")
+{
+    // Given
+    const std::vector<std::string> codes { "#a, #b, #c { width: 1; }", "#c { width: 2; }" };
+    MistakesContainer mistakes;
+    StackedStyleParser parser(std::make_unique<EndToEndTokenizer>("", mistakes), mistakes);
+
+    // When
+    parser.ParseCodes(codes);
+
+    // Then
+    REQUIRE(mistakes.empty());
+    REQUIRE(parser.FindSelector("#a") == parser.FindSelector("#b"));
+    REQUIRE(parser.TryGet<Integer>("#b", "width") == 1);
+    REQUIRE(parser.TryGet<Integer>("#c", "width") == 2);
+}
+
+TEST_CASE("Arithmetic is folded with precedence, parentheses and signs", "[StackedStyleParser]")
+{
+    // Given
+    const std::string code = "spacing: 4;\n"
+                             "#button { width: spacing * (spacing - 1) / 2 + 1; offset: -5; scale: 2 * -.25; half: 7 / 2; }";
+    MistakesContainer mistakes;
+    StackedStyleParser parser(std::make_unique<EndToEndTokenizer>("", mistakes), mistakes);
+
+    // When
+    parser.ParseFromCode(code);
+
+    // Then
+    REQUIRE(mistakes.empty());
+    REQUIRE(parser.TryGet<Integer>("#button", "width") == 7);
+    REQUIRE(parser.TryGet<Integer>("#button", "offset") == -5);
+    REQUIRE(parser.TryGet<Float>("#button", "scale") == -0.5);
+    REQUIRE(parser.TryGet<Integer>("#button", "half") == 3);
+}
+
+TEST_CASE("Integer division by zero is a mistake", "[StackedStyleParser]")
+{
+    // Given
+    const std::string code = "#button { width: 4 / (2 - 2); height: 4 % 0; ratio: 1.5 / 0; }";
+    MistakesContainer mistakes;
+    StackedStyleParser parser(std::make_unique<EndToEndTokenizer>("", mistakes), mistakes);
+
+    // When
+    parser.ParseFromCode(code);
+
+    // Then
+    REQUIRE(std::ranges::count(mistakes, std::string("Division by zero"), &CompilationMistake::Extra) == 2);
+    REQUIRE_FALSE(parser.FindValue("#button", "width"));
+    REQUIRE_FALSE(parser.FindValue("#button", "height"));
+    REQUIRE(std::isinf(*parser.TryGet<Float>("#button", "ratio")));
+}
+
+TEST_CASE("Integral operations reject operands they can't convert", "[StackedStyleParser]")
+{
+    // Given
+    const std::string code = "big = 1.5 * 1e18 * 1e18 * 1e18;\n"
+                             "low = (0 - 4611686018427387904) * 2;\n"
+                             "#button { ratio: 3 / big; rest: 5 % big; wrap: 7 % 2.5; huge: 1e20; }\n"
+                             "#overflow { quotient: low / (0 - 1); remainder: low % (0 - 1); }";
+    MistakesContainer mistakes;
+    StackedStyleParser parser(std::make_unique<EndToEndTokenizer>("", mistakes), mistakes);
+
+    // When
+    parser.ParseFromCode(code);
+
+    // Then
+    REQUIRE(std::ranges::count(mistakes, std::string("Operand of % out of range"), &CompilationMistake::Extra) == 1);
+    REQUIRE(std::ranges::count(mistakes, std::string("Integer overflow"), &CompilationMistake::Extra) == 2);
+    REQUIRE(std::abs(*parser.TryGet<Float>("#button", "ratio") - 2e-54) < 1e-60);
+    REQUIRE_FALSE(parser.FindValue("#button", "rest"));
+    REQUIRE(parser.TryGet<Integer>("#button", "wrap") == 1);
+    REQUIRE(parser.TryGet<Float>("#button", "huge") == 1e20);
+    REQUIRE_FALSE(parser.FindValue("#overflow", "quotient"));
+    REQUIRE_FALSE(parser.FindValue("#overflow", "remainder"));
+}
+
+TEST_CASE("An unmatched parenthesis drops its statement", "[StackedStyleParser]")
+{
+    // Given
+    const std::string code = "a = 1 + 2); b = 3;\n#button { width: (4)) * 2; height: 5; }";
+    MistakesContainer mistakes;
+    StackedStyleParser parser(std::make_unique<EndToEndTokenizer>("", mistakes), mistakes);
+
+    // When
+    parser.ParseFromCode(code);
+
+    // Then
+    REQUIRE(mistakes.size() == 2);
+    REQUIRE(std::ranges::count(mistakes, std::string(")"), &CompilationMistake::Extra) == 2);
+    REQUIRE_FALSE(parser.FindValue("#", "a"));
+    REQUIRE(parser.TryGet<Integer>("#", "b") == 3);
+    REQUIRE_FALSE(parser.FindValue("#button", "width"));
+    REQUIRE(parser.TryGet<Integer>("#button", "height") == 5);
+}
+
+TEST_CASE("Batch parsing can run inside a task of its own pool", "[StackedStyleParser]")
+{
+    // Given
+    const std::vector<std::string> codes { "#a { width: 1; }", "#b { width: 2; }", "#c { width: 3; }" };
+    Trema::Utils::ThreadPool pool(1);
+    MistakesContainer mistakes;
+    StackedStyleParser parser(std::make_unique<EndToEndTokenizer>("", mistakes), mistakes);
+
+    // When
+    pool.Submit([&] { parser.ParseCodes(codes, pool); }).get();
+
+    // Then
+    REQUIRE(mistakes.empty());
+    REQUIRE(parser.TryGet<Integer>("#c", "width") == 3);
+}
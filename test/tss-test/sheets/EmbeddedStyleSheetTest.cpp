@@ -0,0 +1,94 @@
+#include <catch2/catch_test_macros.hpp>
+#include <tss/parsing/StackedStyleParser.h>
+#include <tss/sheets/EmbeddedStyleSheet.h>
+#include <tss/tokenization/EndToEndTokenizer.h>
+
+using namespace Trema::Style;
+
+namespace
+{
+    constexpr auto Defaults = Embedded::Parse<R"(
+        /* Built-in theme */
+        spacing = 4;
+        accent: 0xCC0000FF;
+
+        #button {
+            margin: spacing * 2 + 1;
+            ratio: (spacing + 2) * 0.25;
+            color: accent;
+            label: "OK";
+            enabled: true;
+        }
+
+        # {
+            spacing: 100;
+            opacity: 0.5;
+        }
+
+        #button {
+            margin: 3;
+        }
+    )">();
+}
+
+TEST_CASE("Embedded sheets are parsed at compile time", "[EmbeddedStyleSheet]")
+{
+    // Given
+    // When
+
+    // Then
+    STATIC_REQUIRE(Defaults.Size() == 8);
+    STATIC_REQUIRE(Defaults.Find("#button", "margin")->AsInteger() == 3);
+    STATIC_REQUIRE(Defaults.Find("#button", "ratio")->Type == Embedded::Kind::Float);
+    STATIC_REQUIRE(Defaults.Find("#button", "ratio")->AsFloat() == 1.5);
+    STATIC_REQUIRE(Defaults.Find("#button", "color")->AsInteger() == 0xCC0000FF);
+    STATIC_REQUIRE(Defaults.Find("#button", "color")->AsColor() == Color { 0xCC0000FF });
+    STATIC_REQUIRE(Defaults.Find("#button", "label")->AsString() == "OK");
+    STATIC_REQUIRE(Defaults.Find("#button", "enabled")->AsBool());
+    STATIC_REQUIRE(Defaults.HasSelector("#button"));
+    STATIC_REQUIRE_FALSE(Defaults.HasSelector("#label"));
+    STATIC_REQUIRE_FALSE(Defaults.Find("#button", "padding").has_value());
+}
+
+TEST_CASE("Embedded sheets match the runtime parser", "[EmbeddedStyleSheet]")
+{
+    // Given
+    constexpr auto embedded = Embedded::Parse<R"(
+        size = 12; name = "Title"; visible = true; scale = 1.25; whole = 2.0;
+        #label { text: name; size: size; shown: visible; zoom: scale; }
+        # { size: 10; extra: whole; }
+        panel { width: 300; }
+        #math { margin: size * 2 + 1; offset: -(2 + 3); neg: -size * 2; half: 7 / 2; mixed: scale * 4 - 1; }
+        #signs { a: 2 - -3; b: -scale; c: 10 % -(3); d: (-2) * -size; }
+        #range { huge: 1e20; tiny: 3 / (1.5 * 1e18 * 1e18 * 1e18); wrap: 7 % 2.5; }
+    )">();
+    const std::string code = R"(
+        size = 12; name = "Title"; visible = true; scale = 1.25; whole = 2.0;
+        #label { text: name; size: size; shown: visible; zoom: scale; }
+        # { size: 10; extra: whole; }
+        panel { width: 300; }
+        #math { margin: size * 2 + 1; offset: -(2 + 3); neg: -size * 2; half: 7 / 2; mixed: scale * 4 - 1; }
+        #signs { a: 2 - -3; b: -scale; c: 10 % -(3); d: (-2) * -size; }
+        #range { huge: 1e20; tiny: 3 / (1.5 * 1e18 * 1e18 * 1e18); wrap: 7 % 2.5; }
+    )";
+    MistakesContainer mistakes;
+    StackedStyleParser parser(std::make_unique<EndToEndTokenizer>(code, mistakes), mistakes);
+
+    // When
+    parser.ParseFromCode(code);
+
+    // Then
+    REQUIRE(mistakes.empty());
+    std::size_t count = 0;
+    for (const auto& [selector, table] : parser.GetVariables())
+    {
+        for (const auto& [name, variable] : *table)
+        {
+            const auto value = embedded.Find(selector, name.View());
+            REQUIRE(value.has_value());
+            REQUIRE(Variable(value->ToValue()).GetIdentity() == variable.GetIdentity());
+            ++count;
+        }
+    }
+    REQUIRE(count == embedded.Size());
+}
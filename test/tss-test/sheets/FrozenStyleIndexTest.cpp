@@ -0,0 +1,155 @@
+#include <catch2/catch_test_macros.hpp>
+#include <tss/parsing/StackedStyleParser.h>
+#include <tss/tokenization/EndToEndTokenizer.h>
+#include <tss/sheets/FrozenStyleIndex.h>
+#include <cstddef>
+#include <cstring>
+#include <set>
+#include <string>
+
+using namespace Trema::Style;
+
+namespace
+{
+    FrozenStyleIndex FreezeCode(const std::string& code)
+    {
+        MistakesContainer mistakes;
+        StackedStyleParser parser(std::make_unique<EndToEndTokenizer>(code, mistakes), mistakes);
+        parser.ParseFromCode(code);
+        REQUIRE(mistakes.empty());
+        return parser.Freeze();
+    }
+}
+
+TEST_CASE("FrozenStyleIndex finds every parsed property", "[FrozenStyleIndex]")
+{
+    // Given
+    const std::string code = "red: 5;\n"
+                             "#button { width: 100; opacity: 0.5; label: \"OK\"; visible: true; }\n"
+                             "#panel { width: 300; }\n";
+
+    // When
+    const auto index = FreezeCode(code);
+
+    // Then
+    REQUIRE(index.SelectorCount() == 3);
+    REQUIRE(index.PropertyCount() == 6);
+    REQUIRE(std::get<Integer>(*index.Find("#", "red")) == 5);
+    REQUIRE(std::get<Integer>(*index.Find("#button", "width")) == 100);
+    REQUIRE(std::get<Float>(*index.Find("#button", "opacity")) == 0.5);
+    REQUIRE(std::get<StringRef>(*index.Find("#button", "label")) == "OK");
+    REQUIRE(std::get<bool>(*index.Find("#button", "visible")));
+    REQUIRE(std::get<Integer>(*index.Find("#panel", "width")) == 300);
+}
+
+TEST_CASE("FrozenStyleIndex reports misses", "[FrozenStyleIndex]")
+{
+    // Given
+    const auto index = FreezeCode("#button { width: 100; }");
+
+    // Then
+    REQUIRE_FALSE(index.Find("#button", "height").has_value());
+    REQUIRE_FALSE(index.Find("#panel", "width").has_value());
+    REQUIRE(index.FindSelector("#panel") == FrozenStyleIndex::NotFound);
+    REQUIRE_FALSE(FrozenStyleIndex().Find("#button", "width").has_value());
+}
+
+TEST_CASE("FrozenStyleIndex enumerates the properties of a selector", "[FrozenStyleIndex]")
+{
+    // Given
+    std::string code = "#big {";
+    for (int i = 0; i < 500; ++i)
+        code += " p" + std::to_string(i) + ": " + std::to_string(i) + ";";
+    code += " }";
+
+    // When
+    const auto index = FreezeCode(code);
+    const auto selector = index.FindSelector("#big");
+
+    // Then
+    REQUIRE(selector != FrozenStyleIndex::NotFound);
+    REQUIRE(index.GetSelectorName(selector) == "#big");
+    REQUIRE(index.GetSelectorPropertyCount(selector) == 500);
+
+    std::set<std::string> names;
+    for (std::uint32_t i = 0; i < index.GetSelectorPropertyCount(selector); ++i)
+    {
+        const auto property = index.GetSelectorProperty(selector, i);
+        REQUIRE(index.GetPropertySelector(property) == selector);
+        names.emplace(index.GetPropertyName(property));
+    }
+    REQUIRE(names.size() == 500);
+    REQUIRE(std::get<Integer>(*index.Find("#big", "p499")) == 499);
+}
+
+TEST_CASE("FrozenStyleIndex rejects invalid images", "[FrozenStyleIndex]")
+{
+    // Given
+    const auto index = FreezeCode("#button { width: 100; }");
+    const auto image = index.GetImage();
+    auto copy = std::make_shared<std::vector<std::byte>>(image.begin(), image.end());
+    (*copy)[0] = std::byte { 'X' };
+
+    // Then
+    REQUIRE_THROWS_AS(FrozenStyleIndex::FromImage(std::shared_ptr<const std::byte>(copy, copy->data()), copy->size()),
+                      std::runtime_error);
+    REQUIRE_THROWS_AS(FrozenStyleIndex::FromImage(std::shared_ptr<const std::byte>(copy, copy->data()), 8),
+                      std::runtime_error);
+}
+
+TEST_CASE("FrozenStyleIndex rejects images with slots out of bounds", "[FrozenStyleIndex]")
+{
+    // Given
+    const auto index = FreezeCode("#button { width: 100; height: 20; }");
+    const auto image = index.GetImage();
+    Format::Header header;
+    std::memcpy(&header, image.data(), sizeof(header));
+    const auto corrupt = [&](const std::uint64_t offset, const std::uint32_t slot)
+    {
+        auto copy = std::make_shared<std::vector<std::byte>>(image.begin(), image.end());
+        std::memcpy(copy->data() + offset, &slot, sizeof(slot));
+        return FrozenStyleIndex::FromImage(std::shared_ptr<const std::byte>(copy, copy->data()), copy->size());
+    };
+
+    // Then
+    REQUIRE_NOTHROW(corrupt(header.PropertyList, 1));
+    REQUIRE_THROWS_AS(corrupt(header.PropertyList, header.PropertyCount), std::runtime_error);
+    REQUIRE_THROWS_AS(corrupt(header.Properties + offsetof(Format::PropertyRecord, Selector), header.SelectorCount),
+                      std::runtime_error);
+}
+
+TEST_CASE("FrozenStyleIndex keeps colours", "[FrozenStyleIndex]")
+{
+    // Given
+    const auto index = FreezeCode("accent = 0x3366CCFF;\n#button { color: accent; border: 0x00000080; }");
+
+    // When
+    const auto color = index.Find("#button", "color");
+    const auto border = index.Find("#button", "border");
+
+    // Then
+    REQUIRE(std::get<Color>(*color) == Color { 0x3366CCFF });
+    REQUIRE(std::get<Color>(*border).A() == 0x80);
+}
+
+TEST_CASE("FrozenStyleIndex shares equal values and strings", "[FrozenStyleIndex]")
+{
+    // Given
+    std::string code;
+    for (int i = 0; i < 200; ++i)
+        code += "#button" + std::to_string(i) + " { width: 100; color: 0xCC0000FF; font: \"Inter\"; }\n";
+
+    // When
+    const auto index = FreezeCode(code);
+    const auto statistics = index.GetMemoryStatistics();
+
+    // Then
+    REQUIRE(statistics.PropertyCount == 600);
+    REQUIRE(statistics.ValueCount == 3);
+    REQUIRE(statistics.ValueBytes == 3 * sizeof(Format::StoredValue));
+    REQUIRE(statistics.ImageBytes == index.GetImage().size());
+    // Records of the selector names, "#", then "width", "color", "font" and "Inter" once each
+    REQUIRE(statistics.StringBytes == 200 * 16 + 8 + 4 * 12);
+    REQUIRE(std::get<StringRef>(*index.Find("#button199", "font")) == "Inter");
+    REQUIRE(std::get<Color>(*index.Find("#button7", "color")) == Color { 0xCC0000FF });
+}
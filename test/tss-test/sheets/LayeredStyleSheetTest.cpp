@@ -0,0 +1,48 @@
+#include <catch2/catch_test_macros.hpp>
+#include <tss/sheets/LayeredStyleSheet.h>
+#include <string>
+#include <tss-test/TestHelpers.h>
+
+using namespace Trema::Style;
+using namespace Trema::Style::Testing;
+
+TEST_CASE("LayeredStyleSheet returns the value of the topmost layer", "[LayeredStyleSheet]")
+{
+    // Given
+    LayeredStyleSheet sheet(ParseSheet("#window { background: \"white\"; text: \"black\"; padding: 4; }"));
+    const auto dark = ParseSheet("#window { background: \"black\"; text: \"white\"; }");
+    const auto customer = ParseSheet("#window { background: \"navy\"; }\n#logo { width: 64; }");
+
+    // When
+    sheet.Push(dark);
+    sheet.Push(customer);
+
+    // Then
+    REQUIRE(sheet.LayerCount() == 3);
+    REQUIRE(sheet.TryGet<std::string_view>("#window", "background") == "navy");
+    REQUIRE(sheet.TryGet<std::string_view>("#window", "text") == "white");
+    REQUIRE(sheet.TryGet<Integer>("#window", "padding") == 4);
+    REQUIRE(sheet.TryGet<Integer>("#logo", "width") == 64);
+    REQUIRE(sheet.HasSelector("#logo"));
+    REQUIRE_FALSE(sheet.Find("#window", "margin").has_value());
+    REQUIRE_FALSE(sheet.HasSelector("#missing"));
+}
+
+TEST_CASE("LayeredStyleSheet switches themes by popping and pushing layers", "[LayeredStyleSheet]")
+{
+    // Given
+    LayeredStyleSheet sheet(ParseSheet("#window { background: \"white\"; }"));
+    sheet.Push(ParseSheet("#window { background: \"black\"; }"));
+    const auto base = sheet.GetLayer(0);
+
+    // When
+    const auto dark = sheet.Pop();
+    const auto light = sheet.TryGet<std::string_view>("#window", "background");
+    sheet.Push(dark);
+
+    // Then
+    REQUIRE(light == "white");
+    REQUIRE(sheet.TryGet<std::string_view>("#window", "background") == "black");
+    REQUIRE(sheet.GetLayer(0) == base);
+    REQUIRE(sheet.GetLayer(1) == dark);
+}
@@ -0,0 +1,129 @@
+#include <catch2/catch_test_macros.hpp>
+#include <tss/sheets/FrozenStyleIndex.h>
+#include <tss/sheets/RuleIndex.h>
+#include <array>
+#include <string>
+#include <vector>
+#include <tss-test/TestHelpers.h>
+
+using namespace Trema::Style;
+using namespace Trema::Style::Testing;
+
+namespace
+{
+    std::vector<std::string> Texts(const std::vector<const RuleIndex::Rule*>& rules)
+    {
+        std::vector<std::string> texts;
+        for (const auto rule : rules)
+            texts.push_back(rule->Text);
+        return texts;
+    }
+}
+
+TEST_CASE("Selectors parse into compounds", "[RuleIndex]")
+{
+    // Given
+    const auto selector = Selector::Parse("window #dialog button.primary.large");
+
+    // When
+    const auto compounds = selector->GetCompounds();
+
+    // Then
+    REQUIRE(compounds.size() == 3);
+    REQUIRE(compounds[0].Type == "window");
+    REQUIRE(compounds[1].Id == "dialog");
+    REQUIRE(compounds[2].Type == "button");
+    REQUIRE(compounds[2].Classes == std::vector<std::string> { "primary", "large" });
+    REQUIRE(selector->GetSpecificity() == Specificity { 1, 2, 2 });
+    REQUIRE(Selector::Parse("#")->GetSubject().Id.empty());
+    REQUIRE_FALSE(Selector::Parse("a.").has_value());
+    REQUIRE_FALSE(Selector::Parse("#a#b").has_value());
+}
+
+TEST_CASE("RuleIndex returns the matching rules, least specific first", "[RuleIndex]")
+{
+    // Given
+    const RuleIndex index(ParseSelectors("# { a: 1; }\n"
+                                         "button { a: 2; }\n"
+                                         ".primary { a: 3; }\n"
+                                         "button.primary { a: 4; }\n"
+                                         "#ok { a: 5; }\n"
+                                         "#dialog .primary { a: 6; }\n"
+                                         "#sidebar .primary { a: 7; }\n"
+                                         "label { a: 8; }\n"));
+    const std::array<std::string_view, 1> classes { "primary" };
+    const ElementInfo ok { .Type = "button", .Id = "ok", .Classes = classes };
+    const std::array<ElementInfo, 2> ancestors { ElementInfo { .Type = "window" }, ElementInfo { .Id = "dialog" } };
+    AncestorFilter filter;
+    for (const auto& ancestor : ancestors)
+        filter.Push(ancestor);
+    std::vector<const RuleIndex::Rule*> matches;
+
+    // When
+    index.Match(ok, ancestors, &filter, matches);
+
+    // Then
+    REQUIRE(Texts(matches) == std::vector<std::string> { "#", "button", ".primary", "button.primary", "#ok",
+                                                         "#dialog .primary" });
+    REQUIRE(index.CountCandidates(ok) == 7);
+}
+
+TEST_CASE("RuleIndex only looks at the rules that could match", "[RuleIndex]")
+{
+    // Given
+    std::string code;
+    for (int i = 0; i < 1000; ++i)
+        code += "#widget-" + std::to_string(i) + " .item { a: " + std::to_string(i) + "; }\n";
+    const RuleIndex index(ParseSelectors(code));
+    const std::array<std::string_view, 1> classes { "item" };
+    const ElementInfo element { .Type = "label", .Id = "label-3", .Classes = classes };
+    const ElementInfo parent { .Id = "widget-42" };
+    AncestorFilter filter;
+    filter.Push(parent);
+    std::vector<const RuleIndex::Rule*> matches;
+
+    // When
+    index.Match(element, { &parent, 1 }, &filter, matches);
+    filter.Pop(parent);
+    const auto afterPop = matches.size();
+    index.Match(element, { }, &filter, matches);
+
+    // Then
+    REQUIRE(index.RuleCount() == 1001); // and the global scope
+    REQUIRE(index.CountCandidates(ElementInfo { .Type = "label", .Id = "label-3" }) == 1);
+    REQUIRE(Texts(matches) == std::vector<std::string> { "#", "#widget-42 .item", "#" });
+    REQUIRE(afterPop == 2);
+    REQUIRE_FALSE(filter.MayContain(AncestorFilter::HashId("widget-42")));
+}
+
+TEST_CASE("RuleIndex puts rules of equal specificity in source order", "[RuleIndex]")
+{
+    // Given
+    const std::string code = ".b { x: 2; }\n"
+                             ".a { x: 1; }\n"
+                             ".b { y: 3; }\n";
+    const std::array<std::string_view, 2> classes { "a", "b" };
+    const ElementInfo element { .Type = "label", .Classes = classes };
+    MistakesContainer mistakes;
+    StackedStyleParser parser(std::make_unique<EndToEndTokenizer>("", mistakes), mistakes);
+    const std::array<std::string, 2> files { ".d { x: 4; }", ".c { x: 5; }" };
+    parser.ParseCodes(files);
+    const auto selectors = ParseSelectors(code);
+    std::vector<const RuleIndex::Rule*> parsed;
+    std::vector<const RuleIndex::Rule*> thawed;
+    std::vector<const RuleIndex::Rule*> merged;
+
+    // When
+    const RuleIndex parsedIndex(selectors);
+    parsedIndex.Match(element, { }, nullptr, parsed);
+    const RuleIndex thawedIndex(FrozenStyleIndex::Build(selectors).Thaw());
+    thawedIndex.Match(element, { }, nullptr, thawed);
+    const RuleIndex mergedIndex(parser.GetVariables());
+    const std::array<std::string_view, 2> otherClasses { "c", "d" };
+    mergedIndex.Match(ElementInfo { .Type = "label", .Classes = otherClasses }, { }, nullptr, merged);
+
+    // Then
+    REQUIRE(Texts(parsed) == std::vector<std::string> { "#", ".b", ".a" });
+    REQUIRE(Texts(thawed) == Texts(parsed));
+    REQUIRE(Texts(merged) == std::vector<std::string> { "#", ".d", ".c" });
+}
@@ -0,0 +1,143 @@
+#include <catch2/catch_test_macros.hpp>
+#include <tss/parsing/StackedStyleParser.h>
+#include <tss/tokenization/EndToEndTokenizer.h>
+#include <tss/sheets/SlottedStyles.h>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+using namespace Trema::Style;
+
+namespace
+{
+    struct Keys
+    {
+        PropertyKey<Integer> Width;
+        PropertyKey<Float> Opacity;
+        PropertyKey<bool> Visible;
+        PropertyKey<std::string_view> Label;
+    };
+
+    std::shared_ptr<PropertySchema> MakeSchema(Keys& keys)
+    {
+        auto schema = std::make_shared<PropertySchema>();
+        keys.Width = schema->Register<Integer>("width", 100);
+        keys.Opacity = schema->Register<Float>("opacity", 1.0);
+        keys.Visible = schema->Register<bool>("visible", true);
+        keys.Label = schema->Register<std::string_view>("label", "none");
+        return schema;
+    }
+}
+
+TEST_CASE("SlottedStyles reads registered properties from slots", "[SlottedStyles]")
+{
+    // Given
+    const std::string code = "#ok { width: 80; opacity: 1; visible: false; label: \"OK\"; cursor: \"hand\"; }";
+    MistakesContainer mistakes;
+    StackedStyleParser parser(std::make_unique<EndToEndTokenizer>(code, mistakes), mistakes);
+    Keys keys { };
+    parser.SetSchema(MakeSchema(keys));
+    parser.ParseFromCode(code);
+
+    // When
+    const auto styles = parser.BuildSlottedStyles();
+    const auto ok = styles.Find("#ok");
+
+    // Then
+    REQUIRE(mistakes.empty());
+    REQUIRE(ok != nullptr);
+    REQUIRE(ok->Get(keys.Width) == 80);
+    REQUIRE(ok->Get(keys.Opacity) == 1.0);
+    REQUIRE_FALSE(ok->Get(keys.Visible));
+    REQUIRE(ok->Get(keys.Label) == "OK");
+    REQUIRE(ok->IsSet(keys.Visible));
+    REQUIRE(std::get<StringRef>(*ok->FindOther("cursor")) == "hand");
+    REQUIRE(ok->FindOther("missing") == nullptr);
+    REQUIRE(styles.Find("#missing") == nullptr);
+}
+
+TEST_CASE("SlottedStyles falls back to the defaults", "[SlottedStyles]")
+{
+    // Given
+    const std::string code = "#ok, #cancel { width: 80; }";
+    MistakesContainer mistakes;
+    StackedStyleParser parser(std::make_unique<EndToEndTokenizer>(code, mistakes), mistakes);
+    Keys keys { };
+    parser.SetSchema(MakeSchema(keys));
+    parser.ParseFromCode(code);
+
+    // When
+    const auto styles = parser.BuildSlottedStyles();
+    const auto cancel = styles.Find("#cancel");
+    const auto global = styles.Find("#");
+
+    // Then
+    REQUIRE(cancel == styles.Find("#ok"));
+    REQUIRE(cancel->Get(keys.Width) == 80);
+    REQUIRE_FALSE(cancel->IsSet(keys.Opacity));
+    REQUIRE(cancel->Get(keys.Opacity) == 1.0);
+    REQUIRE(cancel->Get(keys.Visible));
+    REQUIRE(global->Get(keys.Label) == "none");
+    REQUIRE_FALSE(global->IsSet(keys.Width));
+}
+
+TEST_CASE("Parser reports values of the wrong type for the schema", "[SlottedStyles]")
+{
+    // Given
+    const std::string code = "title = \"Dialog\";\n#ok { width: \"wide\"; label: title; visible: title; }";
+    MistakesContainer mistakes;
+    StackedStyleParser parser(std::make_unique<EndToEndTokenizer>(code, mistakes), mistakes);
+    Keys keys { };
+    parser.SetSchema(MakeSchema(keys));
+
+    // When
+    parser.ParseFromCode(code);
+    const auto styles = parser.BuildSlottedStyles();
+    const auto ok = styles.Find("#ok");
+
+    // Then
+    REQUIRE(mistakes.size() == 2);
+    REQUIRE(mistakes[0].Code == ErrorCode::TypeMismatch);
+    REQUIRE(mistakes[0].Line == 2);
+    REQUIRE(mistakes[0].Extra == "width expects Integer");
+    REQUIRE(mistakes[1].Extra == "visible expects Bool");
+    REQUIRE(parser.FindValue("#ok", "width") == nullptr);
+    REQUIRE(ok->Get(keys.Label) == "Dialog");
+    REQUIRE_FALSE(ok->IsSet(keys.Width));
+}
+
+TEST_CASE("Parser reports schema properties of the wrong type set with '='", "[SlottedStyles]")
+{
+    // Given
+    const std::string code = "#ok { width = \"x\"; opacity = 0.5; }";
+    MistakesContainer mistakes;
+    StackedStyleParser parser(std::make_unique<EndToEndTokenizer>(code, mistakes), mistakes);
+    Keys keys { };
+    parser.SetSchema(MakeSchema(keys));
+
+    // When
+    parser.ParseFromCode(code);
+    const auto styles = parser.BuildSlottedStyles();
+    const auto ok = styles.Find("#ok");
+
+    // Then
+    REQUIRE(mistakes.size() == 1);
+    REQUIRE(mistakes[0].Code == ErrorCode::TypeMismatch);
+    REQUIRE(mistakes[0].Extra == "width expects Integer");
+    REQUIRE(parser.FindValue("#ok", "width") == nullptr);
+    REQUIRE_FALSE(ok->IsSet(keys.Width));
+    REQUIRE(ok->Get(keys.Opacity) == 0.5);
+}
+
+TEST_CASE("BuildSlottedStyles needs a schema", "[SlottedStyles]")
+{
+    // Given
+    MistakesContainer mistakes;
+    StackedStyleParser parser(std::make_unique<EndToEndTokenizer>("", mistakes), mistakes);
+
+    // When
+    parser.ParseFromCode("#ok { width: 80; }");
+
+    // Then
+    REQUIRE_THROWS_AS(parser.BuildSlottedStyles(), std::logic_error);
+}
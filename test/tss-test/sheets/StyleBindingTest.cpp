@@ -0,0 +1,85 @@
+#include <catch2/catch_test_macros.hpp>
+#include <tss/sheets/StyleBinding.h>
+#include <array>
+#include <stdexcept>
+#include <string>
+#include <tss-test/TestHelpers.h>
+
+using namespace Trema::Style;
+using namespace Trema::Style::Testing;
+
+namespace
+{
+    struct ButtonStyle
+    {
+        Integer Width = 10;
+        Float Opacity = 1.0;
+        bool Visible = true;
+        std::string_view Label = "none";
+    };
+}
+
+template<>
+struct Trema::Style::StyleFields<ButtonStyle>
+{
+    static constexpr auto Fields = std::make_tuple(
+        Field("width", &ButtonStyle::Width),
+        Field("opacity", &ButtonStyle::Opacity),
+        Field("visible", &ButtonStyle::Visible),
+        Field("label", &ButtonStyle::Label));
+};
+
+TEST_CASE("StyleBinding fills a struct from a selector", "[StyleBinding]")
+{
+    // Given
+    const StyleBinding<ButtonStyle> binding(ParseSheet("#ok { width: 80; opacity: 0.5; visible: false; label: \"OK\"; }"));
+    ButtonStyle style;
+
+    // When
+    const auto found = binding.Fill("#ok", style);
+
+    // Then
+    REQUIRE(found);
+    REQUIRE(style.Width == 80);
+    REQUIRE(style.Opacity == 0.5);
+    REQUIRE_FALSE(style.Visible);
+    REQUIRE(style.Label == "OK");
+}
+
+TEST_CASE("StyleBinding keeps fields the selector doesn't set", "[StyleBinding]")
+{
+    // Given
+    const StyleBinding<ButtonStyle> binding(ParseSheet("#ok { width: \"wide\"; opacity: 2; }"));
+    ButtonStyle style;
+    ButtonStyle missing;
+
+    // When
+    binding.Fill(binding.FindSelector("#ok"), style);
+    const auto found = binding.Fill("#missing", missing);
+
+    // Then
+    REQUIRE(style.Width == 10);
+    REQUIRE(style.Opacity == 2.0);
+    REQUIRE(style.Label == "none");
+    REQUIRE_FALSE(found);
+    REQUIRE(missing.Width == 10);
+}
+
+TEST_CASE("StyleBinding fills batches of structs", "[StyleBinding]")
+{
+    // Given
+    const StyleBinding<ButtonStyle> binding(ParseSheet("#ok, #apply { width: 80; }\n#cancel { width: 60; label: \"Cancel\"; }"));
+    const std::array<std::string_view, 4> selectors { "#ok", "#cancel", "#missing", "#apply" };
+    std::array<ButtonStyle, 4> styles { };
+
+    // When
+    binding.Fill(selectors, styles);
+
+    // Then
+    REQUIRE(styles[0].Width == 80);
+    REQUIRE(styles[1].Width == 60);
+    REQUIRE(styles[1].Label == "Cancel");
+    REQUIRE(styles[2].Width == 10);
+    REQUIRE(styles[3].Width == 80);
+    REQUIRE_THROWS_AS(binding.Fill(std::span(selectors).first(2), styles), std::invalid_argument);
+}
@@ -0,0 +1,98 @@
+#include <catch2/catch_test_macros.hpp>
+#include <tss/sheets/StyleResolver.h>
+#include <string>
+#include <vector>
+#include <tss-test/TestHelpers.h>
+
+using namespace Trema::Style;
+using namespace Trema::Style::Testing;
+
+TEST_CASE("StyleResolver applies the element over its ancestors over the global scope", "[StyleResolver]")
+{
+    // Given
+    StyleResolver resolver(ParseSheet("# { color: \"black\"; size: 10; border: 1; }\n"
+                                      "#window { color: \"grey\"; size: 12; }\n"
+                                      "#dialog { size: 14; }\n"
+                                      "#ok { color: \"blue\"; bold: true; }\n"));
+    const std::vector<std::string_view> ancestors { "window", "dialog" };
+
+    // When
+    const auto style = resolver.Resolve("ok", ancestors);
+
+    // Then
+    REQUIRE(style->PropertyCount() == 4);
+    REQUIRE(style->TryGet<std::string_view>("color") == "blue");
+    REQUIRE(style->TryGet<Integer>("size") == 14);
+    REQUIRE(style->TryGet<Integer>("border") == 1);
+    REQUIRE(style->TryGet<bool>("bold") == true);
+    REQUIRE(style->Find("missing") == nullptr);
+}
+
+TEST_CASE("StyleResolver shares one style between elements resolving to the same chain", "[StyleResolver]")
+{
+    // Given
+    StyleResolver resolver(ParseSheet("# { size: 10; }\n#panel { size: 12; }\n#ok { bold: true; }\n"));
+    const std::vector<std::string_view> ancestors { "window", "panel" };
+
+    // When
+    const auto first = resolver.Resolve("label-1", ancestors);
+    const auto second = resolver.Resolve("label-2", ancestors);
+    const auto panel = resolver.Resolve("panel", std::span(ancestors).first(1));
+    const auto ok = resolver.Resolve("ok", ancestors);
+
+    // Then
+    REQUIRE(first == second);
+    REQUIRE(first == panel);
+    REQUIRE(ok != first);
+    REQUIRE(ok->TryGet<Integer>("size") == 12);
+    REQUIRE(resolver.GetStatistics().Hits == 2);
+    REQUIRE(resolver.GetStatistics().Styles == 3);
+}
+
+TEST_CASE("StyleResolver mostly hits the cache on a large widget tree", "[StyleResolver]")
+{
+    // Given
+    std::string code = "# { size: 10; }\n";
+    for (int i = 0; i < 10; ++i)
+        code += "#pane-" + std::to_string(i) + " { size: " + std::to_string(i) + "; }\n";
+    code += "#button-3 { bold: true; }\n";
+    StyleResolver resolver(ParseSheet(code));
+
+    // When
+    std::size_t bold = 0;
+    for (int pane = 0; pane < 100; ++pane)
+    {
+        const auto paneId = "pane-" + std::to_string(pane);
+        for (int button = 0; button < 100; ++button)
+        {
+            const auto buttonId = "button-" + std::to_string(button);
+            const std::vector<std::string_view> ancestors { "window", paneId };
+            const auto style = resolver.Resolve(buttonId, ancestors);
+            if (style->TryGet<bool>("bold"))
+                ++bold;
+            REQUIRE(style->TryGet<Integer>("size") == (pane < 10 ? pane : 10));
+        }
+    }
+
+    // Then
+    const auto statistics = resolver.GetStatistics();
+    REQUIRE(bold == 100);
+    REQUIRE(statistics.Hits + statistics.Misses == 10'000);
+    REQUIRE(statistics.Misses <= 22);
+    REQUIRE(statistics.Styles <= 22);
+}
+
+TEST_CASE("Computed styles outlive the resolver that built them", "[StyleResolver]")
+{
+    // Given
+    std::shared_ptr<const ComputedStyle> style;
+    {
+        StyleResolver resolver(ParseSheet("#label { text: \"Hello\"; }"));
+
+        // When
+        style = resolver.Resolve("label");
+    }
+
+    // Then
+    REQUIRE(style->TryGet<std::string_view>("text") == "Hello");
+}
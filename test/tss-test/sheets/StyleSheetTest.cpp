@@ -0,0 +1,153 @@
+#include <catch2/catch_test_macros.hpp>
+#include <tss/parsing/StackedStyleParser.h>
+#include <tss/tokenization/EndToEndTokenizer.h>
+#include <tss/sheets/StyleSheet.h>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+using namespace Trema::Style;
+
+TEST_CASE("StyleSheet outlives the parser that built it", "[StyleSheet]")
+{
+    // Given
+    StyleSheet sheet;
+    {
+        MistakesContainer mistakes;
+        const std::string code = "#label { text: \"Hello\"; size: 12; }";
+        StackedStyleParser parser(std::make_unique<EndToEndTokenizer>(code, mistakes), mistakes);
+        parser.ParseFromCode(code);
+
+        // When
+        sheet = parser.BuildStyleSheet();
+    }
+
+    // Then
+    REQUIRE(sheet.HasSelector("#label"));
+    REQUIRE(std::get<StringRef>(*sheet.Find("#label", "text")) == "Hello");
+    REQUIRE(std::get<Integer>(*sheet.Find("#label", "size")) == 12);
+}
+
+TEST_CASE("StyleSheet can be read concurrently from many threads", "[StyleSheet]")
+{
+    // Given
+    MistakesContainer mistakes;
+    std::string code;
+    for (int i = 0; i < 100; ++i)
+        code += "#e" + std::to_string(i) + " { width: " + std::to_string(i) + "; }\n";
+    StackedStyleParser parser(std::make_unique<EndToEndTokenizer>(code, mistakes), mistakes);
+    parser.ParseFromCode(code);
+    const auto sheet = parser.BuildStyleSheet();
+    std::atomic<int> failures { 0 };
+
+    // When
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([sheet, &failures]
+        {
+            for (int round = 0; round < 100; ++round)
+            {
+                for (int i = 0; i < 100; ++i)
+                {
+                    const auto value = sheet.Find("#e" + std::to_string(i), "width");
+                    if (!value || std::get<Integer>(*value) != i)
+                        ++failures;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    // Then
+    REQUIRE(failures == 0);
+}
+
+TEST_CASE("StyleSheet loads a precompiled file", "[StyleSheet]")
+{
+    // Given
+    const auto path = std::filesystem::temp_directory_path() / "tss-precompiled-test.tssc";
+    {
+        MistakesContainer mistakes;
+        const std::string code = "#label { text: \"Hello\"; size: 12; ratio: 1.5; visible: true; }";
+        StackedStyleParser parser(std::make_unique<EndToEndTokenizer>(code, mistakes), mistakes);
+        parser.ParseFromCode(code);
+        parser.BuildStyleSheet().Save(path);
+    }
+
+    // When
+    const auto sheet = StyleSheet::Load(path);
+
+    // Then
+    REQUIRE(sheet.SelectorCount() == 2);
+    REQUIRE(std::get<StringRef>(*sheet.Find("#label", "text")) == "Hello");
+    REQUIRE(std::get<Integer>(*sheet.Find("#label", "size")) == 12);
+    REQUIRE(std::get<Float>(*sheet.Find("#label", "ratio")) == 1.5);
+    REQUIRE(std::get<bool>(*sheet.Find("#label", "visible")));
+    REQUIRE_FALSE(sheet.Find("#label", "color").has_value());
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Values read from a precompiled sheet outlive it", "[StyleSheet]")
+{
+    // Given
+    const auto path = std::filesystem::temp_directory_path() / "tss-outlive-test.tssc";
+    {
+        MistakesContainer mistakes;
+        const std::string code = "#label { text: \"Outlives its image\"; }";
+        StackedStyleParser parser(std::make_unique<EndToEndTokenizer>(code, mistakes), mistakes);
+        parser.ParseFromCode(code);
+        parser.BuildStyleSheet().Save(path);
+    }
+    auto sheet = StyleSheet::Load(path);
+    const auto value = sheet.Find("#label", "text");
+
+    // When
+    sheet = StyleSheet();
+    std::filesystem::remove(path);
+
+    // Then
+    REQUIRE(std::get<StringRef>(*value).View() == "Outlives its image");
+    REQUIRE(std::get<StringRef>(*value).Data() == StringRef::Intern("Outlives its image").Data());
+}
+
+TEST_CASE("StyleSheet rejects files that are not precompiled sheets", "[StyleSheet]")
+{
+    // Given
+    const auto path = std::filesystem::temp_directory_path() / "tss-not-precompiled-test.tssc";
+    std::ofstream(path, std::ios::binary) << "#label { size: 12; }";
+
+    // When
+
+    // Then
+    REQUIRE_THROWS_AS(StyleSheet::Load(path), std::runtime_error);
+    REQUIRE_THROWS_AS(StyleSheet::Load(path.string() + ".missing"), std::runtime_error);
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("StyleSheet TryGet reads typed values without copying strings", "[StyleSheet]")
+{
+    // Given
+    MistakesContainer mistakes;
+    const std::string code = "#label { text: \"Hello\"; size: 12; ratio: 1.5; visible: true; }";
+    StackedStyleParser parser(std::make_unique<EndToEndTokenizer>(code, mistakes), mistakes);
+    parser.ParseFromCode(code);
+    const auto sheet = parser.BuildStyleSheet();
+    const std::string_view selector = "#label";
+
+    // When
+    const auto text = sheet.TryGet<std::string_view>(selector, "text");
+
+    // Then
+    REQUIRE(text == "Hello");
+    REQUIRE(sheet.TryGet<Integer>(selector, "size") == 12);
+    REQUIRE(sheet.TryGet<Float>(selector, "ratio") == 1.5);
+    REQUIRE(sheet.TryGet<bool>(selector, "visible") == true);
+    REQUIRE_FALSE(sheet.TryGet<Integer>(selector, "text").has_value());
+    REQUIRE_FALSE(sheet.TryGet<Integer>("#missing", "size").has_value());
+}
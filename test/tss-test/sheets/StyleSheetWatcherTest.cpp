@@ -0,0 +1,162 @@
+#include <catch2/catch_test_macros.hpp>
+#include <tss/sheets/StyleSheetWatcher.h>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <thread>
+
+using namespace Trema::Style;
+
+namespace
+{
+    void WriteFile(const std::filesystem::path& path, const std::string& code)
+    {
+        std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+        file << code;
+    }
+
+    bool WaitForGeneration(const StyleSheetWatcher& watcher, const std::uint64_t generation)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (watcher.GetGeneration() < generation)
+        {
+            if (std::chrono::steady_clock::now() > deadline)
+                return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return true;
+    }
+}
+
+TEST_CASE("StyleSheetWatcher publishes a new snapshot when a file changes", "[StyleSheetWatcher]")
+{
+    // Given
+    const auto directory = std::filesystem::temp_directory_path() / "tss-watcher-test";
+    std::filesystem::create_directories(directory);
+    const auto path = directory / "theme.tss";
+    WriteFile(path, "#button { width: 100; }");
+
+    StyleSheetWatcher watcher({ path });
+    watcher.Start();
+    const auto before = watcher.Current();
+    REQUIRE(std::get<Integer>(*before.Find("#button", "width")) == 100);
+
+    // When
+    WriteFile(path, "#button { width: 200; }");
+
+    // Then
+    REQUIRE(WaitForGeneration(watcher, 2));
+    REQUIRE(std::get<Integer>(*watcher.Current().Find("#button", "width")) == 200);
+    REQUIRE(std::get<Integer>(*before.Find("#button", "width")) == 100);
+
+    watcher.Stop();
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("StyleSheetWatcher keeps the current snapshot when a file disappears", "[StyleSheetWatcher]")
+{
+    // Given
+    const auto directory = std::filesystem::temp_directory_path() / "tss-watcher-missing-test";
+    std::filesystem::create_directories(directory);
+    const auto path = directory / "theme.tss";
+    WriteFile(path, "#button { width: 100; }");
+    StyleSheetWatcher watcher({ path });
+    watcher.Start();
+
+    // When
+    std::filesystem::remove(path);
+    const auto reloaded = watcher.Reload();
+
+    // Then
+    REQUIRE_FALSE(reloaded);
+    REQUIRE_FALSE(watcher.GetLastError().empty());
+    REQUIRE(std::get<Integer>(*watcher.Current().Find("#button", "width")) == 100);
+
+    watcher.Stop();
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("StyleSheetWatcher keeps the current snapshot when a save has mistakes", "[StyleSheetWatcher]")
+{
+    // Given
+    const auto directory = std::filesystem::temp_directory_path() / "tss-watcher-mistakes-test";
+    std::filesystem::create_directories(directory);
+    const auto path = directory / "theme.tss";
+    WriteFile(path, "#button { width: 100; }");
+    StyleSheetWatcher watcher({ path });
+    std::atomic<std::size_t> reported { 0 };
+    watcher.SetListener([&](const StyleSheet&, const MistakesContainer& mistakes) { reported += mistakes.size(); });
+    watcher.Start();
+    const auto generation = watcher.GetGeneration();
+
+    // When
+    WriteFile(path, "#button { width: missing; height: 20; }");
+    const auto broken = watcher.Reload();
+    const auto error = watcher.GetLastError();
+    const auto keptGeneration = watcher.GetGeneration();
+    const auto kept = watcher.Current();
+    WriteFile(path, "#button { width: 300; }");
+    const auto fixed = watcher.Reload();
+
+    // Then
+    REQUIRE_FALSE(broken);
+    REQUIRE_FALSE(error.empty());
+    REQUIRE(reported >= 1);
+    REQUIRE(keptGeneration == generation);
+    REQUIRE(std::get<Integer>(*kept.Find("#button", "width")) == 100);
+    REQUIRE_FALSE(kept.Find("#button", "height"));
+    REQUIRE(fixed);
+    REQUIRE(watcher.GetLastError().empty());
+    REQUIRE(watcher.GetGeneration() > generation);
+    REQUIRE(std::get<Integer>(*watcher.Current().Find("#button", "width")) == 300);
+
+    watcher.Stop();
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("StyleSheetWatcher keeps the current snapshot when a file is emptied", "[StyleSheetWatcher]")
+{
+    // Given
+    const auto directory = std::filesystem::temp_directory_path() / "tss-watcher-empty-test";
+    std::filesystem::create_directories(directory);
+    const auto path = directory / "theme.tss";
+    WriteFile(path, "#button { width: 100; }");
+    StyleSheetWatcher watcher({ path });
+    watcher.Start();
+    const auto generation = watcher.GetGeneration();
+
+    // When
+    WriteFile(path, "");
+    const auto reloaded = watcher.Reload();
+
+    // Then
+    REQUIRE_FALSE(reloaded);
+    REQUIRE_FALSE(watcher.GetLastError().empty());
+    REQUIRE(watcher.GetGeneration() == generation);
+    REQUIRE(std::get<Integer>(*watcher.Current().Find("#button", "width")) == 100);
+
+    watcher.Stop();
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("StyleSheetWatcher polls when no directory can be watched", "[StyleSheetWatcher]")
+{
+    // Given
+    const auto directory = std::filesystem::temp_directory_path() / "tss-watcher-unwatched-test";
+    std::filesystem::remove_all(directory);
+    const auto path = directory / "theme.tss";
+    StyleSheetWatcher watcher({ path });
+    watcher.Start();
+    const auto generation = watcher.GetGeneration();
+
+    // When
+    std::filesystem::create_directories(directory);
+    WriteFile(path, "#button { width: 100; }");
+
+    // Then
+    REQUIRE(WaitForGeneration(watcher, generation + 1));
+    REQUIRE(std::get<Integer>(*watcher.Current().Find("#button", "width")) == 100);
+
+    watcher.Stop();
+    std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,91 @@
+#include <catch2/catch_test_macros.hpp>
+#include <tss/sheets/TreeStyler.h>
+#include <string>
+#include <tss-test/TestHelpers.h>
+
+using namespace Trema::Style;
+using namespace Trema::Style::Testing;
+
+TEST_CASE("TreeStyler inherits the values an element doesn't set from its parent", "[TreeStyler]")
+{
+    // Given
+    const TreeStyler styler(ParseSelectors("# { color: \"black\"; size: 10; }\n"
+                                           "#dialog { size: 14; }\n"
+                                           "#ok { color: \"blue\"; }\n"),
+                            { "color", "size", "bold" });
+    ElementTree tree;
+    const auto window = tree.Add("window");
+    const auto dialog = tree.Add("dialog", window);
+    const auto ok = tree.Add("ok", dialog);
+    const auto cancel = tree.Add("cancel", dialog);
+    Trema::Utils::ThreadPool pool(2);
+
+    // When
+    const auto buffers = styler.Compute(tree, pool);
+
+    // Then
+    const auto color = buffers.GetColumn(buffers.FindProperty("color"));
+    const auto size = buffers.GetColumn(buffers.FindProperty("size"));
+    const auto bold = buffers.GetColumn(buffers.FindProperty("bold"));
+    REQUIRE(buffers.ElementCount() == 4);
+    REQUIRE(TryGet<std::string_view>(&color[window]) == "black");
+    REQUIRE(TryGet<Integer>(&size[window]) == 10);
+    REQUIRE(TryGet<Integer>(&size[dialog]) == 14);
+    REQUIRE(TryGet<std::string_view>(&color[ok]) == "blue");
+    REQUIRE(TryGet<Integer>(&size[ok]) == 14);
+    REQUIRE(TryGet<std::string_view>(&color[cancel]) == "black");
+    REQUIRE(std::holds_alternative<std::nullopt_t>(bold[ok]));
+}
+
+TEST_CASE("TreeStyler styles large trees across threads", "[TreeStyler]")
+{
+    // Given
+    std::string code = "# { depth: 0; }\n";
+    for (int i = 0; i < 20; ++i)
+        code += "#panel-" + std::to_string(i) + " { depth: " + std::to_string(i + 1) + "; }\n";
+    const TreeStyler styler(ParseSelectors(code), { "depth" });
+
+    // Twenty panels of a thousand widgets each, the widgets of a panel nested ten deep
+    ElementTree tree;
+    const auto root = tree.Add("dashboard");
+    for (int panel = 0; panel < 20; ++panel)
+    {
+        const auto panelElement = tree.Add("panel-" + std::to_string(panel), root);
+        for (int group = 0; group < 100; ++group)
+        {
+            auto parent = panelElement;
+            for (int depth = 0; depth < 10; ++depth)
+                parent = tree.Add("widget", parent);
+        }
+    }
+    Trema::Utils::ThreadPool pool(4);
+
+    // When
+    const auto buffers = styler.Compute(tree, pool);
+
+    // Then
+    const auto depth = buffers.GetColumn(0);
+    REQUIRE(TryGet<Integer>(&depth[root]) == 0);
+    for (std::uint32_t e = 1; e < tree.Size(); ++e)
+    {
+        auto panel = e;
+        while (tree.GetParent(panel) != root)
+            panel = tree.GetParent(panel);
+
+        const auto expected = std::stoi(std::string(tree.GetId(panel).substr(6))) + 1;
+        if (TryGet<Integer>(&depth[e]) != expected)
+            FAIL("Element " << e << " was not styled from its panel");
+    }
+}
+
+TEST_CASE("ElementTree rejects parents added after their children", "[TreeStyler]")
+{
+    // Given
+    ElementTree tree;
+
+    // When
+    tree.Add("root");
+
+    // Then
+    REQUIRE_THROWS_AS(tree.Add("child", 1), std::out_of_range);
+}
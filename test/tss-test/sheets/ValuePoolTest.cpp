@@ -0,0 +1,48 @@
+#include <catch2/catch_test_macros.hpp>
+#include <tss/sheets/ValuePool.h>
+
+using namespace Trema::Style;
+
+TEST_CASE("ValuePool stores equal values once", "[ValuePool]")
+{
+    // Given
+    ValuePool pool;
+
+    // When
+    const auto width = pool.Add(Integer { 100 });
+    const auto sameWidth = pool.Add(Integer { 100 });
+    const auto ratio = pool.Add(Float { 100 });
+    const auto font = pool.Add(StringRef("Inter"));
+    const auto sameFont = pool.Add(StringRef("Inter"));
+    const auto red = pool.Add(Color { 0xCC0000FF });
+    const auto zero = pool.Add(Float { 0.0 });
+    const auto negativeZero = pool.Add(Float { -0.0 });
+
+    // Then
+    REQUIRE(width == sameWidth);
+    REQUIRE(font == sameFont);
+    REQUIRE(width != ratio);
+    REQUIRE(red != width);
+    REQUIRE(zero != negativeZero);
+    REQUIRE(pool.GetValues().size() == 6);
+    REQUIRE(pool.GetStatistics().ValueRequests == 8);
+    REQUIRE(pool.GetStatistics().Values == 6);
+}
+
+TEST_CASE("ValuePool stores each string once", "[ValuePool]")
+{
+    // Given
+    ValuePool pool;
+
+    // When
+    const auto name = pool.AddString("width");
+    const auto value = pool.Add(StringRef("width"));
+    const auto other = pool.AddString("height");
+
+    // Then
+    REQUIRE(pool.GetValues()[value].String == name);
+    REQUIRE(other != name);
+    REQUIRE(pool.GetStatistics().StringRequests == 3);
+    REQUIRE(pool.GetStatistics().Strings == 2);
+    REQUIRE(pool.GetStatistics().StringBytes == 24); // 4 + 5 + 1 padded to 12, 4 + 6 + 1 padded to 12
+}
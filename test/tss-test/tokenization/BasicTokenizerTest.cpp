@@ -54,7 +54,31 @@ TEST_CASE("Identifies literal string")
 
     // Then
     REQUIRE(token.GetTokenType() == TokenType::LiteralString);
-    REQUIRE(std::get<std::string>(token.GetValue()) == "Hello, I'm testing out my code");
+    REQUIRE(std::get<StringRef>(token.GetValue()) == "Hello, I'm testing out my code");
+}
+
+TEST_CASE("Identifies colours")
+{
+    // Given
+    const std::string code = "accent: 0xCC0000fF; mask: 0xFF;";
+    MistakesContainer mistakes;
+
+    // When
+    EndToEndTokenizer t(code, mistakes);
+    t.GetNextToken();
+    t.GetNextToken();
+    const auto color = t.GetNextToken();
+    t.GetNextToken();
+    t.GetNextToken();
+    t.GetNextToken();
+    const auto number = t.GetNextToken();
+
+    // Then
+    REQUIRE(mistakes.empty());
+    REQUIRE(color.GetTokenType() == TokenType::LiteralColor);
+    REQUIRE(std::get<Color>(color.GetValue()) == Color { 0xCC0000FF });
+    REQUIRE(number.GetTokenType() == TokenType::LiteralNumber);
+    REQUIRE(std::get<Integer>(number.GetValue()) == 0xFF);
 }
 
 TEST_CASE("Identifies boolean value")
@@ -147,7 +171,7 @@ TEST_CASE("Catches comment")
 
     // Then
     REQUIRE(token.GetTokenType() == TokenType::Comment);
-    REQUIRE(std::get<std::string>(token.GetValue()) == comment);
+    REQUIRE(std::get<StringRef>(token.GetValue()) == comment);
 }
 
 TEST_CASE("Handles empty input")
@@ -270,7 +294,7 @@ TEST_CASE("Handles long identifier")
 
     // Then
     REQUIRE(token.GetTokenType() == TokenType::Identifier);
-    REQUIRE(std::get<std::string>(token.GetValue()) == longIdent);
+    REQUIRE(std::get<StringRef>(token.GetValue()) == longIdent);
 }
 
 TEST_CASE("Handles mixed token sequence")
@@ -309,7 +333,7 @@ TEST_CASE("Handles UTF-8 emojis in string literals")
 
     // Then
     REQUIRE(token.GetTokenType() == TokenType::LiteralString);
-    REQUIRE(std::get<std::string>(token.GetValue()) == "Hello 😀 World 🎉");
+    REQUIRE(std::get<StringRef>(token.GetValue()) == "Hello 😀 World 🎉");
 }
 
 TEST_CASE("Handles UTF-8 characters in identifiers")
@@ -324,7 +348,7 @@ TEST_CASE("Handles UTF-8 characters in identifiers")
 
     // Then
     REQUIRE(token.GetTokenType() == TokenType::Identifier);
-    REQUIRE(std::get<std::string>(token.GetValue()) == "café");
+    REQUIRE(std::get<StringRef>(token.GetValue()) == "café");
 }
 
 TEST_CASE("Handles UTF-8 emojis in identifiers")
@@ -339,7 +363,7 @@ TEST_CASE("Handles UTF-8 emojis in identifiers")
 
     // Then
     REQUIRE(token.GetTokenType() == TokenType::Identifier);
-    REQUIRE(std::get<std::string>(token.GetValue()) == "variable😀");
+    REQUIRE(std::get<StringRef>(token.GetValue()) == "variable😀");
 }
 
 TEST_CASE("Handles Chinese characters in identifiers")
@@ -354,7 +378,7 @@ TEST_CASE("Handles Chinese characters in identifiers")
 
     // Then
     REQUIRE(token.GetTokenType() == TokenType::Identifier);
-    REQUIRE(std::get<std::string>(token.GetValue()) == "变量名称");
+    REQUIRE(std::get<StringRef>(token.GetValue()) == "变量名称");
 }
 
 TEST_CASE("Handles mixed ASCII and UTF-8 in code")
@@ -375,10 +399,70 @@ TEST_CASE("Handles mixed ASCII and UTF-8 in code")
 
     Token stringToken = t.GetNextToken();
     REQUIRE(stringToken.GetTokenType() == TokenType::LiteralString);
-    REQUIRE(std::get<std::string>(stringToken.GetValue()) == "🚀 test");
+    REQUIRE(std::get<StringRef>(stringToken.GetValue()) == "🚀 test");
 
     REQUIRE(t.GetNextToken().GetTokenType() == TokenType::EndOfInstruction);
     REQUIRE(t.GetNextToken().GetTokenType() == TokenType::RightCurlyBracket);
     REQUIRE(t.GetNextToken().GetTokenType() == TokenType::EndOfCode);
 }
 
+
+TEST_CASE("Identifies directive")
+{
+    // Given
+    const std::string code = R"(@import "base.tss";)";
+    MistakesContainer mistakes;
+
+    // When
+    EndToEndTokenizer t(code, mistakes);
+    Token directive = t.GetNextToken();
+    Token path = t.GetNextToken();
+
+    // Then
+    REQUIRE(directive.GetTokenType() == TokenType::Directive);
+    REQUIRE(std::get<StringRef>(directive.GetValue()) == "import");
+    REQUIRE(path.GetTokenType() == TokenType::LiteralString);
+    REQUIRE(std::get<StringRef>(path.GetValue()) == "base.tss");
+    REQUIRE(t.GetNextToken().GetTokenType() == TokenType::EndOfInstruction);
+    REQUIRE(mistakes.empty());
+}
+
+TEST_CASE("Identifies class and universal selectors")
+{
+    // Given
+    const std::string code = "* .primary { width: 2 * .5; }";
+    MistakesContainer mistakes;
+
+    // When
+    EndToEndTokenizer t(code, mistakes);
+
+    // Then
+    REQUIRE(t.GetNextToken().GetTokenType() == TokenType::Universal);
+    REQUIRE(t.GetNextToken().GetTokenType() == TokenType::Class);
+    REQUIRE(std::get<StringRef>(t.GetNextToken().GetValue()) == "primary");
+    REQUIRE(t.GetNextToken().GetTokenType() == TokenType::LeftCurlyBracket);
+    REQUIRE(t.GetNextToken().GetTokenType() == TokenType::Identifier);
+    REQUIRE(t.GetNextToken().GetTokenType() == TokenType::PropertyAssignment);
+    REQUIRE(t.GetNextToken().GetTokenType() == TokenType::LiteralNumber);
+    REQUIRE(t.GetNextToken().GetTokenType() == TokenType::Operator);
+    REQUIRE(t.GetNextToken().GetTokenType() == TokenType::LiteralFloatNumber);
+    REQUIRE(mistakes.empty());
+}
+
+TEST_CASE("Identifies commas between selectors")
+{
+    // Given
+    const std::string code = "#ok,#cancel {";
+    MistakesContainer mistakes;
+
+    // When
+    EndToEndTokenizer t(code, mistakes);
+
+    // Then
+    REQUIRE(t.GetNextToken().GetTokenType() == TokenType::Identity);
+    REQUIRE(std::get<StringRef>(t.GetNextToken().GetValue()) == "ok");
+    REQUIRE(t.GetNextToken().GetTokenType() == TokenType::Comma);
+    REQUIRE(t.GetNextToken().GetTokenType() == TokenType::Identity);
+    REQUIRE(std::get<StringRef>(t.GetNextToken().GetValue()) == "cancel");
+    REQUIRE(mistakes.empty());
+}
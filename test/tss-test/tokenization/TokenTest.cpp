@@ -29,9 +29,9 @@ TEST_CASE("Token construction and getters work for all value types")
     REQUIRE(t3.GetTokenType() == TokenType::LiteralBool);
     REQUIRE(std::get<bool>(t3.GetValue()) == true);
     REQUIRE(t4.GetTokenType() == TokenType::LiteralString);
-    REQUIRE(std::get<std::string>(t4.GetValue()) == "hello");
+    REQUIRE(std::get<StringRef>(t4.GetValue()) == "hello");
     REQUIRE(t5.GetTokenType() == TokenType::Comment);
-    REQUIRE(std::get<std::string>(t5.GetValue()) == "comment");
+    REQUIRE(std::get<StringRef>(t5.GetValue()) == "comment");
     REQUIRE(t6.GetTokenType() == TokenType::EndOfCode);
     REQUIRE(std::holds_alternative<std::nullopt_t>(t6.GetValue()));
 }
@@ -48,7 +48,7 @@ TEST_CASE("Token move constructor and move assignment")
 
     // Then
     REQUIRE(t3.GetTokenType() == TokenType::Identifier);
-    REQUIRE(std::get<std::string>(t3.GetValue()) == "id");
+    REQUIRE(std::get<StringRef>(t3.GetValue()) == "id");
 }
 
 TEST_CASE("Token::ValueAsString returns correct string for all value types")
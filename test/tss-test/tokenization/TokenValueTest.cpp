@@ -0,0 +1,79 @@
+#include <catch2/catch_test_macros.hpp>
+#include <tss/tokenization/TokenValue.h>
+#include <type_traits>
+
+using namespace Trema::Style;
+
+TEST_CASE("Value is a compact trivially copyable type")
+{
+    // Then
+    REQUIRE(sizeof(Value) <= 16);
+    REQUIRE(std::is_trivially_copyable_v<Value>);
+    REQUIRE(sizeof(StringRef) == sizeof(void*));
+}
+
+TEST_CASE("StringRef interns equal strings into the same record")
+{
+    // Given
+    const std::string first = "interned-string";
+    const std::string second = "interned-" + std::string("string");
+
+    // When
+    const StringRef a(first);
+    const StringRef b(second);
+
+    // Then
+    REQUIRE(a.Data() == b.Data());
+    REQUIRE(a == b);
+    REQUIRE(a == "interned-string");
+    REQUIRE(a.Size() == first.size());
+    REQUIRE(a.CStr()[a.Size()] == '\0');
+}
+
+TEST_CASE("StringRef only grows the pool with strings it has never seen")
+{
+    // Given
+    const std::string text = "pool growth test, a string no other test interns";
+    (void) StringRef::Intern(text);
+    const auto before = StringRef::InternedBytes();
+
+    // When
+    (void) StringRef::Intern(text);
+    const auto again = StringRef::InternedBytes();
+    (void) StringRef::Intern(text + "!");
+
+    // Then
+    REQUIRE(again == before);
+    REQUIRE(StringRef::InternedBytes() > before);
+}
+
+TEST_CASE("StringRef default construction is the empty string")
+{
+    // Given
+    const StringRef empty;
+
+    // Then
+    REQUIRE(empty.Empty());
+    REQUIRE(empty == "");
+    REQUIRE(empty == StringRef(std::string_view()));
+}
+
+TEST_CASE("Value supports std::visit over string handles")
+{
+    // Given
+    const Value value = StringRef("visited");
+
+    // When
+    const auto size = std::visit([]<typename T0>(T0&& arg) -> std::size_t
+    {
+        using T = std::decay_t<T0>;
+        if constexpr (std::is_same_v<T, StringRef>)
+            return arg.Size();
+        else
+            return 0;
+    }, value);
+
+    // Then
+    REQUIRE(size == 7);
+    REQUIRE(GetIdentity(value) == "visited");
+}
@@ -0,0 +1,66 @@
+#include <catch2/catch_test_macros.hpp>
+#include <tss/utils/BloomFilter.h>
+#include <tss/utils/Hashing.h>
+#include <string>
+
+using namespace Trema::Utils;
+
+TEST_CASE("BloomFilter never misses an inserted hash")
+{
+    // Given
+    BloomFilter<> filter;
+
+    // When
+    for (int i = 0; i < 200; ++i)
+        filter.Insert(Hash("element-" + std::to_string(i)));
+
+    // Then
+    for (int i = 0; i < 200; ++i)
+        REQUIRE(filter.MayContain(Hash("element-" + std::to_string(i))));
+
+    int falsePositives = 0;
+    for (int i = 200; i < 1200; ++i)
+        falsePositives += filter.MayContain(Hash("element-" + std::to_string(i)));
+    REQUIRE(falsePositives < 50);
+}
+
+TEST_CASE("BloomFilter forgets erased hashes")
+{
+    // Given
+    BloomFilter<> filter;
+    const auto kept = Hash("kept");
+    const auto erased = Hash("erased");
+    filter.Insert(kept);
+    filter.Insert(erased);
+    filter.Insert(erased);
+
+    // When
+    filter.Erase(erased);
+    const bool afterOneErase = filter.MayContain(erased);
+    filter.Erase(erased);
+
+    // Then
+    REQUIRE(afterOneErase);
+    REQUIRE_FALSE(filter.MayContain(erased));
+    REQUIRE(filter.MayContain(kept));
+}
+
+TEST_CASE("BitBloomFilter is sized for the expected number of hashes")
+{
+    // Given
+    BitBloomFilter filter(1000);
+
+    // When
+    for (int i = 0; i < 1000; ++i)
+        filter.Insert(Hash("property-" + std::to_string(i)));
+
+    // Then
+    for (int i = 0; i < 1000; ++i)
+        REQUIRE(filter.MayContain(Hash("property-" + std::to_string(i))));
+
+    int falsePositives = 0;
+    for (int i = 1000; i < 11000; ++i)
+        falsePositives += filter.MayContain(Hash("property-" + std::to_string(i)));
+    REQUIRE(falsePositives < 200);
+    REQUIRE(filter.SizeInBytes() == 2048); // 16000 bits rounded up to a power of two
+}
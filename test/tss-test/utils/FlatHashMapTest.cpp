@@ -0,0 +1,103 @@
+#include <catch2/catch_test_macros.hpp>
+#include <tss/utils/FlatHashMap.h>
+#include <tss/utils/Hashing.h>
+#include <string>
+
+using namespace Trema::Utils;
+
+using StringMap = FlatHashMap<std::string, int, StringHash, std::equal_to<>>;
+
+TEST_CASE("FlatHashMap finds inserted keys across rehashes")
+{
+    // Given
+    StringMap map;
+
+    // When
+    for (int i = 0; i < 1000; ++i)
+        map.try_emplace("key" + std::to_string(i), i);
+
+    // Then
+    REQUIRE(map.size() == 1000);
+    for (int i = 0; i < 1000; ++i)
+    {
+        const auto it = map.find("key" + std::to_string(i));
+        REQUIRE(it != map.end());
+        REQUIRE(it->second == i);
+    }
+    REQUIRE_FALSE(map.contains("key1000"));
+}
+
+TEST_CASE("FlatHashMap lookups accept string views and do not insert")
+{
+    // Given
+    StringMap map;
+    map.try_emplace("width", 100);
+
+    // When
+    const std::string_view missing = "height";
+    const auto found = map.contains(std::string_view("width"));
+    const auto notFound = map.find(missing) == map.end();
+
+    // Then
+    REQUIRE(found);
+    REQUIRE(notFound);
+    REQUIRE(map.size() == 1);
+}
+
+TEST_CASE("FlatHashMap insert_or_assign overwrites existing values")
+{
+    // Given
+    StringMap map;
+    map.insert_or_assign("color", 1);
+
+    // When
+    const auto [it, inserted] = map.insert_or_assign("color", 2);
+
+    // Then
+    REQUIRE_FALSE(inserted);
+    REQUIRE(it->second == 2);
+    REQUIRE(map.size() == 1);
+}
+
+TEST_CASE("FlatHashMap erase leaves other keys reachable")
+{
+    // Given
+    StringMap map;
+    for (int i = 0; i < 100; ++i)
+        map.try_emplace(std::to_string(i), i);
+
+    // When
+    for (int i = 0; i < 100; i += 2)
+        REQUIRE(map.erase(std::to_string(i)) == 1);
+
+    // Then
+    REQUIRE(map.size() == 50);
+    for (int i = 1; i < 100; i += 2)
+        REQUIRE(map.contains(std::to_string(i)));
+    REQUIRE(map.erase(std::string("0")) == 0);
+
+    std::size_t count = 0;
+    for (const auto& [key, value] : map)
+    {
+        REQUIRE(value % 2 == 1);
+        ++count;
+    }
+    REQUIRE(count == 50);
+}
+
+TEST_CASE("FlatHashMap copies are independent")
+{
+    // Given
+    StringMap map;
+    map.try_emplace("a", 1);
+
+    // When
+    StringMap copy(map);
+    copy.insert_or_assign("a", 2);
+    copy.try_emplace("b", 3);
+
+    // Then
+    REQUIRE(map.find("a")->second == 1);
+    REQUIRE_FALSE(map.contains("b"));
+    REQUIRE(copy.size() == 2);
+}
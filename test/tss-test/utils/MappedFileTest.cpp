@@ -0,0 +1,23 @@
+#include <catch2/catch_test_macros.hpp>
+#include <tss/utils/MappedFile.h>
+#include <tss-test/TestHelpers.h>
+
+using namespace Trema::Style;
+using namespace Trema::Style::Testing;
+
+TEST_CASE("WriteFileAtomically leaves no temporary file behind when it can't replace the file", "[MappedFile]")
+{
+    // Given
+    const auto directory = MakeDirectory("tss-mapped-file-test");
+    const auto path = directory / "theme.bin";
+    std::filesystem::create_directories(path / "occupied");
+    const char data[] = "frozen";
+
+    // When
+    REQUIRE_THROWS(Trema::Utils::WriteFileAtomically(path, data, sizeof(data)));
+
+    // Then
+    REQUIRE(std::distance(std::filesystem::directory_iterator(directory), std::filesystem::directory_iterator()) == 1);
+
+    std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,119 @@
+#include <catch2/catch_test_macros.hpp>
+#include <tss/utils/ThreadPool.h>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <stdexcept>
+
+using namespace Trema::Utils;
+
+TEST_CASE("ThreadPool runs submitted tasks and returns their results")
+{
+    // Given
+    ThreadPool pool(4);
+    std::vector<std::future<int>> results;
+
+    // When
+    for (int i = 0; i < 100; ++i)
+        results.push_back(pool.Submit([i] { return i * i; }));
+
+    // Then
+    for (int i = 0; i < 100; ++i)
+        REQUIRE(results[i].get() == i * i);
+}
+
+TEST_CASE("ThreadPool hands exceptions to the future")
+{
+    // Given
+    ThreadPool pool(2);
+
+    // When
+    auto result = pool.Submit([]() -> int { throw std::runtime_error("failed"); });
+
+    // Then
+    REQUIRE_THROWS_AS(result.get(), std::runtime_error);
+}
+
+TEST_CASE("ThreadPool finishes queued tasks before it is destroyed")
+{
+    // Given
+    std::atomic<int> done { 0 };
+
+    // When
+    {
+        ThreadPool pool(1);
+        for (int i = 0; i < 50; ++i)
+            pool.Submit([&done] { ++done; });
+    }
+
+    // Then
+    REQUIRE(done == 50);
+}
+
+TEST_CASE("TaskGroup waits for nested tasks without blocking the workers")
+{
+    // Given
+    ThreadPool pool(2);
+    std::atomic<int> leaves { 0 };
+    std::function<void(int)> split = [&](const int depth)
+    {
+        if (depth == 0)
+        {
+            ++leaves;
+            return;
+        }
+
+        TaskGroup group(pool);
+        group.Run([&split, depth] { split(depth - 1); });
+        group.Run([&split, depth] { split(depth - 1); });
+        group.Wait();
+    };
+
+    // When
+    TaskGroup group(pool);
+    group.Run([&split] { split(10); });
+    group.Wait();
+
+    // Then
+    REQUIRE(leaves == 1024);
+}
+
+TEST_CASE("TaskGroup rethrows the exception of a task")
+{
+    // Given
+    ThreadPool pool(2);
+    TaskGroup group(pool);
+    std::atomic<int> done { 0 };
+
+    // When
+    group.Run([] { throw std::runtime_error("failed"); });
+    for (int i = 0; i < 10; ++i)
+        group.Run([&done] { ++done; });
+
+    // Then
+    REQUIRE_THROWS_AS(group.Wait(), std::runtime_error);
+    REQUIRE(done == 10);
+}
+
+TEST_CASE("TaskGroup waits for the tasks running on other threads")
+{
+    // Given
+    ThreadPool pool(1);
+    TaskGroup group(pool);
+    std::atomic<bool> started { false };
+    std::atomic<bool> finished { false };
+    group.Run([&]
+    {
+        started = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        finished = true;
+    });
+    while (!started)
+        std::this_thread::yield();
+
+    // When
+    group.Wait();
+
+    // Then
+    REQUIRE(finished);
+}
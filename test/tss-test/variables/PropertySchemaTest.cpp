@@ -0,0 +1,48 @@
+#include <catch2/catch_test_macros.hpp>
+#include <tss/variables/PropertySchema.h>
+#include <stdexcept>
+
+using namespace Trema::Style;
+
+TEST_CASE("PropertySchema gives each type its own slots", "[PropertySchema]")
+{
+    // Given
+    PropertySchema schema;
+
+    // When
+    const auto width = schema.Register<Integer>("width", 0);
+    const auto opacity = schema.Register<Float>("opacity", 1.0);
+    const auto height = schema.Register<Integer>("height", 0);
+    const auto visible = schema.Register<bool>("visible", true);
+    const auto label = schema.Register<std::string_view>("label", "");
+
+    // Then
+    REQUIRE(width.Slot == 0);
+    REQUIRE(height.Slot == 1);
+    REQUIRE(opacity.Slot == 0);
+    REQUIRE(visible.Slot == 0);
+    REQUIRE(label.Slot == 0);
+    REQUIRE(schema.SlotCount(PropertyType::Integer) == 2);
+    REQUIRE(schema.GetProperties().size() == 5);
+    REQUIRE(schema.Find("height")->Type == PropertyType::Integer);
+    REQUIRE(schema.Find("missing") == nullptr);
+    REQUIRE_THROWS_AS(schema.Register<Float>("width", 0.0), std::invalid_argument);
+}
+
+TEST_CASE("PropertySchema accepts integers for floats", "[PropertySchema]")
+{
+    // Given
+    const Value integer = Integer { 2 };
+    const Value text = StringRef("2");
+
+    // When
+    const auto asFloat = PropertySchema::Accepts(PropertyType::Float, integer);
+    const auto asInteger = PropertySchema::Accepts(PropertyType::Integer, Value { Float { 2.5 } });
+    const auto asBool = PropertySchema::Accepts(PropertyType::Bool, text);
+
+    // Then
+    REQUIRE(asFloat);
+    REQUIRE_FALSE(asInteger);
+    REQUIRE_FALSE(asBool);
+    REQUIRE(PropertySchema::Accepts(PropertyType::String, text));
+}
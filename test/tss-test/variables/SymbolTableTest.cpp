@@ -0,0 +1,82 @@
+#include <catch2/catch_test_macros.hpp>
+#include <tss/variables/SymbolTable.h>
+#include <map>
+#include <string>
+
+using namespace Trema::Style;
+
+TEST_CASE("SymbolTable lookups do not insert missing names")
+{
+    // Given
+    SymbolTable st;
+    st.SetVariable<Integer>("width", Integer { 100 });
+
+    // When
+    const auto missing = st.GetVariable("height");
+
+    // Then
+    REQUIRE(missing == nullptr);
+    REQUIRE(st.Size() == 1);
+    REQUIRE(std::get<Integer>(st.GetVariable("width")->GetValue()) == 100);
+}
+
+TEST_CASE("SymbolTable copies are isolated from later writes")
+{
+    // Given
+    SymbolTable original;
+    original.SetVariable<Integer>("width", Integer { 100 });
+
+    // When
+    SymbolTable copy(original);
+    copy.SetVariable<Integer>("width", Integer { 200 });
+    original.SetVariable<bool>("visible", true);
+
+    // Then
+    REQUIRE(std::get<Integer>(original.GetVariable("width")->GetValue()) == 100);
+    REQUIRE(std::get<Integer>(copy.GetVariable("width")->GetValue()) == 200);
+    REQUIRE_FALSE(copy.HasVariable("visible"));
+}
+
+TEST_CASE("SymbolTable Append overrides entries and iterates each name once")
+{
+    // Given
+    SymbolTable base;
+    base.SetVariable<Integer>("width", Integer { 1 });
+    base.SetVariable<Integer>("height", Integer { 2 });
+    SymbolTable overlay;
+    overlay.SetVariable<Integer>("width", Integer { 3 });
+
+    // When
+    base.Append(overlay);
+
+    // Then
+    std::map<std::string, Integer> entries;
+    for (const auto& [name, variable] : base)
+        REQUIRE(entries.emplace(name.Str(), std::get<Integer>(variable.GetValue())).second);
+
+    REQUIRE(entries == std::map<std::string, Integer> { { "width", 3 }, { "height", 2 } });
+    REQUIRE(base.Size() == 2);
+}
+
+TEST_CASE("SymbolTable keeps a logarithmic number of chunks over repeated appends")
+{
+    // Given
+    SymbolTable merged;
+
+    // When
+    for (int i = 0; i < 1000; ++i)
+    {
+        SymbolTable block;
+        block.SetVariable<Integer>("prop" + std::to_string(i % 100), Integer { i });
+        merged.Append(block);
+    }
+
+    // Then
+    REQUIRE(merged.Size() == 100);
+    REQUIRE(merged.ChunkCount() <= 12);
+    REQUIRE(std::get<Integer>(merged.GetVariable("prop99")->GetValue()) == 999);
+
+    merged.Compact();
+    REQUIRE(merged.ChunkCount() == 1);
+    REQUIRE(std::get<Integer>(merged.GetVariable("prop0")->GetValue()) == 900);
+}
@@ -0,0 +1,82 @@
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <string_view>
+#include <vector>
+#include <tss/parsing/HeaderGenerator.h>
+#include <tss/parsing/StackedStyleParser.h>
+#include <tss/tokenization/EndToEndTokenizer.h>
+#include <tss/utils/MappedFile.h>
+
+using namespace Trema::Style;
+
+namespace
+{
+    int Usage()
+    {
+        std::cerr << "Usage: tss-codegen [-n namespace] -o <header> <sheet.tss>...\n"
+                     "Parses the sheets in order and writes a header with one struct per selector.\n";
+        return 2;
+    }
+
+    bool HasContents(const std::filesystem::path& path, const std::string_view contents)
+    {
+        std::ifstream file(path, std::ios::in | std::ios::binary);
+        return file && std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()) == contents;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::string nameSpace = "Styles";
+    std::filesystem::path output;
+    std::vector<std::filesystem::path> sheets;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string_view argument = argv[i];
+        if (argument == "-n" && i + 1 < argc)
+            nameSpace = argv[++i];
+        else if (argument == "-o" && i + 1 < argc)
+            output = argv[++i];
+        else if (argument.starts_with("-"))
+            return Usage();
+        else
+            sheets.emplace_back(argument);
+    }
+
+    if (output.empty() || sheets.empty())
+        return Usage();
+
+    try
+    {
+        MistakesContainer mistakes;
+        StackedStyleParser parser(std::make_unique<EndToEndTokenizer>("", mistakes), mistakes);
+        parser.ParseFiles(sheets);
+        if (!mistakes.empty())
+        {
+            std::cerr << mistakes;
+            return 1;
+        }
+
+        std::string origin;
+        for (const auto& sheet : sheets)
+            origin += origin.empty() ? sheet.filename().string() : std::format(", {}", sheet.filename().string());
+
+        const auto header = HeaderGenerator(nameSpace).Generate(parser.GetVariables(), origin);
+
+        // Leave an unchanged header alone so that nothing including it gets rebuilt
+        if (!HasContents(output, header))
+        {
+            if (output.has_parent_path())
+                std::filesystem::create_directories(output.parent_path());
+            Trema::Utils::WriteFileAtomically(output, header.data(), header.size());
+        }
+        return 0;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << std::format("tss-codegen: {}\n", e.what());
+        return 1;
+    }
+}
@@ -0,0 +1,100 @@
+#include <charconv>
+#include <format>
+#include <iostream>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <tss/parsing/SheetCompiler.h>
+
+using namespace Trema::Style;
+
+namespace
+{
+    int Usage()
+    {
+        std::cerr << "Usage: tssc [-j threads] [-v] <source directory> <output directory>\n"
+                     "Compiles every .tss file of the source directory into a precompiled sheet (.tssc).\n"
+                     "Sheets whose sources and imports didn't change since the last run are skipped.\n";
+        return 2;
+    }
+
+    double Milliseconds(const std::chrono::nanoseconds duration)
+    {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::size_t threads = std::thread::hardware_concurrency();
+    bool verbose = false;
+    std::vector<std::string_view> paths;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string_view argument = argv[i];
+        if (argument == "-v")
+        {
+            verbose = true;
+        }
+        else if (argument == "-j" && i + 1 < argc)
+        {
+            const std::string_view count = argv[++i];
+            if (std::from_chars(count.data(), count.data() + count.size(), threads).ptr != count.data() + count.size() ||
+                threads == 0)
+                return Usage();
+        }
+        else if (argument.starts_with("-"))
+        {
+            return Usage();
+        }
+        else
+        {
+            paths.push_back(argument);
+        }
+    }
+
+    if (paths.size() != 2)
+        return Usage();
+
+    try
+    {
+        Trema::Utils::ThreadPool pool(threads);
+        SheetCompiler compiler(paths[0], paths[1]);
+        const auto report = compiler.Compile(pool);
+
+        for (const auto& sheet : report.Sheets)
+        {
+            if (sheet.Compiled && verbose)
+                std::cout << std::format("compiled {} -> {}\n", sheet.Source.string(), sheet.Output.string());
+
+            for (const auto& mistake : sheet.Mistakes)
+                std::cerr << mistake;
+
+            if (sheet.Error)
+            {
+                try
+                {
+                    std::rethrow_exception(sheet.Error);
+                }
+                catch (const std::exception& e)
+                {
+                    std::cerr << std::format("{}: error: {}\n", sheet.Source.string(), e.what());
+                }
+            }
+        }
+
+        const auto total = report.CheckTime + report.ParseTime + report.WriteTime;
+        std::cout << std::format("tssc: {} of {} sheets compiled, {} failed in {:.2f} ms "
+                                 "(check {:.2f} ms, parse {:.2f} ms, write {:.2f} ms)\n",
+                                 report.CompiledCount(), report.Sheets.size(), report.FailedCount(),
+                                 Milliseconds(total), Milliseconds(report.CheckTime),
+                                 Milliseconds(report.ParseTime), Milliseconds(report.WriteTime));
+
+        return report.FailedCount() == 0 ? 0 : 1;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << std::format("tssc: {}\n", e.what());
+        return 1;
+    }
+}
@@ -11,6 +11,9 @@ target("tss", function()
     add_files("src/**.cpp")
     add_headerfiles("src/(tss/**.h)", { prefixdir = "tss" })
     add_includedirs("src/", { public = true })
+    if is_plat("linux") then
+        add_syslinks("pthread", { public = true })
+    end
     set_targetdir("./build/$(plat)/$(arch)/$(mode)/tss")
 end)
 
@@ -18,7 +21,21 @@ target("tss-test", function()
     set_kind("binary")
     add_deps("tss")
     add_packages("catch2")
-    add_includedirs("src")
+    add_includedirs("src", "test")
     add_files("test/**.cpp")
     set_targetdir("./build/$(plat)/$(arch)/$(mode)/tss-test")
 end)
+
+target("tssc", function()
+    set_kind("binary")
+    add_deps("tss")
+    add_files("tools/tssc/*.cpp")
+    set_targetdir("./build/$(plat)/$(arch)/$(mode)/tssc")
+end)
+
+target("tss-codegen", function()
+    set_kind("binary")
+    add_deps("tss")
+    add_files("tools/tss-codegen/*.cpp")
+    set_targetdir("./build/$(plat)/$(arch)/$(mode)/tss-codegen")
+end)